@@ -0,0 +1,628 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Host benchmarks for the NDEF codec.
+// Reports throughput and heap allocations per operation, as a table or as JSON lines for regression comparison.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ndef.h"
+
+
+
+/* ==== Allocation counting ==== */
+
+// Heap calls made by the library; counted by wrapping the allocator at link time.
+typedef struct {
+    size_t malloc;
+    size_t realloc;
+    size_t free;
+} bench_allocs_t;
+
+static bench_allocs_t bench_allocs;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void  __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size) {
+    bench_allocs.malloc++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    bench_allocs.malloc++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    bench_allocs.realloc++;
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void* ptr) {
+    if (ptr) {
+        bench_allocs.free++;
+    }
+    __real_free(ptr);
+}
+
+
+
+/* ==== Corpora ==== */
+
+// URIs as typed into a tag writer.
+static const char* const bench_uris[] = {
+    "https://badge.team/",
+    "https://www.example.com/products/badge?utm_source=nfc&utm_medium=tag&id=4096",
+    "http://www.hackerhotel.nl/",
+    "tel:+31201234567",
+    "mailto:info@badge.team",
+    "https://github.com/badgeteam/esp32-component-ndef",
+    "geo:52.3676,4.9041",
+    "urn:nfc:sn:badge-0042",
+    "ftp://ftp.example.org/pub/firmware/badge-v2.bin",
+    "https://maps.example.com/?q=Amsterdam%20Centraal&zoom=17&layers=transit",
+    "sip:badge@voip.example.com",
+    "https://t.co/abc123",
+};
+#define BENCH_NUM_URIS (sizeof(bench_uris) / sizeof(*bench_uris))
+
+// Text records with their language codes.
+static const char* const bench_texts[][2] = {
+    {"en", "Hello, World!"},
+    {"nl", "Welkom op het evenement. Tik je badge om in te checken."},
+    {"de", "Willkommen"},
+    {"en-US", "Badge #0042 - Hacker Hotel 2025"},
+    {"fr", "Bienvenue au stand. Scannez pour plus d'informations sur le projet et les ateliers de ce week-end."},
+    {"en", ""},
+    {"ja", "\xe3\x81\x93\xe3\x82\x93\xe3\x81\xab\xe3\x81\xa1\xe3\x81\xaf"},
+    {"en", "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et "
+           "dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex "
+           "ea commodo consequat. Duis aute irure dolor in reprehenderit in voluptate velit esse cillum dolore eu."},
+};
+#define BENCH_NUM_TEXTS (sizeof(bench_texts) / sizeof(*bench_texts))
+
+// Smart posters; filled in by `bench_init`.
+#define BENCH_NUM_POSTERS 6
+static ndef_smartposter_t bench_posters[BENCH_NUM_POSTERS];
+
+// A realistic mixed message; filled in by `bench_init`.
+#define BENCH_NUM_MIXED 8
+static ndef_decd_record_t bench_mixed[BENCH_NUM_MIXED];
+
+// Personalised URI + text tags, as written in bulk by a tag-writing station; filled in by `bench_init`.
+#define BENCH_NUM_TAGS 256
+static char                 bench_tag_strs[BENCH_NUM_TAGS][2][48];
+static ndef_decd_record_t   bench_tag_records[BENCH_NUM_TAGS][2];
+static ndef_batch_message_t bench_tags[BENCH_NUM_TAGS];
+static ndef_batch_entry_t   bench_tag_entries[BENCH_NUM_TAGS];
+
+// Encoded messages for the readers.
+static ndef_ostream_t bench_uri_msg;
+static ndef_ostream_t bench_text_msg;
+static ndef_ostream_t bench_text16_msg;
+static ndef_ostream_t bench_poster_msg;
+static ndef_ostream_t bench_mixed_msg;
+
+// Scratch memory for the writers.
+static uint8_t bench_buf[16384];
+
+// Keeps results alive so the compiler cannot drop the work.
+static volatile size_t bench_sink;
+
+// Prepare the corpora.
+static bool bench_init(void) {
+    for (size_t i = 0; i < BENCH_NUM_POSTERS; i++) {
+        ndef_uri_t uri   = ndef_uri_format_cstr(bench_uris[i]);
+        bench_posters[i] = (ndef_smartposter_t){
+            .prefix         = uri.prefix,
+            .uri            = uri.uri,
+            .uri_len        = uri.uri_len,
+            .title          = bench_texts[i][1],
+            .title_len      = strlen(bench_texts[i][1]),
+            .title_lang     = bench_texts[i][0],
+            .title_lang_len = strlen(bench_texts[i][0]),
+            .has_action     = i % 2,
+            .action         = NDEF_SMARTPOSTER_ACTION_DO,
+        };
+    }
+
+    size_t mixed = 0;
+    for (size_t i = 0; i < 3; i++) {
+        bench_mixed[mixed++] = (ndef_decd_record_t){
+            .type     = NDEF_DECD_TYPE_URI,
+            .data.uri = ndef_uri_format_cstr(bench_uris[i]),
+        };
+        bench_mixed[mixed++] = (ndef_decd_record_t){
+            .type      = NDEF_DECD_TYPE_TEXT,
+            .data.text = {
+                .lang     = bench_texts[i][0],
+                .lang_len = strlen(bench_texts[i][0]),
+                .text     = bench_texts[i][1],
+                .text_len = strlen(bench_texts[i][1]),
+            },
+        };
+    }
+    bench_mixed[mixed++] = (ndef_decd_record_t){
+        .type             = NDEF_DECD_TYPE_SMART_POSTER,
+        .data.smartposter = bench_posters[0],
+    };
+    bench_mixed[mixed++] = (ndef_decd_record_t){
+        .type      = NDEF_DECD_TYPE_WIFI,
+        .data.wifi = {
+            .ssid     = "badge.team",
+            .ssid_len = 10,
+            .auth     = NDEF_WIFI_AUTH_WPA2_PERSONAL,
+            .encr     = NDEF_WIFI_ENCR_AES,
+            .key      = "correct horse battery staple",
+            .key_len  = 28,
+        },
+    };
+
+    for (size_t i = 0; i < BENCH_NUM_TAGS; i++) {
+        char* uri  = bench_tag_strs[i][0];
+        char* text = bench_tag_strs[i][1];
+        snprintf(uri, sizeof(bench_tag_strs[i][0]), "https://tags.example.com/t/%05zu?k=%08zx", i, i * 2654435761u);
+        snprintf(text, sizeof(bench_tag_strs[i][1]), "Attendee %05zu", i);
+        bench_tag_records[i][0] = (ndef_decd_record_t){
+            .type     = NDEF_DECD_TYPE_URI,
+            .data.uri = ndef_uri_format_cstr(uri),
+        };
+        bench_tag_records[i][1] = (ndef_decd_record_t){
+            .type      = NDEF_DECD_TYPE_TEXT,
+            .data.text = {.lang = "en", .lang_len = 2, .text = text, .text_len = strlen(text)},
+        };
+        bench_tags[i] = (ndef_batch_message_t){bench_tag_records[i], 2};
+    }
+
+    bench_uri_msg    = NDEF_OSTREAM_NEW();
+    bench_text_msg   = NDEF_OSTREAM_NEW();
+    bench_text16_msg = NDEF_OSTREAM_NEW();
+    bench_poster_msg = NDEF_OSTREAM_NEW();
+    bench_mixed_msg  = NDEF_OSTREAM_NEW();
+    for (size_t i = 0; i < BENCH_NUM_URIS; i++) {
+        NDEF_RETURN_ON_FALSE(ndef_uri_write_cstr(&bench_uri_msg, bench_uris[i], ndef_pos_at(i, BENCH_NUM_URIS)));
+    }
+    for (size_t i = 0; i < BENCH_NUM_TEXTS; i++) {
+        NDEF_RETURN_ON_FALSE(ndef_text_write_cstr(&bench_text_msg, bench_texts[i][0], bench_texts[i][1],
+                                                  ndef_pos_at(i, BENCH_NUM_TEXTS)));
+        NDEF_RETURN_ON_FALSE(ndef_text_write_utf16(&bench_text16_msg, bench_texts[i][0], strlen(bench_texts[i][0]),
+                                                   bench_texts[i][1], strlen(bench_texts[i][1]),
+                                                   ndef_pos_at(i, BENCH_NUM_TEXTS)));
+    }
+    for (size_t i = 0; i < BENCH_NUM_POSTERS; i++) {
+        NDEF_RETURN_ON_FALSE(
+            ndef_smartposter_write(&bench_poster_msg, bench_posters[i], ndef_pos_at(i, BENCH_NUM_POSTERS)));
+    }
+    NDEF_RETURN_ON_FALSE(ndef_message_write(&bench_mixed_msg, bench_mixed, BENCH_NUM_MIXED));
+    return true;
+}
+
+
+
+/* ==== Benchmark cases ==== */
+
+// Write every text record into a new heap stream.
+static size_t bench_text_write_heap(void) {
+    for (size_t i = 0; i < BENCH_NUM_TEXTS; i++) {
+        ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+        NDEF_RETURN_ON_FALSE(
+            ndef_text_write_cstr(&ostream, bench_texts[i][0], bench_texts[i][1], NDEF_POS_START_END));
+        bench_sink += ostream.len;
+        ndef_ostream_free(&ostream);
+    }
+    return BENCH_NUM_TEXTS;
+}
+
+// Write every text record into a fixed buffer.
+static size_t bench_text_write_fixed(void) {
+    for (size_t i = 0; i < BENCH_NUM_TEXTS; i++) {
+        ndef_ostream_t ostream = NDEF_OSTREAM_NEW_FIXED(bench_buf, sizeof(bench_buf));
+        NDEF_RETURN_ON_FALSE(
+            ndef_text_write_cstr(&ostream, bench_texts[i][0], bench_texts[i][1], NDEF_POS_START_END));
+        bench_sink += ostream.len;
+    }
+    return BENCH_NUM_TEXTS;
+}
+
+// Pick the prefix of every URI.
+static size_t bench_uri_format(void) {
+    for (size_t i = 0; i < BENCH_NUM_URIS; i++) {
+        bench_sink += ndef_uri_format_cstr(bench_uris[i]).prefix;
+    }
+    return BENCH_NUM_URIS;
+}
+
+// Write every URI record into a new heap stream.
+static size_t bench_uri_write_heap(void) {
+    for (size_t i = 0; i < BENCH_NUM_URIS; i++) {
+        ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+        NDEF_RETURN_ON_FALSE(ndef_uri_write_cstr(&ostream, bench_uris[i], NDEF_POS_START_END));
+        bench_sink += ostream.len;
+        ndef_ostream_free(&ostream);
+    }
+    return BENCH_NUM_URIS;
+}
+
+// Write every URI record into a fixed buffer.
+static size_t bench_uri_write_fixed(void) {
+    for (size_t i = 0; i < BENCH_NUM_URIS; i++) {
+        ndef_ostream_t ostream = NDEF_OSTREAM_NEW_FIXED(bench_buf, sizeof(bench_buf));
+        NDEF_RETURN_ON_FALSE(ndef_uri_write_cstr(&ostream, bench_uris[i], NDEF_POS_START_END));
+        bench_sink += ostream.len;
+    }
+    return BENCH_NUM_URIS;
+}
+
+// Write every Smart Poster into a new heap stream.
+static size_t bench_smartposter_write_heap(void) {
+    for (size_t i = 0; i < BENCH_NUM_POSTERS; i++) {
+        ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+        NDEF_RETURN_ON_FALSE(ndef_smartposter_write(&ostream, bench_posters[i], NDEF_POS_START_END));
+        bench_sink += ostream.len;
+        ndef_ostream_free(&ostream);
+    }
+    return BENCH_NUM_POSTERS;
+}
+
+// Write every Smart Poster into a fixed buffer.
+static size_t bench_smartposter_write_fixed(void) {
+    for (size_t i = 0; i < BENCH_NUM_POSTERS; i++) {
+        ndef_ostream_t ostream = NDEF_OSTREAM_NEW_FIXED(bench_buf, sizeof(bench_buf));
+        NDEF_RETURN_ON_FALSE(ndef_smartposter_write(&ostream, bench_posters[i], NDEF_POS_START_END));
+        bench_sink += ostream.len;
+    }
+    return BENCH_NUM_POSTERS;
+}
+
+// Write the mixed message into an arena.
+static size_t bench_message_write_arena(void) {
+    ndef_arena_t   arena   = NDEF_ARENA_NEW(bench_buf, sizeof(bench_buf));
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW_ARENA(&arena);
+    NDEF_RETURN_ON_FALSE(ndef_message_write(&ostream, bench_mixed, BENCH_NUM_MIXED));
+    bench_sink += ostream.len;
+    return BENCH_NUM_MIXED;
+}
+
+// Write every tag message into its own heap stream.
+static size_t bench_tags_write_heap(void) {
+    for (size_t i = 0; i < BENCH_NUM_TAGS; i++) {
+        ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+        NDEF_RETURN_ON_FALSE(ndef_message_write(&ostream, bench_tags[i].records, bench_tags[i].records_len));
+        bench_sink += ostream.len;
+        ndef_ostream_free(&ostream);
+    }
+    return 2 * BENCH_NUM_TAGS;
+}
+
+// Write all tag messages into one fixed buffer with the batch encoder.
+static size_t bench_batch_write_fixed(void) {
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW_FIXED(bench_buf, sizeof(bench_buf));
+    NDEF_RETURN_ON_FALSE(ndef_batch_write(&ostream, bench_tags, BENCH_NUM_TAGS, bench_tag_entries));
+    bench_sink += ostream.len;
+    return 2 * BENCH_NUM_TAGS;
+}
+
+// Offset of the data area of a Type 2 tag, after the UID, lock bytes and capability container in pages 0 to 3.
+#define BENCH_T2T_DATA_OFFSET 16
+
+// Re-encode every tag with an updated text record and find the Type 2 pages that changed.
+static size_t bench_message_rewrite(void) {
+    static uint8_t old_buf[128];
+    for (size_t i = 0; i < BENCH_NUM_TAGS; i++) {
+        ndef_ostream_t old_msg = NDEF_OSTREAM_NEW_FIXED(old_buf, sizeof(old_buf));
+        NDEF_RETURN_ON_FALSE(ndef_message_write(&old_msg, bench_tags[i].records, bench_tags[i].records_len));
+
+        ndef_decd_record_t records[2] = {bench_tags[i].records[0], bench_tags[i].records[1]};
+        records[1].data.text.text     = bench_tag_strs[(i + 1) % BENCH_NUM_TAGS][1];
+        ndef_ostream_t    ostream     = NDEF_OSTREAM_NEW_FIXED(bench_buf, sizeof(bench_buf));
+        ndef_diff_range_t ranges[8];
+        size_t            ranges_len;
+        // The message follows its TLV header in the data area.
+        size_t            base = BENCH_T2T_DATA_OFFSET + ndef_tlv_header_size(ndef_message_encoded_size(records, 2));
+        NDEF_RETURN_ON_FALSE(
+            ndef_message_rewrite(&ostream, old_msg.data, old_msg.len, records, 2, base, 4, ranges, 8, &ranges_len));
+        bench_sink += ndef_diff_len(ranges, ranges_len);
+    }
+    return 2 * BENCH_NUM_TAGS;
+}
+
+// Read the headers of every record of the mixed message.
+static size_t bench_read_record(void) {
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(bench_mixed_msg.data, bench_mixed_msg.len);
+    size_t         count   = 0;
+    while (ndef_istream_available(&istream)) {
+        ndef_record_t record;
+        NDEF_RETURN_ON_FALSE(ndef_read_record(&istream, &record));
+        bench_sink += record.payload_len;
+        count++;
+    }
+    return count;
+}
+
+// Read every record of the URI message.
+static size_t bench_uri_read(void) {
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(bench_uri_msg.data, bench_uri_msg.len);
+    for (size_t i = 0; i < BENCH_NUM_URIS; i++) {
+        ndef_uri_t uri;
+        NDEF_RETURN_ON_FALSE(ndef_uri_read(&istream, &uri));
+        bench_sink += uri.uri_len;
+    }
+    return BENCH_NUM_URIS;
+}
+
+// Read every record of the text message.
+static size_t bench_text_read(void) {
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(bench_text_msg.data, bench_text_msg.len);
+    for (size_t i = 0; i < BENCH_NUM_TEXTS; i++) {
+        ndef_text_t text;
+        NDEF_RETURN_ON_FALSE(ndef_text_read(&istream, &text));
+        bench_sink += text.text_len;
+    }
+    return BENCH_NUM_TEXTS;
+}
+
+// Read every record of a text message and get its text as UTF-8.
+static size_t bench_text_utf8(const ndef_ostream_t* msg) {
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(msg->data, msg->len);
+    for (size_t i = 0; i < BENCH_NUM_TEXTS; i++) {
+        ndef_text_t text;
+        const char* utf8;
+        size_t      utf8_len;
+        NDEF_RETURN_ON_FALSE(ndef_text_read(&istream, &text));
+        NDEF_RETURN_ON_FALSE(ndef_text_get_utf8(&text, (char*)bench_buf, sizeof(bench_buf), &utf8, &utf8_len));
+        bench_sink += utf8_len;
+    }
+    return BENCH_NUM_TEXTS;
+}
+
+// Get the text of UTF-8 text records, which only validates it.
+static size_t bench_text_utf8_from_utf8(void) {
+    return bench_text_utf8(&bench_text_msg);
+}
+
+// Get the text of UTF-16 text records, which transcodes it.
+static size_t bench_text_utf8_from_utf16(void) {
+    return bench_text_utf8(&bench_text16_msg);
+}
+
+// Read every record of the Smart Poster message.
+static size_t bench_smartposter_read(void) {
+    static const char* const langs[] = {"nl", "en"};
+    ndef_istream_t           istream = NDEF_ISTREAM_NEW(bench_poster_msg.data, bench_poster_msg.len);
+    for (size_t i = 0; i < BENCH_NUM_POSTERS; i++) {
+        ndef_smartposter_t poster;
+        NDEF_RETURN_ON_FALSE(ndef_smartposter_read_lang(&istream, &poster, langs, 2));
+        bench_sink += poster.title_len;
+    }
+    return BENCH_NUM_POSTERS;
+}
+
+// Iterate over the mixed message and decode every record.
+static size_t bench_decd_read(void) {
+    ndef_istream_t      istream = NDEF_ISTREAM_NEW(bench_mixed_msg.data, bench_mixed_msg.len);
+    ndef_message_iter_t iter    = NDEF_MESSAGE_ITER_NEW(&istream);
+    while (!ndef_message_done(&iter)) {
+        ndef_record_t      record;
+        ndef_decd_record_t decd;
+        NDEF_RETURN_ON_FALSE(ndef_message_next(&iter, &record));
+        NDEF_RETURN_ON_FALSE(ndef_decd_decode(&record, &decd));
+        bench_sink += decd.type;
+    }
+    return iter.count;
+}
+
+// Count the records reported by the parser.
+static bool bench_parser_record(void* cookie, const ndef_record_t* record) {
+    (void)record;
+    (*(size_t*)cookie)++;
+    return true;
+}
+
+// Feed the mixed message to the incremental parser in 16-byte Type 2 pages.
+static size_t bench_parser_feed(void) {
+    size_t        count = 0;
+    ndef_parser_t parser;
+    ndef_parser_init(&parser, NDEF_OSTREAM_NEW_FIXED(bench_buf, sizeof(bench_buf)), sizeof(bench_buf), NULL,
+                     bench_parser_record, &count);
+    for (size_t i = 0; i < bench_mixed_msg.len; i += 16) {
+        size_t len = bench_mixed_msg.len - i < 16 ? bench_mixed_msg.len - i : 16;
+        NDEF_RETURN_ON_FALSE(ndef_parser_feed(&parser, bench_mixed_msg.data + i, len));
+    }
+    NDEF_RETURN_ON_FALSE(ndef_parser_done(&parser));
+    return count;
+}
+
+// A benchmark case.
+typedef struct {
+    // Name of the benchmark.
+    const char* name;
+    // Run one operation; returns the number of records processed, or 0 on error.
+    size_t (*run)(void);
+    // Whether the case writes into caller-owned memory only; the run fails if it touches the heap.
+    bool no_alloc;
+} bench_case_t;
+
+static const bench_case_t bench_cases[] = {
+    {"text_write/heap", bench_text_write_heap, false},
+    {"text_write/fixed", bench_text_write_fixed, true},
+    {"uri_format", bench_uri_format, false},
+    {"uri_write/heap", bench_uri_write_heap, false},
+    {"uri_write/fixed", bench_uri_write_fixed, true},
+    {"smartposter_write/heap", bench_smartposter_write_heap, false},
+    {"smartposter_write/fixed", bench_smartposter_write_fixed, true},
+    {"message_write/arena", bench_message_write_arena, true},
+    {"tags_write/heap", bench_tags_write_heap, false},
+    {"batch_write/fixed", bench_batch_write_fixed, true},
+    {"message_rewrite/4", bench_message_rewrite, true},
+    {"read_record", bench_read_record, false},
+    {"uri_read", bench_uri_read, false},
+    {"text_read", bench_text_read, false},
+    {"text_utf8/utf8", bench_text_utf8_from_utf8, false},
+    {"text_utf8/utf16", bench_text_utf8_from_utf16, false},
+    {"smartposter_read", bench_smartposter_read, false},
+    {"decd_read", bench_decd_read, false},
+    {"parser_feed/16", bench_parser_feed, false},
+};
+#define BENCH_NUM_CASES (sizeof(bench_cases) / sizeof(*bench_cases))
+
+
+
+/* ==== Runner ==== */
+
+// Results of a benchmark case.
+typedef struct {
+    size_t ops;
+    size_t records;
+    double ns;
+    double mallocs_per_op;
+    double reallocs_per_op;
+    double frees_per_op;
+} bench_result_t;
+
+// Get a monotonic time in nanoseconds.
+static double bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Clock hook for the library statistics, in nanoseconds.
+static uint64_t bench_stats_clock(void) {
+    return bench_now_ns();
+}
+
+// Print the library statistics gathered during the run.
+static void bench_print_stats(void) {
+    if (!NDEF_STATS) {
+        printf("\nLibrary statistics are disabled; configure with -DNDEF_STATS=ON.\n");
+        return;
+    }
+    ndef_stats_t stats;
+    ndef_stats_snapshot(&stats);
+    printf("\n%-28s %14s %12s\n", "function", "calls", "ns/call");
+    for (size_t i = 0; i < NDEF_STATS_FN_COUNT; i++) {
+        if (stats.calls[i]) {
+            printf("%-28s %14zu %12.1f\n", ndef_stats_fn_name(i), stats.calls[i],
+                   (double)stats.time[i] / stats.calls[i]);
+        }
+    }
+    printf("\nbytes encoded %zu, bytes decoded %zu, reallocs %zu, peak capacity %zu\n", stats.bytes_encoded,
+           stats.bytes_decoded, stats.reallocs, stats.peak_capacity);
+    for (size_t i = 0; i < NDEF_STATS_FAIL_COUNT; i++) {
+        printf("failures: %-19s %zu\n", ndef_stats_fail_name(i), stats.failures[i]);
+    }
+}
+
+// Run a case for at least `min_ns`, doubling the number of operations until it does.
+static bool bench_run(const bench_case_t* bench, double min_ns, bench_result_t* result_out) {
+    size_t ops = 1;
+    while (true) {
+        bench_allocs_t before  = bench_allocs;
+        size_t         records = 0;
+        double         start   = bench_now_ns();
+        for (size_t i = 0; i < ops; i++) {
+            size_t count = bench->run();
+            NDEF_RETURN_ON_FALSE(count);
+            records += count;
+        }
+        double elapsed = bench_now_ns() - start;
+        if (elapsed >= min_ns || ops >= (SIZE_MAX >> 1)) {
+            *result_out = (bench_result_t){
+                .ops             = ops,
+                .records         = records,
+                .ns              = elapsed,
+                .mallocs_per_op  = (double)(bench_allocs.malloc - before.malloc) / ops,
+                .reallocs_per_op = (double)(bench_allocs.realloc - before.realloc) / ops,
+                .frees_per_op    = (double)(bench_allocs.free - before.free) / ops,
+            };
+            return true;
+        }
+        ops *= 2;
+    }
+}
+
+static void bench_usage(const char* argv0) {
+    fprintf(stderr, "Usage: %s [--json] [--filter SUBSTRING] [--min-time MS] [--stats]\n", argv0);
+}
+
+int main(int argc, char** argv) {
+    bool        json        = false;
+    const char* filter      = NULL;
+    double      min_time_ms = 200;
+    bool        stats       = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--json")) {
+            json = true;
+        } else if (!strcmp(argv[i], "--stats")) {
+            stats = true;
+        } else if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) {
+            min_time_ms = atof(argv[++i]);
+        } else {
+            bench_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!bench_init()) {
+        fprintf(stderr, "Failed to prepare the corpora\n");
+        return 1;
+    }
+
+    if (stats) {
+        // Time the library's own functions as well; this slows the benchmarks down.
+        ndef_stats_reset();
+        ndef_stats_set_clock(bench_stats_clock);
+    }
+    if (!json) {
+        printf("Record codec: %s\n\n", NDEF_HEADER_ONLY ? "header-only" : "compiled once");
+        printf("%-28s %12s %12s %14s %8s %8s %8s\n", "benchmark", "ops", "ns/record", "records/s", "malloc", "realloc",
+               "free");
+    }
+    int status = 0;
+    for (size_t i = 0; i < BENCH_NUM_CASES; i++) {
+        const bench_case_t* bench = &bench_cases[i];
+        if (filter && !strstr(bench->name, filter)) {
+            continue;
+        }
+        bench_result_t result;
+        if (!bench_run(bench, min_time_ms * 1e6, &result)) {
+            fprintf(stderr, "%s: failed\n", bench->name);
+            status = 1;
+            continue;
+        }
+        if (bench->no_alloc && (result.mallocs_per_op || result.reallocs_per_op || result.frees_per_op)) {
+            fprintf(stderr, "%s: used the heap\n", bench->name);
+            status = 1;
+        }
+        double ns_per_record   = result.ns / result.records;
+        double records_per_sec = result.records / (result.ns / 1e9);
+        if (json) {
+            printf("{\"name\":\"%s\",\"ops\":%zu,\"records\":%zu,\"ns_per_record\":%.3f,\"records_per_sec\":%.1f,"
+                   "\"mallocs_per_op\":%.3f,\"reallocs_per_op\":%.3f,\"frees_per_op\":%.3f,\"header_only\":%s}\n",
+                   bench->name, result.ops, result.records, ns_per_record, records_per_sec, result.mallocs_per_op,
+                   result.reallocs_per_op, result.frees_per_op, NDEF_HEADER_ONLY ? "true" : "false");
+        } else {
+            printf("%-28s %12zu %12.1f %14.0f %8.2f %8.2f %8.2f\n", bench->name, result.ops, ns_per_record,
+                   records_per_sec, result.mallocs_per_op, result.reallocs_per_op, result.frees_per_op);
+        }
+    }
+
+    if (stats && !json) {
+        bench_print_stats();
+    }
+
+    ndef_ostream_free(&bench_uri_msg);
+    ndef_ostream_free(&bench_text_msg);
+    ndef_ostream_free(&bench_text16_msg);
+    ndef_ostream_free(&bench_poster_msg);
+    ndef_ostream_free(&bench_mixed_msg);
+    return status;
+}
@@ -0,0 +1,246 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Standalone driver for the fuzz targets, for compilers without libFuzzer.
+// Replays a corpus, optionally mutates it at random for a number of iterations and reports executions per second,
+// so that checks added to the readers can be shown not to slow them down.
+// Like libFuzzer, every input is copied into a buffer of its exact size so that the sanitizers catch overreads, and an
+// input that crashes the target is saved to `crash-input` in the working directory.
+
+#include <dirent.h>
+#include <sanitizer/common_interface_defs.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "fuzz.h"
+
+// Largest input the driver creates by mutation.
+#define DRIVER_MAX_LEN 4096
+
+
+
+/* ==== Corpus ==== */
+
+// An input loaded from the corpus.
+typedef struct {
+    uint8_t* data;
+    size_t   len;
+} driver_input_t;
+
+static driver_input_t* driver_inputs;
+static size_t          driver_inputs_len;
+static size_t          driver_inputs_cap;
+
+// Load a file into the corpus.
+static bool driver_load_file(const char* path) {
+    FILE* fd = fopen(path, "rb");
+    if (!fd) {
+        perror(path);
+        return false;
+    }
+    uint8_t* data = malloc(DRIVER_MAX_LEN);
+    size_t   len  = data ? fread(data, 1, DRIVER_MAX_LEN, fd) : 0;
+    fclose(fd);
+    if (!data) {
+        return false;
+    }
+    if (driver_inputs_len == driver_inputs_cap) {
+        size_t          cap    = driver_inputs_cap ? driver_inputs_cap * 2 : 64;
+        driver_input_t* inputs = realloc(driver_inputs, cap * sizeof(driver_input_t));
+        if (!inputs) {
+            free(data);
+            return false;
+        }
+        driver_inputs     = inputs;
+        driver_inputs_cap = cap;
+    }
+    driver_inputs[driver_inputs_len++] = (driver_input_t){data, len};
+    return true;
+}
+
+// Load a file, or every file in a directory, into the corpus.
+static bool driver_load(const char* path) {
+    struct stat st;
+    if (stat(path, &st)) {
+        perror(path);
+        return false;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        return driver_load_file(path);
+    }
+    DIR* dir = opendir(path);
+    if (!dir) {
+        perror(path);
+        return false;
+    }
+    bool           ok = true;
+    struct dirent* ent;
+    while (ok && (ent = readdir(dir))) {
+        if (ent->d_name[0] == '.') {
+            continue;
+        }
+        char child[4096];
+        snprintf(child, sizeof(child), "%s/%s", path, ent->d_name);
+        ok = driver_load_file(child);
+    }
+    closedir(dir);
+    return ok;
+}
+
+
+
+/* ==== Running ==== */
+
+// State of the xorshift generator used for mutations.
+static uint64_t driver_rng = 0x9e3779b97f4a7c15;
+
+// Get a pseudo-random number below `bound`, which must not be 0.
+static size_t driver_rand(size_t bound) {
+    driver_rng ^= driver_rng << 13;
+    driver_rng ^= driver_rng >> 7;
+    driver_rng ^= driver_rng << 17;
+    return driver_rng % bound;
+}
+
+// The input the target is running on.
+static driver_input_t driver_current;
+
+// Save the current input after the target crashed on it.
+static void driver_save_crash(void) {
+    FILE* fd = fopen("crash-input", "wb");
+    if (fd) {
+        fwrite(driver_current.data, 1, driver_current.len, fd);
+        fclose(fd);
+        fprintf(stderr, "saved %zu byte input to crash-input\n", driver_current.len);
+    }
+}
+
+// Save the current input when a check fails.
+static void driver_on_abort(int signum) {
+    driver_save_crash();
+    signal(signum, SIG_DFL);
+    raise(signum);
+}
+
+// Run the target on a copy of `data` of exactly `len` bytes.
+static void driver_exec(const uint8_t* data, size_t len) {
+    uint8_t* copy = malloc(len ? len : 1);
+    if (len) {
+        memcpy(copy, data, len);
+    }
+    driver_current = (driver_input_t){copy, len};
+    LLVMFuzzerTestOneInput(copy, len);
+    free(copy);
+}
+
+// Mutate `data` in place, the way a tag may be corrupted or crafted: flipped bits, changed lengths and cut-off data.
+// Returns the new length.
+static size_t driver_mutate(uint8_t* data, size_t len) {
+    size_t count = 1 + driver_rand(4);
+    for (size_t i = 0; i < count; i++) {
+        switch (driver_rand(5)) {
+            case 0:
+                if (len) {
+                    data[driver_rand(len)] ^= 1 << driver_rand(8);
+                }
+                break;
+            case 1:
+                if (len) {
+                    // Interesting byte values for flags and lengths.
+                    static const uint8_t values[] = {0x00, 0x01, 0x3f, 0x40, 0x7f, 0x80, 0xfe, 0xff};
+                    data[driver_rand(len)]        = values[driver_rand(sizeof(values))];
+                }
+                break;
+            case 2:
+                if (len) {
+                    len = driver_rand(len);
+                }
+                break;
+            case 3:
+                if (len < DRIVER_MAX_LEN) {
+                    size_t at = driver_rand(len + 1);
+                    memmove(data + at + 1, data + at, len - at);
+                    data[at] = driver_rand(256);
+                    len++;
+                }
+                break;
+            default:
+                if (len) {
+                    size_t at = driver_rand(len);
+                    memmove(data + at, data + at + 1, len - at - 1);
+                    len--;
+                }
+                break;
+        }
+    }
+    return len;
+}
+
+// Get the current time in seconds.
+static double driver_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void driver_usage(const char* argv0) {
+    fprintf(stderr, "Usage: %s [--runs N] [--mutations N] [--seed N] FILE|DIR...\n", argv0);
+}
+
+int main(int argc, char** argv) {
+    size_t runs      = 1;
+    size_t mutations = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--runs") && i + 1 < argc) {
+            runs = strtoull(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--mutations") && i + 1 < argc) {
+            mutations = strtoull(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            driver_rng = strtoull(argv[++i], NULL, 0) | 1;
+        } else if (argv[i][0] == '-') {
+            driver_usage(argv[0]);
+            return 1;
+        } else if (!driver_load(argv[i])) {
+            return 1;
+        }
+    }
+    if (!driver_inputs_len) {
+        driver_usage(argv[0]);
+        return 1;
+    }
+    signal(SIGABRT, driver_on_abort);
+    __sanitizer_set_death_callback(driver_save_crash);
+
+    // Replay the corpus as is.
+    double start = driver_now();
+    for (size_t run = 0; run < runs; run++) {
+        for (size_t i = 0; i < driver_inputs_len; i++) {
+            driver_exec(driver_inputs[i].data, driver_inputs[i].len);
+        }
+    }
+    double replay = driver_now() - start;
+    size_t execs  = runs * driver_inputs_len;
+    printf("replayed %zu inputs %zu times: %.0f execs/s\n", driver_inputs_len, runs, execs / replay);
+
+    // Then mutate it.
+    if (mutations) {
+        uint8_t buf[DRIVER_MAX_LEN];
+        start = driver_now();
+        for (size_t i = 0; i < mutations; i++) {
+            const driver_input_t* input = &driver_inputs[driver_rand(driver_inputs_len)];
+            memcpy(buf, input->data, input->len);
+            driver_exec(buf, driver_mutate(buf, input->len));
+        }
+        printf("ran %zu mutations: %.0f execs/s\n", mutations, mutations / (driver_now() - start));
+    }
+
+    for (size_t i = 0; i < driver_inputs_len; i++) {
+        free(driver_inputs[i].data);
+    }
+    free(driver_inputs);
+    return 0;
+}
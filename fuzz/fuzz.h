@@ -0,0 +1,59 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Shared checks for the fuzz targets.
+// Each target feeds its input to one reader, checks the invariants that hold for every input and round-trips whatever
+// was decoded through the matching writer.
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ndef.h"
+
+// Entry point of a fuzz target, called by libFuzzer or by the standalone driver for every input.
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t len);
+
+// Abort if a check fails, so that the fuzzer keeps the input as a crash.
+#define FUZZ_CHECK(cond_)                                                                                              \
+    do {                                                                                                               \
+        if (!(cond_)) {                                                                                                \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond_);                                  \
+            abort();                                                                                                   \
+        }                                                                                                              \
+    } while (0)
+
+// Whether two byte strings are equal.
+static inline bool fuzz_equal(const void* a, size_t a_len, const void* b, size_t b_len) {
+    return a_len == b_len && (a_len == 0 || memcmp(a, b, a_len) == 0);
+}
+
+// Clear the result of `istream` before a read, so that the check after it sees what that read recorded.
+// Returns the index the read starts at.
+static inline size_t fuzz_begin_read(ndef_istream_t* istream) {
+    istream->result = (ndef_result_t){NDEF_OK, 0};
+    return istream->index;
+}
+
+// Check that a failed read left `istream` at `index` and recorded why it failed.
+static inline void fuzz_check_failed_read(const ndef_istream_t* istream, size_t index) {
+    FUZZ_CHECK(istream->index == index);
+    FUZZ_CHECK(istream->result.err != NDEF_OK);
+    FUZZ_CHECK(istream->result.offset <= istream->len);
+}
+
+// Check that a successful read advanced `istream` by `record_len` bytes from `index`.
+static inline void fuzz_check_read(const ndef_istream_t* istream, size_t index, size_t record_len) {
+    FUZZ_CHECK(record_len > 0);
+    FUZZ_CHECK(istream->index == index + record_len);
+    FUZZ_CHECK(istream->index <= istream->len);
+}
+
+// Skip the record at the index of `istream` after a typed reader rejected it.
+// Returns false if there is no complete record to skip.
+static inline bool fuzz_skip(ndef_istream_t* istream) {
+    ndef_record_t record;
+    return ndef_read_record(istream, &record) != 0;
+}
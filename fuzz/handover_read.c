@@ -0,0 +1,161 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Fuzz target for `ndef_handover_read`, `ndef_ble_oob_read` and their iterators.
+
+#include "fuzz.h"
+
+// Most carriers or AD structures a round trip is tried with.
+#define FUZZ_MAX_ITEMS 32
+
+// Check that the auxiliary data references of a carrier are as many as it says and cover its reference data.
+static void fuzz_check_aux(const ndef_handover_ac_t* ac) {
+    size_t      offset = 0;
+    size_t      count  = 0;
+    const char* ref;
+    size_t      ref_len;
+    while (ndef_handover_next_aux(ac, &offset, &ref, &ref_len)) {
+        FUZZ_CHECK(offset <= ac->aux_refs_len);
+        count++;
+    }
+    FUZZ_CHECK(count == ac->aux_count && offset == ac->aux_refs_len);
+}
+
+// Check that a handover record survives being written from its fields and read back.
+static void fuzz_round_trip_fields(const ndef_handover_t* handover, const ndef_handover_ac_t* carriers) {
+    ndef_handover_t fields = *handover;
+    fields.carriers        = carriers;
+
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    size_t         len     = ndef_handover_write(&ostream, fields, fields.pos);
+    FUZZ_CHECK(len && len == ostream.len && len == ndef_handover_encoded_size(fields));
+
+    ndef_istream_t  istream = NDEF_ISTREAM_NEW(ostream.data, ostream.len);
+    ndef_handover_t copy;
+    FUZZ_CHECK(ndef_handover_read(&istream, &copy) == ostream.len);
+    FUZZ_CHECK(copy.request == handover->request && copy.version == handover->version);
+    FUZZ_CHECK(copy.has_collision == handover->has_collision);
+    FUZZ_CHECK(!copy.has_collision || copy.collision == handover->collision);
+    FUZZ_CHECK(copy.err == handover->err);
+    if (copy.err != NDEF_HANDOVER_ERR_NONE) {
+        FUZZ_CHECK(fuzz_equal(copy.err_data, copy.err_data_len, handover->err_data, handover->err_data_len));
+    }
+    FUZZ_CHECK(copy.carriers_len == handover->carriers_len);
+    size_t             offset = 0;
+    ndef_handover_ac_t ac;
+    for (size_t i = 0; i < copy.carriers_len; i++) {
+        FUZZ_CHECK(ndef_handover_next_carrier(&copy, &offset, &ac));
+        FUZZ_CHECK(ac.cps == carriers[i].cps && ac.aux_count == carriers[i].aux_count);
+        FUZZ_CHECK(
+            fuzz_equal(ac.carrier_ref, ac.carrier_ref_len, carriers[i].carrier_ref, carriers[i].carrier_ref_len));
+        FUZZ_CHECK(fuzz_equal(ac.aux_refs, ac.aux_refs_len, carriers[i].aux_refs, carriers[i].aux_refs_len));
+    }
+    FUZZ_CHECK(!ndef_handover_next_carrier(&copy, &offset, &ac));
+    ndef_ostream_free(&ostream);
+}
+
+// Check the carriers of a handover record and round-trip it, both as read and from its fields.
+static void fuzz_check_handover(const uint8_t* data, size_t len, const ndef_handover_t* handover) {
+    ndef_handover_ac_t carriers[FUZZ_MAX_ITEMS];
+    size_t             offset = 0;
+    size_t             count  = 0;
+    bool               valid  = true;
+    ndef_handover_ac_t ac;
+    while (ndef_handover_next_carrier(handover, &offset, &ac)) {
+        FUZZ_CHECK(offset <= handover->records_len);
+        fuzz_check_aux(&ac);
+        ndef_record_t config;
+        if (ndef_handover_find_config(data, len, &ac, &config)) {
+            FUZZ_CHECK(fuzz_equal(config.id, config.id_len, ac.carrier_ref, ac.carrier_ref_len));
+        }
+        // The reader accepts empty carrier references, which the writer refuses to produce.
+        valid &= ac.carrier_ref_len > 0;
+        if (count < FUZZ_MAX_ITEMS) {
+            carriers[count] = ac;
+        }
+        count++;
+    }
+    FUZZ_CHECK(count == handover->carriers_len);
+
+    // Written as read, the inner message is copied as is.
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    size_t         written = ndef_handover_write(&ostream, *handover, handover->pos);
+    FUZZ_CHECK(written && written == ndef_handover_encoded_size(*handover));
+    ndef_istream_t  istream = NDEF_ISTREAM_NEW(ostream.data, ostream.len);
+    ndef_handover_t copy;
+    FUZZ_CHECK(ndef_handover_read(&istream, &copy) == ostream.len);
+    FUZZ_CHECK(fuzz_equal(copy.records, copy.records_len, handover->records, handover->records_len));
+    FUZZ_CHECK(copy.carriers_len == handover->carriers_len && copy.version == handover->version);
+    ndef_ostream_free(&ostream);
+
+    // Likewise for a Handover Request without a collision resolution record.
+    valid &= !handover->request || handover->has_collision;
+    if (valid && count <= FUZZ_MAX_ITEMS && handover->err_data_len <= 0xff) {
+        fuzz_round_trip_fields(handover, carriers);
+    }
+}
+
+// Check the AD structures of a Bluetooth LE record and round-trip them.
+static void fuzz_check_ble_oob(const ndef_ble_oob_t* oob) {
+    ndef_bt_ad_t ads[FUZZ_MAX_ITEMS];
+    size_t       offset = 0;
+    size_t       count  = 0;
+    ndef_bt_ad_t ad;
+    while (ndef_bt_ad_next(oob->ad, oob->ad_len, &offset, &ad)) {
+        FUZZ_CHECK(offset <= oob->ad_len && ad.len <= 254);
+        if (count < FUZZ_MAX_ITEMS) {
+            ads[count] = ad;
+        }
+        count++;
+    }
+    if (count > FUZZ_MAX_ITEMS) {
+        return;
+    }
+
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    FUZZ_CHECK(ndef_ble_oob_write(&ostream, oob->id, oob->id_len, ads, count, oob->pos) == ostream.len);
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(ostream.data, ostream.len);
+    ndef_ble_oob_t copy;
+    FUZZ_CHECK(ndef_ble_oob_read(&istream, &copy) == ostream.len);
+    // Anything after a structure of length 0 is dropped.
+    FUZZ_CHECK(fuzz_equal(copy.ad, copy.ad_len, oob->ad, offset));
+    FUZZ_CHECK(fuzz_equal(copy.id, copy.id_len, oob->id, oob->id_len));
+    FUZZ_CHECK(copy.has_address == oob->has_address && copy.has_role == oob->has_role);
+    FUZZ_CHECK(!copy.has_address || (fuzz_equal(copy.address, 6, oob->address, 6) &&
+                                     copy.address_random == oob->address_random));
+    FUZZ_CHECK(!copy.has_role || copy.role == oob->role);
+    FUZZ_CHECK(fuzz_equal(copy.name, copy.name_len, oob->name, oob->name_len));
+    ndef_ostream_free(&ostream);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t len) {
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(data, len);
+    while (istream.index < len) {
+        size_t          index = fuzz_begin_read(&istream);
+        ndef_handover_t handover;
+        size_t          record_len = ndef_handover_read(&istream, &handover);
+        if (record_len) {
+            fuzz_check_read(&istream, index, record_len);
+            FUZZ_CHECK(handover.records + handover.records_len <= data + istream.index);
+            fuzz_check_handover(data, len, &handover);
+            continue;
+        }
+        fuzz_check_failed_read(&istream, index);
+
+        // Carrier configuration records follow the handover record.
+        index = fuzz_begin_read(&istream);
+        ndef_ble_oob_t oob;
+        record_len = ndef_ble_oob_read(&istream, &oob);
+        if (record_len) {
+            fuzz_check_read(&istream, index, record_len);
+            fuzz_check_ble_oob(&oob);
+            continue;
+        }
+        fuzz_check_failed_read(&istream, index);
+        if (!fuzz_skip(&istream)) {
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Fuzz target for `ndef_read_record` and the chunked record readers built on it.
+
+#include "fuzz.h"
+
+// Check that a record survives being written and read back.
+static void fuzz_round_trip(const ndef_record_t* record, size_t record_len) {
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    FUZZ_CHECK(ndef_write_raw(&ostream, record));
+    // The writer picks the short form when it can, so the output is never longer than the input.
+    FUZZ_CHECK(ostream.len <= record_len);
+    FUZZ_CHECK(ostream.len == ndef_record_encoded_size(record->type_len, record->id_len, record->payload_len));
+
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(ostream.data, ostream.len);
+    ndef_record_t  copy;
+    FUZZ_CHECK(ndef_read_record(&istream, &copy) == ostream.len);
+    FUZZ_CHECK(copy.pos == record->pos && copy.tnf == record->tnf && copy.chunked == record->chunked);
+    FUZZ_CHECK(fuzz_equal(copy.type, copy.type_len, record->type, record->type_len));
+    FUZZ_CHECK(fuzz_equal(copy.id, copy.id_len, record->id, record->id_len));
+    FUZZ_CHECK(fuzz_equal(copy.payload, copy.payload_len, record->payload, record->payload_len));
+    ndef_ostream_free(&ostream);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t len) {
+    // Every record, as a tag reader that walks the raw records would see them.
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(data, len);
+    while (istream.index < len) {
+        size_t        index = fuzz_begin_read(&istream);
+        ndef_record_t record;
+        size_t        record_len = ndef_read_record(&istream, &record);
+        if (!record_len) {
+            fuzz_check_failed_read(&istream, index);
+            FUZZ_CHECK(istream.result.err == NDEF_ERR_TRUNCATED);
+            break;
+        }
+        fuzz_check_read(&istream, index, record_len);
+        fuzz_round_trip(&record, record_len);
+    }
+
+    // The same data as chunked records, reassembled both ways.
+    istream = (ndef_istream_t)NDEF_ISTREAM_NEW(data, len);
+    while (istream.index < len) {
+        size_t         index = fuzz_begin_read(&istream);
+        ndef_record_t  record;
+        ndef_slice_t   slices[8];
+        size_t         slices_len;
+        size_t         record_len = ndef_read_chunked(&istream, &record, slices, 8, &slices_len);
+        if (!record_len) {
+            fuzz_check_failed_read(&istream, index);
+            break;
+        }
+        fuzz_check_read(&istream, index, record_len);
+        FUZZ_CHECK(slices_len >= 1 && slices_len <= 8);
+        FUZZ_CHECK(ndef_slices_len(slices, slices_len) == record.payload_len);
+
+        ndef_ostream_t payload = NDEF_OSTREAM_NEW();
+        istream.index          = index;
+        FUZZ_CHECK(ndef_read_chunked_into(&istream, &record, &payload) == record_len);
+        FUZZ_CHECK(payload.len == record.payload_len);
+        size_t offset = 0;
+        for (size_t i = 0; i < slices_len; i++) {
+            FUZZ_CHECK(fuzz_equal(payload.data + offset, slices[i].len, slices[i].data, slices[i].len));
+            offset += slices[i].len;
+        }
+        ndef_ostream_free(&payload);
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Writes the seed corpus for the fuzz targets into a directory.
+// The seeds are made with the library's own writers, so that they cover every record kind the readers handle.
+
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include "ndef.h"
+
+// Directory the seeds are written to.
+static const char* seeds_dir;
+
+// Write a seed and reset the stream it was built in.
+static bool seeds_save(const char* name, ndef_ostream_t* ostream) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%s", seeds_dir, name);
+    FILE* fd = fopen(path, "wb");
+    if (!fd) {
+        perror(path);
+        return false;
+    }
+    bool ok = fwrite(ostream->data, 1, ostream->len, fd) == ostream->len;
+    ok      = !fclose(fd) && ok;
+    if (!ok) {
+        perror(path);
+    }
+    ostream->len = 0;
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s DIR\n", argv[0]);
+        return 1;
+    }
+    seeds_dir = argv[1];
+    if (mkdir(seeds_dir, 0777) && errno != EEXIST) {
+        perror(seeds_dir);
+        return 1;
+    }
+
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    bool           ok      = true;
+
+    // Single records of the well-known types.
+    ok = ok && ndef_uri_write_cstr(&ostream, "https://badge.team/", NDEF_POS_START_END);
+    ok = ok && seeds_save("uri", &ostream);
+    ok = ok && ndef_uri_write(&ostream, (ndef_uri_t){.uri = ""}, NDEF_POS_START_END);
+    ok = ok && seeds_save("uri-empty", &ostream);
+    ok = ok && ndef_text_write_cstr(&ostream, "en", "Hello, World!", NDEF_POS_START_END);
+    ok = ok && seeds_save("text", &ostream);
+    ok = ok && ndef_text_write_utf16(&ostream, "nl", 2, "Welkom \xe2\x82\xac \xf0\x9f\x98\x80", 15, NDEF_POS_START_END);
+    ok = ok && seeds_save("text-utf16", &ostream);
+
+    // A Smart Poster with every optional field.
+    ndef_smartposter_t poster = {
+        .prefix         = NDEF_URI_PREFIX_HTTPS,
+        .uri            = "example.com/",
+        .uri_len        = 12,
+        .title          = "Example",
+        .title_len      = 7,
+        .title_lang     = "en",
+        .title_lang_len = 2,
+        .has_action     = true,
+        .action         = NDEF_SMARTPOSTER_ACTION_SAVE,
+        .has_size       = true,
+        .size           = 4096,
+        .mime_type      = "text/html",
+        .mime_type_len  = 9,
+        .icon_type      = "image/png",
+        .icon_type_len  = 9,
+        .icon           = (const uint8_t*)"\x89PNG",
+        .icon_len       = 4,
+    };
+    ok = ok && ndef_smartposter_write(&ostream, poster, NDEF_POS_START_END);
+    ok = ok && seeds_save("smartposter", &ostream);
+
+    // A Smart Poster with titles in two languages.
+    size_t mark;
+    ok = ok && ndef_write_record_begin(&ostream, NDEF_TNF_WELL_KNOWN, "Sp", NDEF_POS_START_END, &mark);
+    ok = ok && ndef_uri_write_cstr(&ostream, "https://badge.team/", NDEF_POS_START);
+    ok = ok && ndef_text_write_cstr(&ostream, "en", "Welcome", 0);
+    ok = ok && ndef_text_write_cstr(&ostream, "nl", "Welkom", NDEF_POS_END);
+    ok = ok && ndef_write_record_end(&ostream, mark);
+    ok = ok && seeds_save("smartposter-titles", &ostream);
+
+    // A Bluetooth LE handover message: the Handover Select record and the carrier configuration it refers to.
+    static const uint8_t      ble_address[7] = {0x01, 0x02, 0x03, 0x04, 0x05, 0xc6, 0x01};
+    static const uint8_t      ble_role       = NDEF_BLE_ROLE_PERIPHERAL;
+    static const ndef_bt_ad_t ble_ads[]      = {
+        {NDEF_BT_AD_LE_ADDRESS, ble_address, sizeof(ble_address)},
+        {NDEF_BT_AD_LE_ROLE, &ble_role, 1},
+        {NDEF_BT_AD_NAME_COMPLETE, (const uint8_t*)"Badge", 5},
+    };
+    ndef_handover_ac_t ble_carrier = {.cps = NDEF_HANDOVER_CPS_ACTIVE, .carrier_ref = "0", .carrier_ref_len = 1};
+    ndef_handover_t    handover    = {.carriers = &ble_carrier, .carriers_len = 1};
+    ok = ok && ndef_handover_write(&ostream, handover, NDEF_POS_START);
+    ok = ok && ndef_ble_oob_write(&ostream, "0", 1, ble_ads, sizeof(ble_ads) / sizeof(ndef_bt_ad_t), NDEF_POS_END);
+    ok = ok && seeds_save("handover", &ostream);
+
+    // A record long enough for the long form, with an ID.
+    static uint8_t long_payload[300];
+    ndef_record_t  long_record = {
+         .pos         = NDEF_POS_START_END,
+         .tnf         = NDEF_TNF_MIME_MEDIA,
+         .type_len    = 24,
+         .type        = "application/octet-stream",
+         .id_len      = 2,
+         .id          = "id",
+         .payload_len = sizeof(long_payload),
+         .payload     = long_payload,
+    };
+    ok = ok && ndef_write_raw(&ostream, &long_record);
+    ok = ok && seeds_save("long", &ostream);
+
+    // The same record split into chunks.
+    ok = ok && ndef_write_chunked(&ostream, &long_record, 100);
+    ok = ok && seeds_save("chunked", &ostream);
+
+    // A message mixing every reader's record type.
+    ok = ok && ndef_uri_write_cstr(&ostream, "tel:+31201234567", NDEF_POS_START);
+    ok = ok && ndef_text_write_cstr(&ostream, "de", "Willkommen", 0);
+    ok = ok && ndef_smartposter_write(&ostream, poster, 0);
+    ok = ok && ndef_write_raw(&ostream, &(ndef_record_t){.pos = NDEF_POS_END, .tnf = NDEF_TNF_EMPTY});
+    ok = ok && seeds_save("message", &ostream);
+
+    ndef_ostream_free(&ostream);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Fuzz target for `ndef_smartposter_read` and the title iterator.
+
+#include "fuzz.h"
+
+// Check that every title is found and that the chosen title is one of them.
+static void fuzz_check_titles(const ndef_smartposter_t* poster) {
+    size_t      offset = 0;
+    size_t      count  = 0;
+    bool        found  = false;
+    ndef_text_t title;
+    while (ndef_smartposter_next_title(poster, &offset, &title)) {
+        FUZZ_CHECK(offset <= poster->records_len);
+        found |= title.text == poster->title && title.text_len == poster->title_len;
+        count++;
+    }
+    FUZZ_CHECK(count == poster->title_count);
+    FUZZ_CHECK(found == (count > 0));
+}
+
+// Check that a Smart Poster survives being written and read back.
+// Only the chosen title is written, so the copy has at most one.
+static void fuzz_round_trip(const ndef_smartposter_t* poster) {
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    size_t         len     = ndef_smartposter_write(&ostream, *poster, poster->pos);
+    if (!len) {
+        // The reader accepts an empty URI and invalid titles, which the writer refuses to produce.
+        FUZZ_CHECK(ostream.result.err == NDEF_ERR_INVALID_ARG && ostream.len == 0);
+        ndef_ostream_free(&ostream);
+        return;
+    }
+    FUZZ_CHECK(len == ostream.len && len == ndef_smartposter_encoded_size(*poster));
+
+    ndef_istream_t     istream = NDEF_ISTREAM_NEW(ostream.data, ostream.len);
+    ndef_smartposter_t copy;
+    FUZZ_CHECK(ndef_smartposter_read(&istream, &copy) == ostream.len);
+    FUZZ_CHECK(copy.pos == poster->pos && copy.prefix == poster->prefix);
+    FUZZ_CHECK(fuzz_equal(copy.uri, copy.uri_len, poster->uri, poster->uri_len));
+    FUZZ_CHECK(copy.title_count == (poster->title_len ? 1 : 0));
+    if (poster->title_len) {
+        FUZZ_CHECK(copy.title_encoding == poster->title_encoding);
+        FUZZ_CHECK(fuzz_equal(copy.title, copy.title_len, poster->title, poster->title_len));
+        FUZZ_CHECK(fuzz_equal(copy.title_lang, copy.title_lang_len, poster->title_lang, poster->title_lang_len));
+    }
+    FUZZ_CHECK(copy.has_action == poster->has_action && (!copy.has_action || copy.action == poster->action));
+    FUZZ_CHECK(copy.has_size == poster->has_size && (!copy.has_size || copy.size == poster->size));
+    FUZZ_CHECK(fuzz_equal(copy.mime_type, copy.mime_type_len, poster->mime_type, poster->mime_type_len));
+    FUZZ_CHECK(fuzz_equal(copy.icon_type, copy.icon_type_len, poster->icon_type, poster->icon_type_len));
+    if (poster->icon_type_len) {
+        FUZZ_CHECK(fuzz_equal(copy.icon, copy.icon_len, poster->icon, poster->icon_len));
+    }
+    ndef_ostream_free(&ostream);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t len) {
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(data, len);
+    while (istream.index < len) {
+        size_t             index = fuzz_begin_read(&istream);
+        ndef_smartposter_t poster;
+        size_t             record_len = ndef_smartposter_read(&istream, &poster);
+        if (!record_len) {
+            fuzz_check_failed_read(&istream, index);
+            if (!fuzz_skip(&istream)) {
+                break;
+            }
+            continue;
+        }
+        fuzz_check_read(&istream, index, record_len);
+        FUZZ_CHECK(poster.records + poster.records_len <= data + istream.index);
+        fuzz_check_titles(&poster);
+        fuzz_round_trip(&poster);
+    }
+    return 0;
+}
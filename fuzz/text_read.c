@@ -0,0 +1,73 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Fuzz target for `ndef_text_read` and the UTF-16 transcoder behind `ndef_text_get_utf8`.
+
+#include "fuzz.h"
+
+// Check that the text converts to UTF-8 of the predicted length.
+static void fuzz_check_utf8(const ndef_text_t* text) {
+    size_t cap = text->encoding == NDEF_TEXT_UTF16
+                     ? ndef_utf16_utf8_len((const uint8_t*)text->text, text->text_len, true)
+                     : text->text_len;
+    char*  buf = malloc(cap ? cap : 1);
+    FUZZ_CHECK(buf);
+    const char* utf8;
+    size_t      utf8_len;
+    bool        valid = ndef_text_get_utf8(text, buf, cap, &utf8, &utf8_len);
+    if (text->encoding == NDEF_TEXT_UTF16) {
+        // Unpaired surrogates and a trailing odd byte are replaced, so UTF-16 always converts.
+        FUZZ_CHECK(valid && utf8_len == cap);
+        FUZZ_CHECK(ndef_utf8_valid((const uint8_t*)utf8, utf8_len));
+    } else {
+        FUZZ_CHECK(valid == ndef_utf8_valid((const uint8_t*)text->text, text->text_len));
+    }
+    free(buf);
+}
+
+// Check that a text record survives being written and read back.
+static void fuzz_round_trip(const ndef_text_t* text) {
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    if (!ndef_text_write(&ostream, *text, text->pos)) {
+        // The reader accepts text the writer refuses to produce: invalid UTF-8 or an odd number of UTF-16 bytes.
+        FUZZ_CHECK(ostream.result.err == NDEF_ERR_INVALID_ARG && ostream.len == 0);
+        FUZZ_CHECK(text->encoding == NDEF_TEXT_UTF16 ? text->text_len % 2 != 0
+                                                     : !ndef_utf8_valid((const uint8_t*)text->text, text->text_len));
+        ndef_ostream_free(&ostream);
+        return;
+    }
+    FUZZ_CHECK(ostream.len == ndef_text_encoded_size(*text));
+
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(ostream.data, ostream.len);
+    ndef_text_t    copy;
+    FUZZ_CHECK(ndef_text_read(&istream, &copy) == ostream.len);
+    FUZZ_CHECK(copy.pos == text->pos && copy.encoding == text->encoding);
+    FUZZ_CHECK(fuzz_equal(copy.lang, copy.lang_len, text->lang, text->lang_len));
+    FUZZ_CHECK(fuzz_equal(copy.text, copy.text_len, text->text, text->text_len));
+    ndef_ostream_free(&ostream);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t len) {
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(data, len);
+    while (istream.index < len) {
+        size_t      index = fuzz_begin_read(&istream);
+        ndef_text_t text;
+        size_t      record_len = ndef_text_read(&istream, &text);
+        if (!record_len) {
+            fuzz_check_failed_read(&istream, index);
+            if (!fuzz_skip(&istream)) {
+                break;
+            }
+            continue;
+        }
+        fuzz_check_read(&istream, index, record_len);
+        // The language code and text lie within the record.
+        FUZZ_CHECK((const uint8_t*)text.lang > data + index);
+        FUZZ_CHECK((const uint8_t*)text.text + text.text_len <= data + istream.index);
+        FUZZ_CHECK(text.lang_len <= 0x3f);
+        fuzz_check_utf8(&text);
+        fuzz_round_trip(&text);
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Fuzz target for `ndef_uri_read`.
+
+#include "fuzz.h"
+
+// Check that a URI record survives being written and read back.
+static void fuzz_round_trip(const ndef_uri_t* uri) {
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    FUZZ_CHECK(ndef_uri_write(&ostream, *uri, uri->pos));
+    FUZZ_CHECK(ostream.len == ndef_uri_encoded_size(*uri));
+
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(ostream.data, ostream.len);
+    ndef_uri_t     copy;
+    FUZZ_CHECK(ndef_uri_read(&istream, &copy) == ostream.len);
+    FUZZ_CHECK(copy.pos == uri->pos && copy.prefix == uri->prefix);
+    FUZZ_CHECK(fuzz_equal(copy.uri, copy.uri_len, uri->uri, uri->uri_len));
+    ndef_ostream_free(&ostream);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t len) {
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(data, len);
+    while (istream.index < len) {
+        size_t     index = fuzz_begin_read(&istream);
+        ndef_uri_t uri;
+        size_t     record_len = ndef_uri_read(&istream, &uri);
+        if (!record_len) {
+            fuzz_check_failed_read(&istream, index);
+            if (!fuzz_skip(&istream)) {
+                break;
+            }
+            continue;
+        }
+        fuzz_check_read(&istream, index, record_len);
+        FUZZ_CHECK(uri.prefix < NDEF_URI_NUM_PREFIX);
+        FUZZ_CHECK((const uint8_t*)uri.uri + uri.uri_len <= data + istream.index);
+        fuzz_round_trip(&uri);
+    }
+    return 0;
+}
@@ -4,9 +4,23 @@
 
 #pragma once
 
+#include "ndef/bluetooth.h"
+#include "ndef/diff.h"
+#include "ndef/external.h"
+#include "ndef/handover.h"
+#include "ndef/index.h"
+#include "ndef/mime.h"
+#include "ndef/parser.h"
+#include "ndef/registry.h"
+#include "ndef/sha256.h"
+#include "ndef/sig.h"
 #include "ndef/smartposter.h"
+#include "ndef/stats.h"
 #include "ndef/text.h"
+#include "ndef/tlv.h"
 #include "ndef/uri.h"
+#include "ndef/utf.h"
+#include "ndef/wifi.h"
 
 // Types for a decoded NDEF record.
 typedef enum {
@@ -15,10 +29,18 @@ typedef enum {
     NDEF_DECD_TYPE_TEXT,
     NDEF_DECD_TYPE_SMART_POSTER,
     NDEF_DECD_TYPE_WIFI,
+    NDEF_DECD_TYPE_AAR,
+    NDEF_DECD_TYPE_MIME,
+    NDEF_DECD_TYPE_EXTERNAL,
+    NDEF_DECD_TYPE_SIGNATURE,
+    NDEF_DECD_TYPE_HANDOVER,
+    NDEF_DECD_TYPE_BLE_OOB,
+    // First type for records decoded by application-defined decoders; see `ndef_decd_decoder_t`.
+    NDEF_DECD_TYPE_APP = 0x100,
 } ndef_decd_type_t;
 
 // A decoded NDEF record.
-// Decodes known MIME or well-known types.
+// Decodes known well-known, MIME and external types; other MIME and external types are decoded as generic views.
 typedef struct {
     // The position of this record in the message.
     ndef_pos_t       pos;
@@ -31,5 +53,106 @@ typedef struct {
         ndef_text_t        text;
         // The decoded smart poster record.
         ndef_smartposter_t smartposter;
+        // The decoded Wi-Fi record.
+        ndef_wifi_t        wifi;
+        // The decoded Android Application Record.
+        ndef_aar_t         aar;
+        // The decoded MIME record of another MIME type.
+        ndef_mime_t        mime;
+        // The decoded external type record of another type.
+        ndef_external_t    external;
+        // The decoded Signature record.
+        ndef_sig_t         sig;
+        // The decoded Handover Select or Handover Request record.
+        ndef_handover_t    handover;
+        // The decoded Bluetooth LE carrier configuration record.
+        ndef_ble_oob_t     ble_oob;
+        // The record itself, for unknown and application-defined types.
+        ndef_record_t      record;
     } data;
 } ndef_decd_record_t;
+
+// Decoder for an application-defined record type.
+// Register it with `ndef_registry_add` in a registry passed to `ndef_decd_decode_with` or `ndef_decd_read_with`.
+typedef struct {
+    // Decode the payload of a record, setting `decd_out->type` to `NDEF_DECD_TYPE_APP` or above.
+    // `decd_out->data.record` holds the record when this is called.
+    // Return false to fall back to the built-in decoders.
+    bool (*decode)(const ndef_record_t* record, ndef_decd_record_t* decd_out, void* cookie);
+    // Passed to `decode`.
+    void* cookie;
+} ndef_decd_decoder_t;
+
+// Decode the payload of an NDEF record that has already been read, e.g. by `ndef_message_next`.
+// The application-defined decoders of `registry` are tried first; with a NULL `registry` only the built-in ones are.
+// The registry is only read, so several callers may share one once it is set up.
+// The decoder is picked by type name format and type, so the header is parsed once and types are compared once.
+// Records of types that are not known are decoded as `NDEF_DECD_TYPE_UNKNOWN` and return false.
+bool   ndef_decd_decode_with(const ndef_registry_t* registry, const ndef_record_t* record,
+                             ndef_decd_record_t* decd_out);
+// Read and decode an NDEF record, trying the application-defined decoders of `registry` first like
+// `ndef_decd_decode_with`.
+// On success, `istream` is advanced past the record.
+// A record whose type has a decoder but whose payload is malformed fails with `NDEF_ERR_PAYLOAD`; other records
+// that cannot be decoded fail with `NDEF_ERR_TYPE`.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_decd_read_with(const ndef_registry_t* registry, ndef_istream_t* istream, ndef_decd_record_t* decd_out);
+
+// Decode the payload of an NDEF record that has already been read with the built-in decoders.
+// Records of types that are not known are decoded as `NDEF_DECD_TYPE_UNKNOWN` and return false.
+static inline bool ndef_decd_decode(const ndef_record_t* record, ndef_decd_record_t* decd_out) {
+    return ndef_decd_decode_with(NULL, record, decd_out);
+}
+// Read and decode an NDEF record with the built-in decoders.
+// On success, `istream` is advanced past the record.
+// Returns how long the record was read, or 0 on error.
+static inline size_t ndef_decd_read(ndef_istream_t* istream, ndef_decd_record_t* decd_out) {
+    return ndef_decd_read_with(NULL, istream, decd_out);
+}
+
+// Get the encoded size of a decoded NDEF record.
+// Records of application-defined types are encoded from `data.record`.
+// Returns 0 if the record type cannot be encoded.
+size_t ndef_decd_encoded_size(const ndef_decd_record_t* record);
+// Write a decoded NDEF record.
+bool   ndef_decd_write(ndef_ostream_t* ostream, const ndef_decd_record_t* record, ndef_pos_t pos);
+
+// Get the encoded size of an NDEF message made of `records_len` records.
+// Returns 0 if any of the records cannot be encoded or the size does not fit in a `size_t`.
+size_t ndef_message_encoded_size(const ndef_decd_record_t* records, size_t records_len);
+// Write an NDEF message made of `records_len` records.
+// The whole message is reserved at once and the positions of the records are derived from their order.
+bool   ndef_message_write(ndef_ostream_t* ostream, const ndef_decd_record_t* records, size_t records_len);
+// Write an NDEF message like `ndef_message_write` and find the ranges that differ from `old_data`,
+// the encoding of the message it replaces; see `ndef_diff_at`.
+// `base_offset` is where the message starts in tag memory, after the capability container and the TLV header, so
+// that the ranges are widened to blocks of `block_size` bytes of tag memory.
+// Offsets are relative to the start of the new message.
+bool   ndef_message_rewrite(ndef_ostream_t* ostream, const uint8_t* old_data, size_t old_len,
+                            const ndef_decd_record_t* records, size_t records_len, size_t base_offset,
+                            size_t block_size, ndef_diff_range_t* ranges_out, size_t cap, size_t* ranges_len_out);
+
+// A message to be written by `ndef_batch_write`.
+typedef struct {
+    // The records of the message.
+    const ndef_decd_record_t* records;
+    // Number of records in the message.
+    size_t                    records_len;
+} ndef_batch_message_t;
+
+// Location of a message written by `ndef_batch_write`.
+typedef struct {
+    // Offset of the message from the start of the output stream's data.
+    size_t offset;
+    // Encoded length of the message.
+    size_t len;
+} ndef_batch_entry_t;
+
+// Get the encoded size of `messages_len` messages written back to back.
+// Returns 0 if any of the messages is empty or cannot be encoded, or the size does not fit in a `size_t`.
+size_t ndef_batch_encoded_size(const ndef_batch_message_t* messages, size_t messages_len);
+// Write `messages_len` NDEF messages back to back and store where each one ended up in `entries_out`.
+// The whole batch is reserved at once, and URI and text records are copied straight into the reserved memory.
+// On failure, nothing is written.
+bool   ndef_batch_write(ndef_ostream_t* ostream, const ndef_batch_message_t* messages, size_t messages_len,
+                        ndef_batch_entry_t* entries_out);
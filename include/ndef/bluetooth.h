@@ -0,0 +1,108 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common.h"
+
+// MIME type of a Bluetooth LE carrier configuration record.
+#define NDEF_BLE_OOB_MIME_TYPE "application/vnd.bluetooth.le.oob"
+
+// Types of the AD structures in Bluetooth LE out-of-band data.
+typedef enum {
+    NDEF_BT_AD_FLAGS           = 0x01,
+    NDEF_BT_AD_NAME_SHORT      = 0x08,
+    NDEF_BT_AD_NAME_COMPLETE   = 0x09,
+    NDEF_BT_AD_CLASS_OF_DEVICE = 0x0d,
+    NDEF_BT_AD_SM_TK           = 0x10,
+    NDEF_BT_AD_APPEARANCE      = 0x19,
+    NDEF_BT_AD_LE_ADDRESS      = 0x1b,
+    NDEF_BT_AD_LE_ROLE         = 0x1c,
+    NDEF_BT_AD_LE_SC_CONFIRM   = 0x22,
+    NDEF_BT_AD_LE_SC_RANDOM    = 0x23,
+} ndef_bt_ad_type_t;
+
+// Role of a Bluetooth LE device in out-of-band data.
+typedef enum {
+    NDEF_BLE_ROLE_PERIPHERAL           = 0x00,
+    NDEF_BLE_ROLE_CENTRAL              = 0x01,
+    NDEF_BLE_ROLE_PERIPHERAL_PREFERRED = 0x02,
+    NDEF_BLE_ROLE_CENTRAL_PREFERRED    = 0x03,
+} ndef_ble_role_t;
+
+// An AD structure: one byte of length, one byte of type and the data.
+typedef struct {
+    // AD type; see `ndef_bt_ad_type_t`.
+    uint8_t        type;
+    // AD data.
+    const uint8_t* data;
+    // AD data length; at most 254.
+    size_t         len;
+} ndef_bt_ad_t;
+
+// Data for an NDEF Bluetooth LE carrier configuration record.
+typedef struct {
+    // Whether this is beginning, end, both or middle of a message.
+    ndef_pos_t      pos;
+    // ID of the record, which alternative carriers refer to.
+    const char*     id;
+    // ID length.
+    size_t          id_len;
+    // Whether `address` is present.
+    bool            has_address;
+    // Device address, least significant byte first as in the AD structure.
+    uint8_t         address[6];
+    // Whether `address` is a random address instead of a public one.
+    bool            address_random;
+    // Whether `role` is present.
+    bool            has_role;
+    // Role of the device.
+    ndef_ble_role_t role;
+    // Local name of the device, complete or shortened; not NUL-terminated.
+    const char*     name;
+    // Name length.
+    size_t          name_len;
+    // All AD structures of the record, for `ndef_bt_ad_next`.
+    const uint8_t*  ad;
+    // Length of `ad`.
+    size_t          ad_len;
+} ndef_ble_oob_t;
+
+// Get the next AD structure of out-of-band data such as `ndef_ble_oob_t.ad`.
+// `offset` must be 0 for the first call and is advanced past the structure found.
+// The data is a reference to `data`. A structure of length 0 ends the data early.
+// Returns false if there are no more structures or the next one is truncated.
+bool   ndef_bt_ad_next(const uint8_t* data, size_t len, size_t* offset, ndef_bt_ad_t* ad_out);
+
+// Get the payload size of AD structures.
+static inline size_t ndef_bt_ad_size(const ndef_bt_ad_t* ads, size_t ads_len) {
+    size_t size = 0;
+    for (size_t i = 0; i < ads_len; i++) {
+        size += 2 + ads[i].len;
+    }
+    return size;
+}
+
+// Get the encoded size of an NDEF Bluetooth LE carrier configuration record written by `ndef_ble_oob_write_ad`.
+static inline size_t ndef_ble_oob_encoded_size(ndef_ble_oob_t oob) {
+    return ndef_record_encoded_size(sizeof(NDEF_BLE_OOB_MIME_TYPE) - 1, oob.id_len, oob.ad_len);
+}
+
+// Decode the payload of an NDEF Bluetooth LE carrier configuration record that has already been read.
+// The strings within are a reference to the record's payload.
+bool   ndef_ble_oob_decode(const ndef_record_t* record, ndef_ble_oob_t* oob_out);
+// Read an NDEF Bluetooth LE carrier configuration record.
+// The strings within are a reference to the blob passed.
+// On success, `istream` is advanced past the record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_ble_oob_read(ndef_istream_t* istream, ndef_ble_oob_t* oob_out);
+// Write an NDEF Bluetooth LE carrier configuration record made of `ads_len` AD structures.
+// `id` is what the alternative carrier of the handover record refers to.
+// Returns how long the record was written, or 0 on error.
+size_t ndef_ble_oob_write(ndef_ostream_t* data_out, const char* id, size_t id_len, const ndef_bt_ad_t* ads,
+                          size_t ads_len, ndef_pos_t pos);
+// Write an NDEF Bluetooth LE carrier configuration record with the ID and AD structures of `oob` as they were read;
+// the decoded fields are ignored.
+// Returns how long the record was written, or 0 on error.
+size_t ndef_ble_oob_write_ad(ndef_ostream_t* data_out, ndef_ble_oob_t oob, ndef_pos_t pos);
@@ -7,23 +7,95 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+#include "stats.h"
+
+// Whether the record codec primitives, such as `ndef_ostream_push` and `ndef_read_record`, are defined in the headers;
+// define as 1 to enable. They are then inlined into their callers, where constant arguments like the type of
+// `ndef_write_record` fold away, at the cost of code size. The rest of the library still needs linking.
+#ifndef NDEF_HEADER_ONLY
+#define NDEF_HEADER_ONLY 0
+#endif
+
+// Linkage of the record codec primitives; see `NDEF_HEADER_ONLY`.
+#if NDEF_HEADER_ONLY
+#define NDEF_INLINE static inline
+#else
+#define NDEF_INLINE
+#endif
 
 // Return false if the expression is false.
 #define NDEF_RETURN_ON_FALSE(expr, ...) \
     ({                                  \
         typeof(expr) expr_ = (expr);    \
         if (!(expr_)) {                 \
-            return false;               \
             __VA_ARGS__                 \
+            return false;               \
         }                               \
         expr_;                          \
     })
 
-// A stream of output bytes with a length and capacity.
+// Why an operation on a stream failed.
+typedef enum {
+    // No error.
+    NDEF_OK = 0,
+    // The data ends within a record; it may succeed once more data has been read from the tag.
+    NDEF_ERR_TRUNCATED,
+    // The data is not a well-formed NDEF message, e.g. message flags or chunks are out of order.
+    NDEF_ERR_MALFORMED,
+    // The record is not of the type that was asked for.
+    NDEF_ERR_TYPE,
+    // The record has the type asked for, but its payload is malformed.
+    NDEF_ERR_PAYLOAD,
+    // The last record of the message has already been read.
+    NDEF_ERR_END,
+    // Heap or arena memory ran out.
+    NDEF_ERR_NO_MEM,
+    // The output does not fit in a caller-owned buffer.
+    NDEF_ERR_NO_SPACE,
+    // A value to write is out of range or invalid, such as a language code longer than 63 bytes.
+    NDEF_ERR_INVALID_ARG,
+    // A callback asked to stop.
+    NDEF_ERR_ABORTED,
+} ndef_err_t;
+
+// The outcome of the most recent failed operation on a stream.
+typedef struct {
+    // Why it failed.
+    ndef_err_t err;
+    // Byte offset of the failure: where the offending record or field starts for input streams,
+    // and the length of the output at the time of the failure for output streams.
+    size_t     offset;
+} ndef_result_t;
+
+// Where the memory of an output stream comes from.
+typedef enum {
+    // Heap memory managed with `realloc`; grows as needed.
+    NDEF_OSTREAM_MODE_HEAP,
+    // A caller-owned buffer of fixed capacity; never grows.
+    NDEF_OSTREAM_MODE_FIXED,
+    // Memory taken from an `ndef_arena_t`; grows in place when possible.
+    NDEF_OSTREAM_MODE_ARENA,
+} ndef_ostream_mode_t;
+
+// A bump allocator over a caller-owned buffer.
 typedef struct {
     uint8_t* data;
     size_t   len;
     size_t   cap;
+} ndef_arena_t;
+
+// A stream of output bytes with a length and capacity.
+typedef struct {
+    uint8_t*            data;
+    size_t              len;
+    size_t              cap;
+    // Where the memory comes from.
+    ndef_ostream_mode_t mode;
+    // The arena to allocate from if `mode` is `NDEF_OSTREAM_MODE_ARENA`.
+    ndef_arena_t*       arena;
+    // Why the last failed write failed; only set on failure, so it is stale after a success.
+    ndef_result_t       result;
 } ndef_ostream_t;
 
 // A stream of input bytes with an index.
@@ -31,6 +103,8 @@ typedef struct {
     uint8_t const* data;
     size_t         len;
     size_t         index;
+    // Why the last failed read failed; only set on failure, so it is stale after a success.
+    ndef_result_t  result;
 } ndef_istream_t;
 
 // NDEF type name format.
@@ -46,10 +120,24 @@ typedef enum {
 } ndef_tnf_t;
 
 // Create an input stream from some bytes.
-#define NDEF_ISTREAM_NEW(data_, len_) ((ndef_istream_t){data_, len_, 0})
+#define NDEF_ISTREAM_NEW(data_, len_) ((ndef_istream_t){data_, len_, 0, {NDEF_OK, 0}})
 
 // Create an empty output stream.
-#define NDEF_OSTREAM_NEW() ((ndef_ostream_t){NULL, 0, 0})
+#define NDEF_OSTREAM_NEW() ((ndef_ostream_t){NULL, 0, 0, NDEF_OSTREAM_MODE_HEAP, NULL, {NDEF_OK, 0}})
+
+// Create an empty output stream that writes into a caller-owned buffer.
+// Writes that do not fit in `cap_` bytes fail and leave the stream unchanged.
+#define NDEF_OSTREAM_NEW_FIXED(buf_, cap_) \
+    ((ndef_ostream_t){(uint8_t*)(buf_), 0, (cap_), NDEF_OSTREAM_MODE_FIXED, NULL, {NDEF_OK, 0}})
+
+// Create an empty output stream that allocates from `arena_`.
+#define NDEF_OSTREAM_NEW_ARENA(arena_) ((ndef_ostream_t){NULL, 0, 0, NDEF_OSTREAM_MODE_ARENA, arena_, {NDEF_OK, 0}})
+
+// Create an empty arena over a caller-owned buffer.
+#define NDEF_ARENA_NEW(buf_, cap_) ((ndef_arena_t){(uint8_t*)(buf_), 0, (cap_)})
+
+// Minimum capacity of a heap-allocated output stream, to avoid reallocating for every byte.
+#define NDEF_OSTREAM_MIN_CAP 32
 
 // NDEF flag: Message begin; must be set for first entry in a message.
 #define NDEF_FLAG_MESSAGE_BEGIN    0x80
@@ -72,6 +160,11 @@ typedef enum {
     NDEF_POS_MIDDLE    = 0x00,
 } ndef_pos_t;
 
+// Get the position of the record at `index` in a message of `count` records.
+static inline ndef_pos_t ndef_pos_at(size_t index, size_t count) {
+    return (index == 0 ? NDEF_POS_START : NDEF_POS_MIDDLE) | (index + 1 == count ? NDEF_POS_END : NDEF_POS_MIDDLE);
+}
+
 // A decoded NDEF record.
 typedef struct {
     // Whether this is beginning, end, both or middle of a message.
@@ -82,26 +175,212 @@ typedef struct {
     size_t         type_len;
     // Type string.
     const char*    type;
+    // Length of ID; 0 if the record has no ID.
+    size_t         id_len;
+    // ID string.
+    const char*    id;
     // Length of payload.
     size_t         payload_len;
     // Payload data.
     const uint8_t* payload;
+    // Whether this is a chunk of a payload that continues in the next record.
+    bool           chunked;
+    // Whether the payload length was encoded in 4 bytes even though it is below 256; set by readers.
+    // Writers always use the short form when it fits, so this only matters to `ndef_sig_hash_record`.
+    bool           long_payload_len;
+    // Whether the ID length was encoded even though the ID is empty; set by readers like `long_payload_len`.
+    bool           empty_id_len;
 } ndef_record_t;
 
+// A reference to a range of bytes.
+typedef struct {
+    const uint8_t* data;
+    size_t         len;
+} ndef_slice_t;
+
+// Get the total length of some slices; `SIZE_MAX` if it does not fit a `size_t`.
+static inline size_t ndef_slices_len(const ndef_slice_t* slices, size_t slices_len) {
+    size_t len = 0;
+    for (size_t i = 0; i < slices_len; i++) {
+        if (__builtin_add_overflow(len, slices[i].len, &len)) {
+            return SIZE_MAX;
+        }
+    }
+    return len;
+}
+
+// Allocate `size` bytes from an arena.
+// Returns NULL if the arena is out of space.
+void* ndef_arena_alloc(ndef_arena_t* arena, size_t size);
+// Free all allocations made from an arena.
+static inline void ndef_arena_reset(ndef_arena_t* arena) {
+    arena->len = 0;
+}
+
+// Grow an output stream to hold at least `min_cap` bytes; the slow path of `ndef_ostream_reserve`.
+// Returns false if the memory could not be allocated or a fixed buffer is too small.
+bool             ndef_ostream_grow(ndef_ostream_t* arr, size_t min_cap);
 // Reserve additional capacity.
-bool ndef_ostream_reserve(ndef_ostream_t* arr, size_t min_cap);
+// Returns false if the memory could not be allocated or a fixed buffer is too small.
+NDEF_INLINE bool ndef_ostream_reserve(ndef_ostream_t* arr, size_t min_cap);
+// Reserve capacity for `extra` more bytes after the current length.
+// Returns false if the memory could not be allocated, a fixed buffer is too small or the length would overflow.
+NDEF_INLINE bool ndef_ostream_reserve_extra(ndef_ostream_t* arr, size_t extra);
 // Append one byte.
-bool ndef_ostream_push(ndef_ostream_t* arr, uint8_t value);
+NDEF_INLINE bool ndef_ostream_push(ndef_ostream_t* arr, uint8_t value);
 // Append multiple bytes.
-bool ndef_ostream_extend(ndef_ostream_t* arr, uint8_t* value, size_t value_len);
+NDEF_INLINE bool ndef_ostream_extend(ndef_ostream_t* arr, const uint8_t* value, size_t value_len);
+// Append the bytes of multiple slices, reserving space for all of them at once.
+NDEF_INLINE bool ndef_ostream_extend_slices(ndef_ostream_t* arr, const ndef_slice_t* slices, size_t slices_len);
+// Release the memory owned by an output stream and make it empty.
+// Caller-owned buffers are kept; arena memory is returned if it was the last allocation.
+void             ndef_ostream_free(ndef_ostream_t* arr);
 
 // Get the number of available bytes in `stream`.
 static inline size_t ndef_istream_available(const ndef_istream_t* stream) {
     return stream->len - stream->index;
 }
 
+// Record why a read from `stream` failed at `offset`.
+static inline void ndef_istream_fail(ndef_istream_t* stream, ndef_err_t err, size_t offset) {
+    stream->result = (ndef_result_t){err, offset};
+}
+
+// Record why a write to `stream` failed.
+static inline void ndef_ostream_fail(ndef_ostream_t* stream, ndef_err_t err) {
+    stream->result = (ndef_result_t){err, stream->len};
+}
+
+// Record that the data of `istream` ends within the record or TLV block at its index.
+static inline void ndef_istream_truncated(ndef_istream_t* istream) {
+    NDEF_STATS_FAIL(TRUNCATED);
+    ndef_istream_fail(istream, NDEF_ERR_TRUNCATED, istream->index);
+}
+
+// Rewind `istream` over a record that was read but could not be decoded, recording whether it was of another type.
+static inline void ndef_istream_reject(ndef_istream_t* istream, size_t record_len, bool type_matches) {
+    istream->index -= record_len;
+    ndef_istream_fail(istream, type_matches ? NDEF_ERR_PAYLOAD : NDEF_ERR_TYPE, istream->index);
+}
+
+// Get a short name for an error, for logging.
+const char* ndef_err_name(ndef_err_t err);
+
+// Get the encoded size of an NDEF record header: flags, type length, payload length, ID length, type and ID.
+// The ID length field is only present if `id_len` is not 0.
+static inline size_t ndef_record_header_size(size_t type_len, size_t id_len, size_t payload_len) {
+    return 2 + (payload_len < 256 ? 1 : 4) + (id_len ? 1 + id_len : 0) + type_len;
+}
+
+// Get the encoded size of an NDEF record including its payload.
+static inline size_t ndef_record_encoded_size(size_t type_len, size_t id_len, size_t payload_len) {
+    return ndef_record_header_size(type_len, id_len, payload_len) + payload_len;
+}
+
+// Try to write the header of an NDEF record described by `record`; its payload is not written.
+// Capacity for the payload is reserved along with the header.
+NDEF_INLINE bool ndef_write_header(ndef_ostream_t* data_out, const ndef_record_t* record);
+// Try to write an NDEF record described by `record` including its payload.
+NDEF_INLINE bool ndef_write_raw(ndef_ostream_t* data_out, const ndef_record_t* record);
+// Try to write an NDEF record described by `record` whose payload is the concatenation of `slices`.
+// `record->payload` and `record->payload_len` are ignored; the header is written once for the total length and each
+// slice is copied straight into the output.
+bool ndef_write_raw_slices(ndef_ostream_t* data_out, const ndef_record_t* record, const ndef_slice_t* slices,
+                           size_t slices_len);
 // Try to write an NDEF record without its payload.
-bool ndef_write_record(ndef_ostream_t* data_out, ndef_tnf_t tnf, const char* type, ndef_pos_t pos, size_t payload_len);
+// Capacity for the payload is reserved along with the header.
+NDEF_INLINE bool ndef_write_record(ndef_ostream_t* data_out, ndef_tnf_t tnf, const char* type, ndef_pos_t pos,
+                                   size_t payload_len);
+
+// Get the encoded size of an NDEF record whose payload is split into chunks of at most `chunk_size` bytes.
+// Returns 0 if `chunk_size` is 0.
+size_t ndef_chunked_encoded_size(size_t type_len, size_t id_len, size_t payload_len, size_t chunk_size);
+// Try to write an NDEF record described by `record`, splitting its payload into chunks of at most `chunk_size` bytes.
+// The first chunk carries the type and ID; the others have an empty type with `NDEF_TNF_UNCHANGED`.
+bool ndef_write_chunked(ndef_ostream_t* data_out, const ndef_record_t* record, size_t chunk_size);
+
+// Begin writing an NDEF record whose payload length is not known in advance, such as a nested message.
+// The payload is written directly after this returns; `ndef_write_record_end` then fills in the length.
+// Stores the offset of the record in `mark_out`.
+bool ndef_write_record_begin(ndef_ostream_t* data_out, ndef_tnf_t tnf, const char* type, ndef_pos_t pos,
+                             size_t* mark_out);
+// Finish writing an NDEF record started with `ndef_write_record_begin`.
+// The payload is moved down to make a short record if it fits one.
+// Returns how long the record was written, or 0 on error.
+size_t ndef_write_record_end(ndef_ostream_t* data_out, size_t mark);
 // Try to read an NDEF record.
+// On success, `istream` is advanced past the record.
 // Returns how long the record was read, or 0 on error.
-size_t ndef_read_record(ndef_istream_t* istream, ndef_record_t* well_known_out);
+NDEF_INLINE size_t ndef_read_record(ndef_istream_t* istream, ndef_record_t* well_known_out);
+
+// Try to read an NDEF record that may be split into chunks.
+// The chunks of the payload are stored in `slices`, which refer to the blob passed; `slices` may be NULL to only count them.
+// `record_out` gets the type of the first chunk, the total payload length and a NULL payload if there is more than one chunk.
+// On success, `istream` is advanced past the last chunk.
+// Returns how long the chunks were read, or 0 on error or if there are more than `slices_cap` chunks.
+size_t ndef_read_chunked(ndef_istream_t* istream, ndef_record_t* record_out, ndef_slice_t* slices, size_t slices_cap,
+                         size_t* slices_len_out);
+// Try to read an NDEF record that may be split into chunks, reassembling the payload in `payload_out`.
+// `record_out->payload` refers to the reassembled payload.
+// On success, `istream` is advanced past the last chunk.
+// Returns how long the chunks were read, or 0 on error.
+size_t ndef_read_chunked_into(ndef_istream_t* istream, ndef_record_t* record_out, ndef_ostream_t* payload_out);
+
+// Whether the types of a type name format are compared case-insensitively, as MIME and external types are.
+static inline bool ndef_tnf_folds_case(ndef_tnf_t tnf) {
+    return tnf == NDEF_TNF_MIME_MEDIA || tnf == NDEF_TNF_EXTERNAL_TYPE;
+}
+
+// Fold an ASCII upper-case letter to lower case.
+static inline uint8_t ndef_ascii_lower(uint8_t c) {
+    return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+// Whether two types of `type_len` bytes are equal, ignoring ASCII case.
+static inline bool ndef_type_equal_nocase(const char* a, const char* b, size_t type_len) {
+    for (size_t i = 0; i < type_len; i++) {
+        if (ndef_ascii_lower(a[i]) != ndef_ascii_lower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whether a record has a given type name format and type.
+// MIME and external types are compared case-insensitively.
+static inline bool ndef_record_is_type(const ndef_record_t* record, ndef_tnf_t tnf, const char* type, size_t type_len) {
+    if (record->tnf != tnf || record->type_len != type_len) {
+        return false;
+    } else if (ndef_tnf_folds_case(tnf)) {
+        return ndef_type_equal_nocase(record->type, type, type_len);
+    }
+    return memcmp(record->type, type, type_len) == 0;
+}
+
+// An iterator over the records of an NDEF message.
+typedef struct {
+    // The stream to read records from.
+    ndef_istream_t* istream;
+    // Number of records read so far.
+    size_t          count;
+    // Whether the last record of the message has been read.
+    bool            ended;
+} ndef_message_iter_t;
+
+// Create an iterator over the NDEF message at the current position of `istream_`.
+#define NDEF_MESSAGE_ITER_NEW(istream_) ((ndef_message_iter_t){istream_, 0, false})
+
+// Read the next record of an NDEF message, checking that only the first record has the message begin flag.
+// The payload is not decoded; see `ndef_decd_decode` in "ndef.h".
+// Returns how long the record was read, or 0 at the end of the message or on error.
+// Use `ndef_message_done` or the `NDEF_ERR_END` result of the stream to tell the two apart.
+size_t ndef_message_next(ndef_message_iter_t* iter, ndef_record_t* record_out);
+
+// Whether an iterator has read the last record of its message.
+static inline bool ndef_message_done(const ndef_message_iter_t* iter) {
+    return iter->ended;
+}
+
+#if NDEF_HEADER_ONLY
+#include "common_inline.h"
+#endif
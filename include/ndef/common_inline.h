@@ -0,0 +1,174 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Definitions of the record codec primitives declared in "common.h".
+// With `NDEF_HEADER_ONLY`, every file that includes "common.h" gets them as `static inline`; otherwise they are
+// compiled once, in common.c.
+
+#pragma once
+
+#include "common.h"
+
+// Reserve additional capacity.
+NDEF_INLINE bool ndef_ostream_reserve(ndef_ostream_t* arr, size_t min_cap) {
+    // The capacity is never below the length, so this also covers `min_cap` being below the length.
+    if (arr->cap >= min_cap) {
+        return true;
+    }
+    return ndef_ostream_grow(arr, min_cap);
+}
+
+// Reserve capacity for `extra` more bytes after the current length.
+NDEF_INLINE bool ndef_ostream_reserve_extra(ndef_ostream_t* arr, size_t extra) {
+    // A length past `SIZE_MAX` would wrap around and seem to fit.
+    if (extra > SIZE_MAX - arr->len) {
+        ndef_ostream_fail(arr, arr->mode == NDEF_OSTREAM_MODE_FIXED ? NDEF_ERR_NO_SPACE : NDEF_ERR_NO_MEM);
+        return false;
+    }
+    return ndef_ostream_reserve(arr, arr->len + extra);
+}
+
+// Append one byte.
+NDEF_INLINE bool ndef_ostream_push(ndef_ostream_t* arr, uint8_t value) {
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve_extra(arr, 1));
+    arr->data[arr->len++] = value;
+    return true;
+}
+
+// Append multiple bytes.
+NDEF_INLINE bool ndef_ostream_extend(ndef_ostream_t* arr, const uint8_t* value, size_t value_len) {
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve_extra(arr, value_len));
+    if (value_len) {
+        memcpy(arr->data + arr->len, value, value_len);
+    }
+    arr->len += value_len;
+    return true;
+}
+
+// Append the bytes of multiple slices, reserving space for all of them at once.
+NDEF_INLINE bool ndef_ostream_extend_slices(ndef_ostream_t* arr, const ndef_slice_t* slices, size_t slices_len) {
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve_extra(arr, ndef_slices_len(slices, slices_len)));
+    for (size_t i = 0; i < slices_len; i++) {
+        if (slices[i].len) {
+            memcpy(arr->data + arr->len, slices[i].data, slices[i].len);
+        }
+        arr->len += slices[i].len;
+    }
+    return true;
+}
+
+// Try to write the header of an NDEF record described by `record`; its payload is not written.
+NDEF_INLINE bool ndef_write_header(ndef_ostream_t* data_out, const ndef_record_t* record) {
+    NDEF_STATS_FN(WRITE_HEADER);
+    size_t type_len     = record->type_len;
+    size_t id_len       = record->id_len;
+    size_t payload_len  = record->payload_len;
+    size_t encoded_size = ndef_record_encoded_size(type_len, id_len, payload_len);
+    // With a 32-bit `size_t`, the encoded size itself can wrap around.
+    NDEF_RETURN_ON_FALSE(type_len <= 255 && id_len <= 255 && payload_len <= UINT32_MAX && encoded_size >= payload_len,
+                         ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve_extra(data_out, encoded_size));
+
+    // The whole header fits in the capacity just reserved, so it is stored without further checks.
+    bool     is_short = payload_len < 256;
+    uint8_t  flags    = record->pos + is_short * NDEF_FLAG_SHORT_RECORD + record->chunked * NDEF_FLAG_CHUNKED_RECORD +
+                        !!id_len * NDEF_FLAG_ID_LENGTH + record->tnf;
+    uint8_t* out      = data_out->data + data_out->len;
+    *out++            = flags;
+    *out++            = type_len;
+    if (is_short) {
+        *out++ = payload_len;
+    } else {
+        *out++ = payload_len >> 24;
+        *out++ = payload_len >> 16;
+        *out++ = payload_len >> 8;
+        *out++ = payload_len;
+    }
+    if (id_len) {
+        *out++ = id_len;
+    }
+    if (type_len) {
+        memcpy(out, record->type, type_len);
+        out += type_len;
+    }
+    if (id_len) {
+        memcpy(out, record->id, id_len);
+        out += id_len;
+    }
+    data_out->len = out - data_out->data;
+    NDEF_STATS_ADD(bytes_encoded, encoded_size);
+    return true;
+}
+
+// Try to write an NDEF record described by `record` including its payload.
+NDEF_INLINE bool ndef_write_raw(ndef_ostream_t* data_out, const ndef_record_t* record) {
+    NDEF_RETURN_ON_FALSE(ndef_write_header(data_out, record));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, record->payload, record->payload_len));
+    return true;
+}
+
+// Try to write an NDEF record without its payload.
+NDEF_INLINE bool ndef_write_record(ndef_ostream_t* data_out, ndef_tnf_t tnf, const char* type, ndef_pos_t pos,
+                                   size_t payload_len) {
+    ndef_record_t record = {
+        .pos         = pos,
+        .tnf         = tnf,
+        .type_len    = type ? strlen(type) : 0,
+        .type        = type,
+        .payload_len = payload_len,
+    };
+    return ndef_write_header(data_out, &record);
+}
+
+// Try to read an NDEF record.
+// On success, `istream` is advanced past the record.
+// Returns how long the record was read, or 0 on error.
+NDEF_INLINE size_t ndef_read_record(ndef_istream_t* istream, ndef_record_t* well_known_out) {
+    NDEF_STATS_FN(READ_RECORD);
+    size_t available = ndef_istream_available(istream);
+    NDEF_RETURN_ON_FALSE(available >= 3, ndef_istream_truncated(istream););
+    size_t  index            = istream->index;
+    uint8_t flags            = istream->data[index++];
+    bool    is_short         = flags & NDEF_FLAG_SHORT_RECORD;
+    well_known_out->pos      = flags & (NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_MESSAGE_END);
+    well_known_out->tnf      = flags & NDEF_FLAG_TYPE_NAME_FORMAT;
+    well_known_out->chunked  = flags & NDEF_FLAG_CHUNKED_RECORD;
+    well_known_out->type_len = istream->data[index++];
+    if (is_short) {
+        well_known_out->payload_len = istream->data[index++];
+    } else {
+        NDEF_RETURN_ON_FALSE(available >= 6, ndef_istream_truncated(istream););
+        uint32_t tmp  = 0;
+        tmp          |= (uint32_t)istream->data[index++] << 24;
+        tmp          |= (uint32_t)istream->data[index++] << 16;
+        tmp          |= (uint32_t)istream->data[index++] << 8;
+        tmp          |= (uint32_t)istream->data[index++];
+
+        well_known_out->payload_len = tmp;
+    }
+    well_known_out->long_payload_len = !is_short && well_known_out->payload_len < 256;
+    if (flags & NDEF_FLAG_ID_LENGTH) {
+        NDEF_RETURN_ON_FALSE(index < istream->len, ndef_istream_truncated(istream););
+        well_known_out->id_len = istream->data[index++];
+    } else {
+        well_known_out->id_len = 0;
+    }
+    well_known_out->empty_id_len = (flags & NDEF_FLAG_ID_LENGTH) && !well_known_out->id_len;
+    available -= index - istream->index;
+    NDEF_RETURN_ON_FALSE(available >= well_known_out->type_len + well_known_out->id_len,
+                         ndef_istream_truncated(istream););
+    available -= well_known_out->type_len + well_known_out->id_len;
+    NDEF_RETURN_ON_FALSE(available >= well_known_out->payload_len, ndef_istream_truncated(istream););
+    well_known_out->type     = (const char*)(istream->data + index);
+    index                   += well_known_out->type_len;
+    well_known_out->id       = (const char*)(istream->data + index);
+    index                   += well_known_out->id_len;
+    well_known_out->payload  = istream->data + index;
+    index                   += well_known_out->payload_len;
+
+    size_t record_len = index - istream->index;
+    istream->index    = index;
+    NDEF_STATS_ADD(bytes_decoded, record_len);
+    return record_len;
+}
@@ -0,0 +1,42 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common.h"
+
+// A range of bytes that changed between two encodings.
+typedef struct {
+    // Offset of the first changed byte.
+    size_t offset;
+    // Number of changed bytes.
+    size_t len;
+} ndef_diff_range_t;
+
+// Find the ranges of `new_data` that differ from `old_data`, so that only those need to be written to a tag.
+// `new_data` starts at `base_offset` in tag memory, e.g. after the capability container and TLV header of a Type 2
+// tag. If `block_size` is more than 1, ranges are widened to whole blocks of tag memory, e.g. 4 for Type 2 tag pages;
+// they are clipped to `new_data`, so a range at its start or end may cover only part of a block.
+// Offsets are relative to the start of `new_data`.
+// Bytes past the end of `old_data` count as changed; bytes of `old_data` past the end of `new_data` are ignored.
+// Touching ranges are merged. If more than `cap` ranges are needed, the last one extends to the end of `new_data`.
+// `cap` must be at least 1. Returns the number of ranges stored in `ranges_out`.
+size_t ndef_diff_at(const uint8_t* old_data, size_t old_len, const uint8_t* new_data, size_t new_len,
+                    size_t base_offset, size_t block_size, ndef_diff_range_t* ranges_out, size_t cap);
+
+// Find the ranges of `new_data` that differ from `old_data`, with blocks counted from the start of `new_data`,
+// such as a whole tag memory image; see `ndef_diff_at`.
+static inline size_t ndef_diff(const uint8_t* old_data, size_t old_len, const uint8_t* new_data, size_t new_len,
+                               size_t block_size, ndef_diff_range_t* ranges_out, size_t cap) {
+    return ndef_diff_at(old_data, old_len, new_data, new_len, 0, block_size, ranges_out, cap);
+}
+
+// Get the total number of bytes covered by some ranges.
+static inline size_t ndef_diff_len(const ndef_diff_range_t* ranges, size_t ranges_len) {
+    size_t len = 0;
+    for (size_t i = 0; i < ranges_len; i++) {
+        len += ranges[i].len;
+    }
+    return len;
+}
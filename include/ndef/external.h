@@ -0,0 +1,94 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <string.h>
+#include "common.h"
+
+// External type of an Android Application Record.
+#define NDEF_AAR_TYPE "android.com:pkg"
+
+// Data for an NDEF external type record.
+typedef struct {
+    // Whether this is beginning, end, both or middle of a message.
+    // Set by `ndef_external_read`, ignored by `ndef_external_write`.
+    ndef_pos_t     pos;
+    // External type name, `domain:type`.
+    const char*    type;
+    // External type name length.
+    size_t         type_len;
+    // Payload data.
+    const uint8_t* payload;
+    // Payload length.
+    size_t         payload_len;
+} ndef_external_t;
+
+// Data for an Android Application Record.
+typedef struct {
+    // Whether this is beginning, end, both or middle of a message.
+    // Set by `ndef_aar_read`, ignored by `ndef_aar_write`.
+    ndef_pos_t  pos;
+    // Package name of the application.
+    const char* package;
+    // Package name length.
+    size_t      package_len;
+} ndef_aar_t;
+
+// Get the payload size of an NDEF external type record.
+static inline size_t ndef_external_payload_size(ndef_external_t external) {
+    return external.payload_len;
+}
+
+// Get the encoded size of an NDEF external type record.
+static inline size_t ndef_external_encoded_size(ndef_external_t external) {
+    return ndef_record_encoded_size(external.type_len, 0, ndef_external_payload_size(external));
+}
+
+// Get the payload size of an Android Application Record.
+static inline size_t ndef_aar_payload_size(ndef_aar_t aar) {
+    return aar.package_len;
+}
+
+// Get the encoded size of an Android Application Record.
+static inline size_t ndef_aar_encoded_size(ndef_aar_t aar) {
+    return ndef_record_encoded_size(sizeof(NDEF_AAR_TYPE) - 1, 0, ndef_aar_payload_size(aar));
+}
+
+// Get the length of the domain part of an external type name, or 0 if it has no `:` separator.
+static inline size_t ndef_external_domain_len(const ndef_external_t* external) {
+    const char* sep = memchr(external->type, ':', external->type_len);
+    return sep ? sep - external->type : 0;
+}
+
+// Decode an NDEF external type record that has already been read.
+// The type and payload are a reference to the record; nothing is copied.
+bool   ndef_external_decode(const ndef_record_t* record, ndef_external_t* external_out);
+// Read an NDEF external type record.
+// The type and payload are a reference to the blob passed.
+// On success, `istream` is advanced past the record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_external_read(ndef_istream_t* istream, ndef_external_t* external_out);
+// Write an NDEF external type record.
+bool   ndef_external_write(ndef_ostream_t* data_out, ndef_external_t external, ndef_pos_t pos);
+// Write an NDEF external type record whose payload is the concatenation of `slices`.
+// The pieces are copied straight into the output, without assembling the payload first.
+bool   ndef_external_write_slices(ndef_ostream_t* data_out, const char* type, size_t type_len,
+                                  const ndef_slice_t* slices, size_t slices_len, ndef_pos_t pos);
+
+// Decode an Android Application Record that has already been read.
+// The package name is a reference to the record's payload.
+bool   ndef_aar_decode(const ndef_record_t* record, ndef_aar_t* aar_out);
+// Read an Android Application Record.
+// The package name is a reference to the blob passed.
+// On success, `istream` is advanced past the record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_aar_read(ndef_istream_t* istream, ndef_aar_t* aar_out);
+// Write an Android Application Record.
+bool   ndef_aar_write(ndef_ostream_t* data_out, ndef_aar_t aar, ndef_pos_t pos);
+
+// Write an Android Application Record from a C-string package name.
+static inline bool ndef_aar_write_cstr(ndef_ostream_t* data_out, const char* package, ndef_pos_t pos) {
+    return ndef_aar_write(data_out, (ndef_aar_t){.package = package, .package_len = strlen(package)}, pos);
+}
@@ -0,0 +1,122 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common.h"
+
+// Version of the Connection Handover protocol written by `ndef_handover_write`; 1.5.
+#define NDEF_HANDOVER_VERSION 0x15
+
+// Power state of an alternative carrier.
+typedef enum {
+    NDEF_HANDOVER_CPS_INACTIVE   = 0x00,
+    NDEF_HANDOVER_CPS_ACTIVE     = 0x01,
+    NDEF_HANDOVER_CPS_ACTIVATING = 0x02,
+    NDEF_HANDOVER_CPS_UNKNOWN    = 0x03,
+} ndef_handover_cps_t;
+
+// Reason in the error record of a Handover Select record.
+typedef enum {
+    // No error; the error record is omitted.
+    NDEF_HANDOVER_ERR_NONE         = 0x00,
+    // Temporarily out of memory; the data is the time to wait before retrying in milliseconds, one byte.
+    NDEF_HANDOVER_ERR_TEMP_MEMORY  = 0x01,
+    // Permanently out of memory; the data is the largest request that can be handled, 32 bits.
+    NDEF_HANDOVER_ERR_PERM_MEMORY  = 0x02,
+    // The carrier is temporarily unusable; the data is the time to wait before retrying in milliseconds, one byte.
+    NDEF_HANDOVER_ERR_CARRIER_TEMP = 0x03,
+} ndef_handover_err_t;
+
+// Data for an Alternative Carrier record, the inner record of a handover record that refers to a carrier.
+typedef struct {
+    // Power state of the carrier.
+    ndef_handover_cps_t cps;
+    // ID of the carrier configuration record in the handover message.
+    const char*         carrier_ref;
+    // Carrier reference length.
+    size_t              carrier_ref_len;
+    // Number of auxiliary data references; at most 255.
+    size_t              aux_count;
+    // The IDs of auxiliary data records, each preceded by its length as one byte; see `ndef_handover_next_aux`.
+    const uint8_t*      aux_refs;
+    // Length of `aux_refs`.
+    size_t              aux_refs_len;
+} ndef_handover_ac_t;
+
+// Data for an NDEF Handover Select or Handover Request record.
+// In a handover message, the carrier configuration records follow this record, with the IDs that the alternative
+// carriers refer to; see `ndef_handover_find_config`.
+typedef struct {
+    // Whether this is beginning, end, both or middle of a message.
+    // Set by `ndef_handover_read`, ignored by `ndef_handover_write`.
+    ndef_pos_t                pos;
+    // Whether this is a Handover Request instead of a Handover Select record.
+    bool                      request;
+    // Protocol version, major version in the high nibble; `NDEF_HANDOVER_VERSION` is written if 0.
+    uint8_t                   version;
+    // Whether `collision` is present; required in a Handover Request, which `ndef_handover_write` refuses without it.
+    bool                      has_collision;
+    // Random number of the collision resolution record.
+    uint16_t                  collision;
+    // Reason of the error record of a Handover Select record; the record is omitted if `NDEF_HANDOVER_ERR_NONE`.
+    ndef_handover_err_t       err;
+    // Data of the error record.
+    const uint8_t*            err_data;
+    // Error data length.
+    size_t                    err_data_len;
+    // The alternative carriers, in order of preference.
+    // Set to NULL by `ndef_handover_read`, which only counts them; list them with `ndef_handover_next_carrier`.
+    const ndef_handover_ac_t* carriers;
+    // Number of alternative carriers.
+    size_t                    carriers_len;
+    // The inner NDEF message, used by `ndef_handover_next_carrier`.
+    // Set by `ndef_handover_read`; written as is by `ndef_handover_write` if `carriers` is NULL.
+    const uint8_t*            records;
+    // Inner NDEF message length.
+    size_t                    records_len;
+} ndef_handover_t;
+
+// Get the payload size of an Alternative Carrier record.
+static inline size_t ndef_handover_ac_payload_size(ndef_handover_ac_t ac) {
+    return 3 + ac.carrier_ref_len + ac.aux_refs_len;
+}
+
+// Get the payload size of an NDEF handover record.
+size_t ndef_handover_payload_size(const ndef_handover_t handover);
+// Get the encoded size of an NDEF handover record.
+static inline size_t ndef_handover_encoded_size(const ndef_handover_t handover) {
+    return ndef_record_encoded_size(2, 0, ndef_handover_payload_size(handover));
+}
+
+// Decode the payload of an Alternative Carrier record that has already been read.
+// The references are a reference to the record's payload.
+bool   ndef_handover_ac_decode(const ndef_record_t* record, ndef_handover_ac_t* ac_out);
+// Get the next auxiliary data reference of an Alternative Carrier.
+// `offset` must be 0 for the first call and is advanced past the reference found.
+// Returns false if there are no more references.
+bool   ndef_handover_next_aux(const ndef_handover_ac_t* ac, size_t* offset, const char** ref_out, size_t* ref_len_out);
+
+// Decode the payload of an NDEF Handover Select or Handover Request record that has already been read.
+// The inner records are checked and the alternative carriers counted; nothing is copied or allocated.
+bool   ndef_handover_decode(const ndef_record_t* record, ndef_handover_t* handover_out);
+// Read an NDEF Handover Select or Handover Request record.
+// The references within are a reference to the blob passed.
+// On success, `istream` is advanced past the record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_handover_read(ndef_istream_t* istream, ndef_handover_t* handover_out);
+// Get the next alternative carrier of a handover record read by `ndef_handover_read`.
+// `offset` must be 0 for the first call and is advanced past the carrier found.
+// Returns false if there are no more carriers.
+bool   ndef_handover_next_carrier(const ndef_handover_t* handover, size_t* offset, ndef_handover_ac_t* ac_out);
+// Find the carrier configuration record that an alternative carrier refers to in the NDEF message `message`.
+// The record is a reference to `message`; its payload can be decoded with e.g. `ndef_ble_oob_decode`.
+// Returns false if the message has no record with that ID.
+bool   ndef_handover_find_config(const uint8_t* message, size_t message_len, const ndef_handover_ac_t* ac,
+                                 ndef_record_t* config_out);
+
+// Write an NDEF Handover Select or Handover Request record.
+// The inner records are written directly into `ostream` without an intermediate buffer.
+// Returns how long the record was written, or 0 on error.
+size_t ndef_handover_write(ndef_ostream_t* ostream, const ndef_handover_t handover, ndef_pos_t pos);
@@ -0,0 +1,47 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common.h"
+
+// An entry of an NDEF message index.
+typedef struct {
+    // Hash of the ID or type of the record.
+    uint32_t hash;
+    // Offset of the record in the message.
+    uint32_t offset;
+} ndef_index_entry_t;
+
+// An index of the records in an NDEF message by ID and by type.
+// Lookups are a binary search over hashes followed by one comparison with the record itself.
+typedef struct {
+    // The indexed message.
+    const uint8_t*      data;
+    // Indexed message length.
+    size_t              len;
+    // Entries for records with an ID, sorted by hash.
+    ndef_index_entry_t* by_id;
+    // Number of entries in `by_id`.
+    size_t              by_id_len;
+    // Entries for every record, sorted by hash of type name format and type.
+    ndef_index_entry_t* by_type;
+    // Number of entries in `by_type`.
+    size_t              by_type_len;
+} ndef_index_t;
+
+// Build an index of an NDEF message in one pass.
+// `entries` must have room for two entries per record; the index refers to it and to `data`.
+// Chunked records are indexed by their first chunk.
+// Returns false if the message is malformed or there are too many records.
+bool ndef_index_build(ndef_index_t* index, const uint8_t* data, size_t len, ndef_index_entry_t* entries,
+                      size_t entries_cap);
+
+// Find the record with a given ID.
+// Returns how long the record is, or 0 if it was not found.
+size_t ndef_index_find_id(const ndef_index_t* index, const char* id, size_t id_len, ndef_record_t* record_out);
+// Find the `nth` record, counting from 0 in message order, with a given type name format and type.
+// Returns how long the record is, or 0 if it was not found.
+size_t ndef_index_find_type(const ndef_index_t* index, ndef_tnf_t tnf, const char* type, size_t type_len, size_t nth,
+                            ndef_record_t* record_out);
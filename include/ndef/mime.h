@@ -0,0 +1,66 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <string.h>
+#include "common.h"
+
+// Data for an NDEF MIME media record, such as a vCard, a JSON document or a binary blob.
+typedef struct {
+    // Whether this is beginning, end, both or middle of a message.
+    // Set by `ndef_mime_read`, ignored by `ndef_mime_write`.
+    ndef_pos_t     pos;
+    // MIME type, e.g. `text/vcard`.
+    const char*    type;
+    // MIME type length.
+    size_t         type_len;
+    // Payload data.
+    const uint8_t* payload;
+    // Payload length.
+    size_t         payload_len;
+} ndef_mime_t;
+
+// Get the payload size of an NDEF MIME record.
+static inline size_t ndef_mime_payload_size(ndef_mime_t mime) {
+    return mime.payload_len;
+}
+
+// Get the encoded size of an NDEF MIME record.
+static inline size_t ndef_mime_encoded_size(ndef_mime_t mime) {
+    return ndef_record_encoded_size(mime.type_len, 0, ndef_mime_payload_size(mime));
+}
+
+// Whether a MIME record has a certain MIME type; MIME types are compared case-insensitively.
+static inline bool ndef_mime_is_type(const ndef_mime_t* mime, const char* type) {
+    size_t type_len = strlen(type);
+    return mime->type_len == type_len && ndef_type_equal_nocase(mime->type, type, type_len);
+}
+
+// Decode an NDEF MIME record that has already been read.
+// The type and payload are a reference to the record; nothing is copied.
+bool   ndef_mime_decode(const ndef_record_t* record, ndef_mime_t* mime_out);
+// Read an NDEF MIME record.
+// The type and payload are a reference to the blob passed.
+// On success, `istream` is advanced past the record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_mime_read(ndef_istream_t* istream, ndef_mime_t* mime_out);
+// Write an NDEF MIME record.
+bool   ndef_mime_write(ndef_ostream_t* data_out, ndef_mime_t mime, ndef_pos_t pos);
+// Write an NDEF MIME record whose payload is the concatenation of `slices`.
+// The pieces are copied straight into the output, without assembling the payload first.
+bool   ndef_mime_write_slices(ndef_ostream_t* data_out, const char* type, size_t type_len, const ndef_slice_t* slices,
+                              size_t slices_len, ndef_pos_t pos);
+
+// Write an NDEF MIME record with a C-string MIME type.
+static inline bool ndef_mime_write_cstr(ndef_ostream_t* data_out, const char* type, const uint8_t* payload,
+                                        size_t payload_len, ndef_pos_t pos) {
+    ndef_mime_t mime = {
+        .type        = type,
+        .type_len    = strlen(type),
+        .payload     = payload,
+        .payload_len = payload_len,
+    };
+    return ndef_mime_write(data_out, mime, pos);
+}
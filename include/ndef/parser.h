@@ -0,0 +1,88 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common.h"
+
+// Called when the header and type of a record have been parsed, before its payload arrives.
+// `record->payload` is NULL; `record->payload_len` is the length that will follow.
+// Return false to skip the payload instead of buffering it; the record is then reported with a NULL payload.
+typedef bool (*ndef_parser_header_cb_t)(void* cookie, const ndef_record_t* record);
+// Called when a record is complete.
+// The record refers to memory owned by the parser or passed to `ndef_parser_feed` and is only valid during the call.
+// Return false to stop parsing.
+typedef bool (*ndef_parser_record_cb_t)(void* cookie, const ndef_record_t* record);
+
+// State of an incremental NDEF parser.
+typedef enum {
+    // Reading the fixed part of a record header.
+    NDEF_PARSER_STATE_HEADER,
+    // Reading the type and ID of a record.
+    NDEF_PARSER_STATE_TYPE,
+    // Reading the payload of a record.
+    NDEF_PARSER_STATE_PAYLOAD,
+    // The last record of the message has been parsed.
+    NDEF_PARSER_STATE_DONE,
+    // The data was malformed, did not fit the buffer or a callback stopped parsing.
+    NDEF_PARSER_STATE_ERROR,
+} ndef_parser_state_t;
+
+// An incremental NDEF message parser that accepts data in chunks of any size.
+typedef struct {
+    // Current state.
+    ndef_parser_state_t     state;
+    // Holds the type, ID and payload of a record that spans multiple chunks.
+    ndef_ostream_t          buffer;
+    // Largest payload length accepted.
+    size_t                  max_payload_len;
+    // Fixed part of the current record header.
+    uint8_t                 header[7];
+    // Number of header bytes received.
+    size_t                  header_have;
+    // Number of header bytes expected.
+    size_t                  header_need;
+    // Bytes still expected in the current state.
+    size_t                  need;
+    // Whether the payload of the current record is skipped.
+    bool                    skip_payload;
+    // The record being parsed.
+    ndef_record_t           record;
+    // Number of records parsed.
+    size_t                  count;
+    // Number of bytes consumed.
+    size_t                  offset;
+    // Why parsing failed, if it did; the offset is the number of bytes consumed before the failure.
+    ndef_result_t           result;
+    // Optional callback for record headers.
+    ndef_parser_header_cb_t on_header;
+    // Callback for complete records.
+    ndef_parser_record_cb_t on_record;
+    // Passed to the callbacks.
+    void*                   cookie;
+} ndef_parser_t;
+
+// Initialize a parser that buffers records spanning multiple chunks in `buffer`.
+// `buffer` may be a fixed or arena stream to parse without heap allocations.
+// Records with a payload longer than `max_payload_len` fail with `NDEF_ERR_PAYLOAD` as soon as their header is
+// parsed, before any memory is reserved for them; pass `SIZE_MAX` to accept any length.
+void ndef_parser_init(ndef_parser_t* parser, ndef_ostream_t buffer, size_t max_payload_len,
+                      ndef_parser_header_cb_t on_header, ndef_parser_record_cb_t on_record, void* cookie);
+// Release the buffer of a parser.
+void ndef_parser_free(ndef_parser_t* parser);
+
+// Feed a chunk of data to the parser, calling the callbacks for every record completed by it.
+// Records that lie entirely within the chunk are reported without copying.
+// Bytes after the end of the message are not consumed; see `parser->offset`.
+// Returns false if the data is malformed, does not fit the buffer or a callback stopped parsing; see `parser->result`.
+bool ndef_parser_feed(ndef_parser_t* parser, const uint8_t* data, size_t len);
+
+// Get how many more bytes the parser needs to complete the current record, or its header if that is incomplete.
+// Returns 0 once the message is complete or on error.
+size_t ndef_parser_needed(const ndef_parser_t* parser);
+
+// Whether the parser has parsed the last record of the message.
+static inline bool ndef_parser_done(const ndef_parser_t* parser) {
+    return parser->state == NDEF_PARSER_STATE_DONE;
+}
@@ -0,0 +1,49 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common.h"
+
+// An entry of a record type registry.
+typedef struct {
+    // Hash of the type name format and type.
+    uint32_t    hash;
+    // Type name format.
+    ndef_tnf_t  tnf;
+    // Type string; not copied, so it must outlive the registry.
+    const char* type;
+    // Length of type.
+    size_t      type_len;
+    // The registered data; NULL for an empty slot.
+    const void* value;
+} ndef_registry_entry_t;
+
+// A table that maps record types to application data, such as handlers for application-defined external types.
+// It uses open addressing over caller-provided storage, so lookups take one hash and usually one comparison.
+// MIME and external types are matched case-insensitively, as their specifications require.
+typedef struct {
+    // Storage for the entries.
+    ndef_registry_entry_t* entries;
+    // Number of entries in `entries`; a power of two.
+    size_t                 cap;
+    // Number of registered types.
+    size_t                 len;
+} ndef_registry_t;
+
+// Initialize an empty registry in `entries`, of which there must be a power of two.
+void        ndef_registry_init(ndef_registry_t* registry, ndef_registry_entry_t* entries, size_t cap);
+// Register `value` for a record type, replacing the value registered before for the same type.
+// Returns false if `value` is NULL or the registry is three quarters full; a registry always keeps one slot free.
+bool        ndef_registry_add(ndef_registry_t* registry, ndef_tnf_t tnf, const char* type, size_t type_len,
+                              const void* value);
+// Find the value registered for a record type.
+// Returns NULL if the type is not registered.
+const void* ndef_registry_find(const ndef_registry_t* registry, ndef_tnf_t tnf, const char* type, size_t type_len);
+
+// Find the value registered for the type of a record.
+// Returns NULL if the type is not registered.
+static inline const void* ndef_registry_find_record(const ndef_registry_t* registry, const ndef_record_t* record) {
+    return ndef_registry_find(registry, record->tnf, record->type, record->type_len);
+}
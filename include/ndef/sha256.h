@@ -0,0 +1,49 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Whether hashing uses mbedTLS instead of the built-in software implementation.
+// Defaults to mbedTLS on ESP-IDF, where it may use the SHA accelerator; define as 0 or 1 when building to override.
+#ifndef NDEF_CRYPTO_MBEDTLS
+#ifdef ESP_PLATFORM
+#define NDEF_CRYPTO_MBEDTLS 1
+#else
+#define NDEF_CRYPTO_MBEDTLS 0
+#endif
+#endif
+
+#if NDEF_CRYPTO_MBEDTLS
+#include "mbedtls/sha256.h"
+#endif
+
+// Length of a SHA-256 digest in bytes.
+#define NDEF_SHA256_LEN 32
+
+// State of an incremental SHA-256 hash.
+typedef struct {
+#if NDEF_CRYPTO_MBEDTLS
+    mbedtls_sha256_context mbedtls;
+#else
+    // Intermediate hash value.
+    uint32_t state[8];
+    // Number of bytes hashed so far.
+    uint64_t len;
+    // Bytes of the current block that have not been compressed yet.
+    uint8_t  block[64];
+#endif
+} ndef_sha256_t;
+
+// Start a new hash.
+void ndef_sha256_init(ndef_sha256_t* ctx);
+// Add `len` bytes to the hash.
+void ndef_sha256_update(ndef_sha256_t* ctx, const void* data, size_t len);
+// Finish the hash and store the digest in `digest_out`.
+// The context must be initialized again before it is reused.
+void ndef_sha256_finish(ndef_sha256_t* ctx, uint8_t digest_out[NDEF_SHA256_LEN]);
+// Abandon a hash without finishing it, releasing what the backend holds for it.
+void ndef_sha256_free(ndef_sha256_t* ctx);
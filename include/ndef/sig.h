@@ -0,0 +1,146 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common.h"
+#include "ndef/sha256.h"
+
+// Version of the Signature RTD written by `ndef_sig_write`; 2.0.
+#define NDEF_SIG_VERSION 0x20
+
+// Signature algorithm of a Signature record.
+typedef enum {
+    // No signature; marks the start of the records covered by the next Signature record.
+    NDEF_SIG_TYPE_NONE         = 0x00,
+    // RSA with the PSS padding scheme.
+    NDEF_SIG_TYPE_RSASSA_PSS   = 0x01,
+    // RSA with PKCS #1 v1.5 padding.
+    NDEF_SIG_TYPE_RSASSA_PKCS1 = 0x02,
+    // DSA.
+    NDEF_SIG_TYPE_DSA          = 0x03,
+    // ECDSA.
+    NDEF_SIG_TYPE_ECDSA        = 0x04,
+} ndef_sig_type_t;
+
+// Hash algorithm of a Signature record.
+typedef enum {
+    // SHA-256, the only hash `ndef_sig_verifier_t` supports.
+    NDEF_SIG_HASH_SHA256 = 0x02,
+} ndef_sig_hash_t;
+
+// Format of the certificates in a Signature record.
+typedef enum {
+    // X.509 certificates, DER-encoded.
+    NDEF_SIG_CERT_X509 = 0x00,
+    // NFC Forum M2M certificates.
+    NDEF_SIG_CERT_M2M  = 0x01,
+} ndef_sig_cert_format_t;
+
+// Data for an NDEF Signature record, which signs the records before it.
+// The payload is a version byte, then the signature field: URI flag and signature type, hash type, 16-bit length and
+// the signature or the URI it can be fetched from. Then the certificate chain field: URI flag, certificate format and
+// number of certificates, each certificate with a 16-bit length, and optionally a URI with a 16-bit length to fetch
+// the rest of the chain from.
+typedef struct {
+    // Whether this is beginning, end, both or middle of a message.
+    // Set by `ndef_sig_read`, ignored by `ndef_sig_write`.
+    ndef_pos_t             pos;
+    // Signature algorithm.
+    ndef_sig_type_t        type;
+    // Hash algorithm.
+    ndef_sig_hash_t        hash;
+    // Whether `signature` is a URI to fetch the signature from instead of the signature itself.
+    bool                   signature_is_uri;
+    // The signature, or the URI to fetch it from.
+    const uint8_t*         signature;
+    // Signature length.
+    size_t                 signature_len;
+    // Format of the certificates.
+    ndef_sig_cert_format_t cert_format;
+    // Number of certificates; at most 15.
+    size_t                 cert_count;
+    // The certificates, each preceded by its length as a 16-bit big-endian integer; see `ndef_sig_next_cert`.
+    const uint8_t*         certs;
+    // Length of `certs`.
+    size_t                 certs_len;
+    // URI to fetch the rest of the certificate chain from; omitted if empty.
+    const char*            cert_uri;
+    // Certificate chain URI length.
+    size_t                 cert_uri_len;
+} ndef_sig_t;
+
+// Get the payload size of an NDEF Signature record.
+size_t ndef_sig_payload_size(ndef_sig_t sig);
+// Get the encoded size of an NDEF Signature record.
+static inline size_t ndef_sig_encoded_size(ndef_sig_t sig) {
+    return ndef_record_encoded_size(3, 0, ndef_sig_payload_size(sig));
+}
+
+// Decode the payload of an NDEF Signature record that has already been read.
+// The signature and certificates are a reference to the record's payload.
+bool   ndef_sig_decode(const ndef_record_t* record, ndef_sig_t* sig_out);
+// Read an NDEF Signature record.
+// The signature and certificates are a reference to the blob passed.
+// On success, `istream` is advanced past the record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_sig_read(ndef_istream_t* istream, ndef_sig_t* sig_out);
+// Get the next certificate of a Signature record.
+// `offset` must be 0 for the first call and is advanced past the certificate found.
+// Returns false if there are no more certificates.
+bool   ndef_sig_next_cert(const ndef_sig_t* sig, size_t* offset, const uint8_t** cert_out, size_t* cert_len_out);
+// Write an NDEF Signature record.
+// `certs` must already hold the certificates with their lengths, as `ndef_sig_read` returns them.
+bool   ndef_sig_write(ndef_ostream_t* data_out, ndef_sig_t sig, ndef_pos_t pos);
+
+// Add a record to the hash of the records covered by a signature.
+// As the Signature RTD requires, the record is hashed as encoded but without its flags byte: the type length, the
+// payload length in 1 or 4 bytes, the ID length if present, the type, the ID and the payload.
+// A record that was not read is hashed in the form that the writers encode it in.
+void ndef_sig_hash_record(ndef_sha256_t* hash, const ndef_record_t* record);
+
+// Checks a signature against the digest of the records it covers, e.g. with a public key from the certificate chain.
+// Returns true if the signature is valid.
+typedef bool (*ndef_sig_verify_cb_t)(void* cookie, const ndef_sig_t* sig, const uint8_t* digest, size_t digest_len);
+
+// Verifies the Signature records of a message while it is read, hashing the records as they go by.
+typedef struct {
+    // Hash of the records since the start of the message or the last Signature record.
+    ndef_sha256_t        hash;
+    // Number of records in `hash`.
+    size_t               pending;
+    // Number of signatures that were verified.
+    size_t               verified;
+    // Number of records that no signature covers because a signature marker came after them.
+    size_t               unsigned_records;
+    // Checks the signatures.
+    ndef_sig_verify_cb_t verify;
+    // Passed to `verify`.
+    void*                cookie;
+} ndef_sig_verifier_t;
+
+// Start verifying a message.
+void ndef_sig_verifier_init(ndef_sig_verifier_t* verifier, ndef_sig_verify_cb_t verify, void* cookie);
+// Feed the next record of the message, e.g. as returned by `ndef_message_next` or passed to a parser callback.
+// Other records are hashed; a Signature record is checked against the hash of the records since the previous one.
+// Chunked records are hashed chunk by chunk, as they are fed.
+// Returns false if the record is a Signature record that is malformed, uses an unsupported hash, refers to its
+// signature by URI or does not verify.
+bool ndef_sig_verifier_feed(ndef_sig_verifier_t* verifier, const ndef_record_t* record);
+// Whether every record fed so far is covered by a verified signature.
+static inline bool ndef_sig_verifier_all_signed(const ndef_sig_verifier_t* verifier) {
+    return verifier->verified > 0 && verifier->pending == 0 && verifier->unsigned_records == 0;
+}
+// Release a verifier, whether or not the message was read to the end.
+void ndef_sig_verifier_free(ndef_sig_verifier_t* verifier);
+
+// Read the NDEF message in `istream`, verifying its Signature records.
+// Returns false if the message is malformed, a signature does not verify or a record is not covered by a signature.
+bool ndef_sig_verify_message(ndef_istream_t* istream, ndef_sig_verify_cb_t verify, void* cookie);
+
+#if NDEF_CRYPTO_MBEDTLS
+// Verify callback that checks signatures with mbedTLS; `cookie` is the `mbedtls_pk_context*` of the public key.
+// The signature is passed to `mbedtls_pk_verify` as is, so ECDSA signatures must be DER-encoded.
+bool ndef_sig_verify_mbedtls(void* cookie, const ndef_sig_t* sig, const uint8_t* digest, size_t digest_len);
+#endif
@@ -9,28 +9,96 @@
 #include "ndef/text.h"
 #include "ndef/uri.h"
 
+// Recommended action for the target of an NDEF Smart Poster.
+typedef enum {
+    // Do the action, e.g. send the SMS or launch the browser.
+    NDEF_SMARTPOSTER_ACTION_DO   = 0x00,
+    // Save for later, e.g. store the SMS or bookmark the URI.
+    NDEF_SMARTPOSTER_ACTION_SAVE = 0x01,
+    // Open for editing, e.g. open the SMS in an editor.
+    NDEF_SMARTPOSTER_ACTION_OPEN = 0x02,
+} ndef_smartposter_action_t;
+
 // Data for an NDEF Smart Poster record.
 typedef struct {
     // Whether this is beginning, end, both or middle of a message.
     // Set by `ndef_smartposter_read`, ignored by `ndef_smartposter_write`.
-    ndef_pos_t        pos;
+    ndef_pos_t                pos;
     // The URI prefix to use.
-    ndef_uri_prefix_t prefix;
+    ndef_uri_prefix_t         prefix;
     // URI data.
-    const char*       uri;
+    const char*               uri;
     // URI length.
-    size_t            uri_len;
+    size_t                    uri_len;
     // The title of the smart poster.
-    const char*       title;
+    const char*               title;
     // Title length.
-    size_t            title_len;
+    size_t                    title_len;
+    // Encoding of the title; UTF-8 unless set otherwise.
+    ndef_text_encoding_t      title_encoding;
+    // Language code of the title, e.g. "en"; may be empty.
+    const char*               title_lang;
+    // Title language code length.
+    size_t                    title_lang_len;
+    // Number of titles in the poster.
+    // Set by `ndef_smartposter_read`, ignored by `ndef_smartposter_write`.
+    size_t                    title_count;
+    // Whether `action` is present.
+    bool                      has_action;
+    // Recommended action for the target.
+    ndef_smartposter_action_t action;
+    // Whether `size` is present.
+    bool                      has_size;
+    // Size of the referenced object in bytes.
+    uint32_t                  size;
+    // MIME type of the referenced object, e.g. "text/html"; omitted if empty.
+    const char*               mime_type;
+    // MIME type length.
+    size_t                    mime_type_len;
+    // MIME type of the icon, e.g. "image/png"; the icon is omitted if empty.
+    const char*               icon_type;
+    // Icon type length.
+    size_t                    icon_type_len;
+    // Icon data.
+    const uint8_t*            icon;
+    // Icon data length.
+    size_t                    icon_len;
+    // The inner NDEF message, used by `ndef_smartposter_next_title` to list every title.
+    // Set by `ndef_smartposter_read`, ignored by `ndef_smartposter_write`.
+    const uint8_t*            records;
+    // Inner NDEF message length.
+    size_t                    records_len;
 } ndef_smartposter_t;
 
+// Get the payload size of an NDEF Smart Poster record.
+size_t ndef_smartposter_payload_size(const ndef_smartposter_t poster);
+// Get the encoded size of an NDEF Smart Poster record.
+size_t ndef_smartposter_encoded_size(const ndef_smartposter_t poster);
+
+// Decode the payload of an NDEF Smart Poster record that has already been read.
+// The title is chosen by `langs`, a list of language codes in order of preference; see `ndef_smartposter_read_lang`.
+// The strings within are a reference to the record's payload.
+bool   ndef_smartposter_decode(const ndef_record_t* record, ndef_smartposter_t* poster_out, const char* const* langs,
+                               size_t langs_len);
+// Read an NDEF Smart Poster record, choosing the title by a list of language codes in order of preference.
+// A title in an exact language matches before one that only shares the primary language, e.g. "en" for "en-US".
+// If no title matches, the first title is used.
+// The strings within are a reference to the blob passed.
+// On success, `istream` is advanced past the record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_smartposter_read_lang(ndef_istream_t* istream, ndef_smartposter_t* poster_out, const char* const* langs,
+                                  size_t langs_len);
 // Read an NDEF Smart Poster record.
 // The strings within are a reference to the blob passed.
+// On success, `istream` is advanced past the record.
 // Returns how long the record was read, or 0 on error.
 size_t ndef_smartposter_read(ndef_istream_t* istream, ndef_smartposter_t* poster_out);
+// Get the next title of a Smart Poster read by `ndef_smartposter_read`.
+// `offset` must be 0 for the first call and is advanced past the title found.
+// Returns false if there are no more titles.
+bool   ndef_smartposter_next_title(const ndef_smartposter_t* poster, size_t* offset, ndef_text_t* title_out);
 
 // Write an NDEF Smart Poster record.
+// The inner records are written directly into `ostream` without an intermediate buffer.
 // Returns how long the record was written, or 0 on error.
 size_t ndef_smartposter_write(ndef_ostream_t* ostream, const ndef_smartposter_t poster, ndef_pos_t pos);
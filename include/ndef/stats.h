@@ -0,0 +1,155 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Whether the library keeps statistics; define as 1 when building it to enable them.
+// When disabled, the instrumentation compiles to nothing and every snapshot is zero.
+#ifndef NDEF_STATS
+#define NDEF_STATS 0
+#endif
+
+// Instrumented library functions.
+typedef enum {
+    NDEF_STATS_FN_READ_RECORD,
+    NDEF_STATS_FN_WRITE_HEADER,
+    NDEF_STATS_FN_MESSAGE_NEXT,
+    NDEF_STATS_FN_MESSAGE_WRITE,
+    NDEF_STATS_FN_BATCH_WRITE,
+    NDEF_STATS_FN_DECD_DECODE,
+    NDEF_STATS_FN_DECD_WRITE,
+    NDEF_STATS_FN_PARSER_FEED,
+    NDEF_STATS_FN_URI_DECODE,
+    NDEF_STATS_FN_URI_WRITE,
+    NDEF_STATS_FN_TEXT_DECODE,
+    NDEF_STATS_FN_TEXT_WRITE,
+    NDEF_STATS_FN_SMARTPOSTER_DECODE,
+    NDEF_STATS_FN_SMARTPOSTER_WRITE,
+    NDEF_STATS_FN_WIFI_DECODE,
+    NDEF_STATS_FN_WIFI_WRITE,
+    NDEF_STATS_FN_TLV_READ,
+    NDEF_STATS_FN_DIFF,
+    NDEF_STATS_FN_COUNT,
+} ndef_stats_fn_t;
+
+// Reasons why parsing failed.
+typedef enum {
+    // A record or TLV extends past the end of the data.
+    NDEF_STATS_FAIL_TRUNCATED,
+    // The message begin or end flags are out of order.
+    NDEF_STATS_FAIL_MESSAGE_FLAGS,
+    // A chunked record is not followed by well-formed chunks.
+    NDEF_STATS_FAIL_CHUNK,
+    // A record has the right type but its payload is malformed.
+    NDEF_STATS_FAIL_PAYLOAD,
+    NDEF_STATS_FAIL_COUNT,
+} ndef_stats_fail_t;
+
+// A statistics counter; word-sized so that it can be updated without locking on every target.
+typedef size_t ndef_stats_counter_t;
+#if defined(__GCC_ATOMIC_LLONG_LOCK_FREE) && __GCC_ATOMIC_LLONG_LOCK_FREE == 2
+// A sum of clock deltas; 64 bits wide where that can be updated without locking.
+typedef uint64_t ndef_stats_time_t;
+#else
+// A sum of clock deltas; word-sized, since wider atomics take a lock on targets like the ESP32.
+// A 32-bit sum wraps after 2^32 clock units, e.g. after about 71 minutes with the microseconds of
+// `esp_timer_get_time`; pick the clock units so that it lasts long enough between resets.
+typedef ndef_stats_counter_t ndef_stats_time_t;
+#endif
+
+// Statistics of the library, counted since startup or the last `ndef_stats_reset`.
+typedef struct {
+    // Number of calls per instrumented function.
+    ndef_stats_counter_t calls[NDEF_STATS_FN_COUNT];
+    // Bytes of records written; records nested in others, like Smart Poster contents, count toward both.
+    ndef_stats_counter_t bytes_encoded;
+    // Bytes of records read; records nested in others count toward both.
+    ndef_stats_counter_t bytes_decoded;
+    // Number of times an output stream allocated memory to grow, including its first allocation.
+    ndef_stats_counter_t reallocs;
+    // Largest capacity an output stream has grown to.
+    ndef_stats_counter_t peak_capacity;
+    // Number of parse failures per reason.
+    ndef_stats_counter_t failures[NDEF_STATS_FAIL_COUNT];
+    // Time spent in each instrumented function, including nested calls, in units of the clock hook.
+    // Stays zero until a clock is set with `ndef_stats_set_clock`.
+    ndef_stats_time_t    time[NDEF_STATS_FN_COUNT];
+} ndef_stats_t;
+
+// A clock for timing instrumented functions, such as a wrapper around `esp_timer_get_time`.
+typedef uint64_t (*ndef_stats_clock_t)(void);
+
+// Set the clock used to time instrumented functions, or NULL to stop timing them.
+void        ndef_stats_set_clock(ndef_stats_clock_t clock);
+// Copy the current statistics into `stats_out`.
+// Each counter is read atomically without locking, but counters updated concurrently may be from slightly different
+// moments.
+void        ndef_stats_snapshot(ndef_stats_t* stats_out);
+// Reset all statistics to zero.
+void        ndef_stats_reset(void);
+// Get the name of an instrumented function.
+const char* ndef_stats_fn_name(ndef_stats_fn_t fn);
+// Get the name of a parse failure reason.
+const char* ndef_stats_fail_name(ndef_stats_fail_t reason);
+
+#if NDEF_STATS
+
+// The live statistics; update them through the macros below.
+extern ndef_stats_t       ndef_stats_live;
+// The clock set by `ndef_stats_set_clock`.
+extern ndef_stats_clock_t ndef_stats_clock;
+
+// The state of one instrumented call.
+typedef struct {
+    ndef_stats_fn_t    fn;
+    ndef_stats_clock_t clock;
+    uint64_t           start;
+} ndef_stats_scope_t;
+
+// Add to a statistics counter.
+#define NDEF_STATS_ADD(counter_, value_) \
+    ((void)__atomic_fetch_add(&ndef_stats_live.counter_, (value_), __ATOMIC_RELAXED))
+// Raise a statistics counter to `value_` if it is lower.
+#define NDEF_STATS_MAX(counter_, value_) ndef_stats_max(&ndef_stats_live.counter_, (value_))
+// Count a parse failure.
+#define NDEF_STATS_FAIL(reason_) NDEF_STATS_ADD(failures[NDEF_STATS_FAIL_##reason_], 1)
+// Count a call to the current function and time it until it returns.
+#define NDEF_STATS_FN(fn_)                                                                                             \
+    ndef_stats_scope_t ndef_stats_scope_ __attribute__((cleanup(ndef_stats_leave))) =                                 \
+        ndef_stats_enter(NDEF_STATS_FN_##fn_)
+
+// Raise a counter to `value` if it is lower.
+static inline void ndef_stats_max(ndef_stats_counter_t* counter, ndef_stats_counter_t value) {
+    ndef_stats_counter_t cur = __atomic_load_n(counter, __ATOMIC_RELAXED);
+    while (cur < value &&
+           !__atomic_compare_exchange_n(counter, &cur, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// Start an instrumented call.
+static inline ndef_stats_scope_t ndef_stats_enter(ndef_stats_fn_t fn) {
+    NDEF_STATS_ADD(calls[fn], 1);
+    ndef_stats_clock_t clock = __atomic_load_n(&ndef_stats_clock, __ATOMIC_RELAXED);
+    return (ndef_stats_scope_t){fn, clock, clock ? clock() : 0};
+}
+
+// Finish an instrumented call; runs automatically when it goes out of scope.
+static inline void ndef_stats_leave(ndef_stats_scope_t* scope) {
+    if (scope->clock) {
+        NDEF_STATS_ADD(time[scope->fn], scope->clock() - scope->start);
+    }
+}
+
+#else
+
+#define NDEF_STATS_ADD(counter_, value_) ((void)0)
+#define NDEF_STATS_MAX(counter_, value_) ((void)0)
+#define NDEF_STATS_FAIL(reason_)         ((void)0)
+#define NDEF_STATS_FN(fn_)               ((void)0)
+
+#endif
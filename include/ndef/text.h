@@ -7,27 +7,67 @@
 #include <string.h>
 #include "common.h"
 
+// Encoding of the text of an NDEF text record.
+typedef enum {
+    // UTF-8.
+    NDEF_TEXT_UTF8  = 0,
+    // UTF-16; big-endian unless the text starts with a byte order mark.
+    NDEF_TEXT_UTF16 = 1,
+} ndef_text_encoding_t;
+
 // Data for an NDEF text record.
 typedef struct {
     // Whether this is beginning, end, both or middle of a message.
     // Set by `ndef_text_read`, ignored by `ndef_text_write`.
-    ndef_pos_t  pos;
+    ndef_pos_t           pos;
+    // Encoding of `text`; UTF-8 unless set otherwise.
+    ndef_text_encoding_t encoding;
     // The language code, e.g. "en" for English.
-    const char* lang;
+    const char*          lang;
     // Language code byte length.
-    size_t      lang_len;
-    // Text data.
-    const char* text;
+    size_t               lang_len;
+    // Text data, in `encoding`.
+    const char*          text;
     // Text byte length.
-    size_t      text_len;
+    size_t               text_len;
 } ndef_text_t;
 
+// Get the payload size of an NDEF text record.
+static inline size_t ndef_text_payload_size(ndef_text_t text) {
+    return 1 + text.lang_len + text.text_len;
+}
+
+// Get the encoded size of an NDEF text record.
+static inline size_t ndef_text_encoded_size(ndef_text_t text) {
+    return ndef_record_encoded_size(1, 0, ndef_text_payload_size(text));
+}
+
+// Decode the payload of an NDEF text record that has already been read.
+// The strings within are a reference to the record's payload.
+bool   ndef_text_decode(const ndef_record_t* record, ndef_text_t* text_out);
 // Read an NDEF text record.
 // The strings within are a reference to the blob passed.
+// On success, `istream` is advanced past the record.
 // Returns how long the record was read, or 0 on error.
 size_t ndef_text_read(ndef_istream_t* istream, ndef_text_t* text_out);
 // Write an NDEF text record.
+// Returns false if UTF-8 text is not valid UTF-8 or UTF-16 text has an odd length.
 bool   ndef_text_write(ndef_ostream_t* data_out, ndef_text_t text, ndef_pos_t pos);
+// Write an NDEF text record whose text is the concatenation of `slices`, in `encoding`.
+// The header is written once for the total length and each slice is copied straight into the output; UTF-8 text is
+// checked once it has been copied, so a character may be split between slices.
+// Returns false if UTF-8 text is not valid UTF-8 or UTF-16 text has an odd length, in which case nothing is written.
+bool   ndef_text_write_slices(ndef_ostream_t* data_out, ndef_text_encoding_t encoding, const char* lang,
+                              size_t lang_len, const ndef_slice_t* slices, size_t slices_len, ndef_pos_t pos);
+// Write an NDEF text record with UTF-16 text transcoded from the UTF-8 `text`.
+// The text is transcoded straight into the output, big-endian and without a byte order mark.
+bool   ndef_text_write_utf16(ndef_ostream_t* data_out, const char* lang, size_t lang_len, const char* text,
+                             size_t text_len, ndef_pos_t pos);
+// Get the text of an NDEF text record as UTF-8.
+// Valid UTF-8 text is returned as is without copying; UTF-16 text is transcoded into `buf`.
+// Returns false if the text is not valid UTF-8 or does not fit in `buf_cap` bytes.
+bool   ndef_text_get_utf8(const ndef_text_t* text, char* buf, size_t buf_cap, const char** utf8_out,
+                          size_t* utf8_len_out);
 
 // Make and write an NDEF text from a string.
 static inline bool ndef_text_write_str(ndef_ostream_t* data_out, const char* lang, size_t lang_len, const char* text,
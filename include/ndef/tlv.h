@@ -0,0 +1,95 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common.h"
+
+// Types of TLV blocks in the data area of NFC Forum Type 2 and Type 5 tags.
+typedef enum {
+    // Padding; has no length or value.
+    NDEF_TLV_NULL           = 0x00,
+    // Location of the dynamic lock bits.
+    NDEF_TLV_LOCK_CONTROL   = 0x01,
+    // Location of reserved memory.
+    NDEF_TLV_MEMORY_CONTROL = 0x02,
+    // An NDEF message.
+    NDEF_TLV_NDEF_MESSAGE   = 0x03,
+    // Proprietary data.
+    NDEF_TLV_PROPRIETARY    = 0xfd,
+    // End of the TLV blocks; has no length or value.
+    NDEF_TLV_TERMINATOR     = 0xfe,
+} ndef_tlv_type_t;
+
+// The largest value length a TLV block can have.
+#define NDEF_TLV_MAX_LEN 0xfffe
+
+// A TLV block.
+typedef struct {
+    // The type of this block.
+    ndef_tlv_type_t type;
+    // Offset of the block from the start of the memory image.
+    size_t          offset;
+    // The value of this block; a reference to the memory image.
+    const uint8_t*  value;
+    // Value length.
+    size_t          len;
+} ndef_tlv_t;
+
+// Decoded value of a Lock Control or Memory Control TLV.
+typedef struct {
+    // Byte address of the area in the tag memory.
+    size_t address;
+    // Size of the area; in bits for Lock Control, in bytes for Memory Control.
+    size_t size;
+    // Number of bytes locked by each lock bit; 0 for Memory Control.
+    size_t bytes_per_lock_bit;
+} ndef_tlv_control_t;
+
+// Get the size of the header of a TLV block with a `len` byte value.
+static inline size_t ndef_tlv_header_size(size_t len) {
+    return len < 0xff ? 2 : 4;
+}
+
+// Get the encoded size of a TLV block with a `len` byte value.
+static inline size_t ndef_tlv_encoded_size(size_t len) {
+    return ndef_tlv_header_size(len) + len;
+}
+
+// Write the header of a TLV block whose value of `len` bytes is written next, e.g. by `ndef_message_write`.
+bool   ndef_tlv_write_header(ndef_ostream_t* data_out, ndef_tlv_type_t type, size_t len);
+// Write a TLV block.
+bool   ndef_tlv_write(ndef_ostream_t* data_out, ndef_tlv_type_t type, const uint8_t* value, size_t len);
+// Begin writing a TLV block whose length is not known in advance.
+// The value is written directly after this returns; `ndef_tlv_write_end` then fills in the length.
+// Stores the offset of the block in `mark_out`.
+bool   ndef_tlv_write_begin(ndef_ostream_t* data_out, ndef_tlv_type_t type, size_t* mark_out);
+// Finish writing a TLV block started with `ndef_tlv_write_begin`.
+// The value is moved down to use the one-byte length format if it fits.
+// Returns how long the block was written, or 0 on error.
+size_t ndef_tlv_write_end(ndef_ostream_t* data_out, size_t mark);
+// Write a Terminator TLV and pad the output with NULL TLVs up to a multiple of `page_size` bytes.
+// `page_size` is 4 for Type 2 tags and the block size for Type 5 tags; 0 or 1 disables padding.
+bool   ndef_tlv_write_terminator(ndef_ostream_t* data_out, size_t page_size);
+
+// Read a TLV block.
+// NULL and Terminator TLVs are read as blocks without a value.
+// On success, `istream` is advanced past the block.
+// Returns how long the block was read, or 0 on error.
+size_t ndef_tlv_read(ndef_istream_t* istream, ndef_tlv_t* tlv_out);
+// Find the first TLV block of type `type`, stopping at a Terminator TLV.
+// The value within is a reference to the memory image; nothing is copied.
+// On success, `istream` is advanced past the block.
+bool   ndef_tlv_find(ndef_istream_t* istream, ndef_tlv_type_t type, ndef_tlv_t* tlv_out);
+// Decode the value of a Lock Control or Memory Control TLV.
+bool   ndef_tlv_control_decode(const ndef_tlv_t* tlv, ndef_tlv_control_t* control_out);
+
+// Find the first NDEF Message TLV in a memory image and make an input stream for the NDEF message inside.
+static inline bool ndef_tlv_find_message(const uint8_t* data, size_t len, ndef_istream_t* message_out) {
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(data, len);
+    ndef_tlv_t     tlv;
+    NDEF_RETURN_ON_FALSE(ndef_tlv_find(&istream, NDEF_TLV_NDEF_MESSAGE, &tlv));
+    *message_out = NDEF_ISTREAM_NEW(tlv.value, tlv.len);
+    return true;
+}
@@ -101,14 +101,124 @@ typedef struct {
     size_t            uri_len;
 } ndef_uri_t;
 
+// Get the payload size of an NDEF URI record.
+static inline size_t ndef_uri_payload_size(ndef_uri_t uri) {
+    return 1 + uri.uri_len;
+}
+
+// Get the encoded size of an NDEF URI record.
+static inline size_t ndef_uri_encoded_size(ndef_uri_t uri) {
+    return ndef_record_encoded_size(1, 0, ndef_uri_payload_size(uri));
+}
+
+// Returns `prefix` from `ndef_uri_match_prefix` if `uri` starts with the string literal `str`.
+#define NDEF_URI_TRY_PREFIX(str, prefix)                                                                               \
+    if (uri_len >= sizeof(str) - 1 && memcmp(uri, str, sizeof(str) - 1) == 0) {                                       \
+        *prefix_len_out = sizeof(str) - 1;                                                                             \
+        return prefix;                                                                                                 \
+    }
+
+// Find the longest NDEF URI prefix that `uri` starts with and store its length in `prefix_len_out`.
+// Dispatches on the first character and only compares against literals of known length,
+// so the result is computed at compile time when `uri` is a literal.
+static inline ndef_uri_prefix_t ndef_uri_match_prefix(const char* uri, size_t uri_len, size_t* prefix_len_out) {
+    *prefix_len_out = 0;
+    if (uri_len == 0) {
+        return NDEF_URI_NO_PREFIX;
+    }
+    // Within each case, longer prefixes are tried before the prefixes they start with.
+    switch (uri[0]) {
+        case 'b':
+            NDEF_URI_TRY_PREFIX("btspp://", NDEF_URI_PREFIX_BTSPP);
+            NDEF_URI_TRY_PREFIX("btl2cap://", NDEF_URI_PREFIX_BTL2CAP);
+            NDEF_URI_TRY_PREFIX("btgoep://", NDEF_URI_PREFIX_BTGOEP);
+            break;
+        case 'd':
+            NDEF_URI_TRY_PREFIX("dav://", NDEF_URI_PREFIX_DAV);
+            break;
+        case 'f':
+            NDEF_URI_TRY_PREFIX("ftp://anonymous:anonymous@", NDEF_URI_PREFIX_FTP_ANONYMOUS_ANONYMOUS);
+            NDEF_URI_TRY_PREFIX("ftp://ftp.", NDEF_URI_PREFIX_FTP_FTP);
+            NDEF_URI_TRY_PREFIX("ftp://", NDEF_URI_PREFIX_FTP);
+            NDEF_URI_TRY_PREFIX("ftps://", NDEF_URI_PREFIX_FTPS);
+            NDEF_URI_TRY_PREFIX("file://", NDEF_URI_PREFIX_FILE);
+            break;
+        case 'h':
+            NDEF_URI_TRY_PREFIX("https://www.", NDEF_URI_PREFIX_HTTPS_WWW);
+            NDEF_URI_TRY_PREFIX("https://", NDEF_URI_PREFIX_HTTPS);
+            NDEF_URI_TRY_PREFIX("http://www.", NDEF_URI_PREFIX_HTTP_WWW);
+            NDEF_URI_TRY_PREFIX("http://", NDEF_URI_PREFIX_HTTP);
+            break;
+        case 'i':
+            NDEF_URI_TRY_PREFIX("imap:", NDEF_URI_PREFIX_IMAP);
+            NDEF_URI_TRY_PREFIX("irdaobex://", NDEF_URI_PREFIX_IRDAOBEX);
+            break;
+        case 'm':
+            NDEF_URI_TRY_PREFIX("mailto:", NDEF_URI_PREFIX_MAILTO);
+            break;
+        case 'n':
+            NDEF_URI_TRY_PREFIX("nfs://", NDEF_URI_PREFIX_NFS);
+            NDEF_URI_TRY_PREFIX("news:", NDEF_URI_PREFIX_NEWS);
+            break;
+        case 'p':
+            NDEF_URI_TRY_PREFIX("pop:", NDEF_URI_PREFIX_POP);
+            break;
+        case 'r':
+            NDEF_URI_TRY_PREFIX("rtsp://", NDEF_URI_PREFIX_RTSP);
+            break;
+        case 's':
+            NDEF_URI_TRY_PREFIX("sftp://", NDEF_URI_PREFIX_SFTP);
+            NDEF_URI_TRY_PREFIX("smb://", NDEF_URI_PREFIX_SMB);
+            NDEF_URI_TRY_PREFIX("sips:", NDEF_URI_PREFIX_SIPS);
+            NDEF_URI_TRY_PREFIX("sip:", NDEF_URI_PREFIX_SIP);
+            break;
+        case 't':
+            NDEF_URI_TRY_PREFIX("telnet://", NDEF_URI_PREFIX_TELNET);
+            NDEF_URI_TRY_PREFIX("tel:", NDEF_URI_PREFIX_TEL);
+            NDEF_URI_TRY_PREFIX("tftp:", NDEF_URI_PREFIX_TFTP);
+            NDEF_URI_TRY_PREFIX("tcpobex://", NDEF_URI_PREFIX_TCPOBEX);
+            break;
+        case 'u':
+            NDEF_URI_TRY_PREFIX("urn:epc:id:", NDEF_URI_PREFIX_URN_EPC_ID);
+            NDEF_URI_TRY_PREFIX("urn:epc:tag:", NDEF_URI_PREFIX_URN_EPC_TAG);
+            NDEF_URI_TRY_PREFIX("urn:epc:pat:", NDEF_URI_PREFIX_URN_EPC_PAT);
+            NDEF_URI_TRY_PREFIX("urn:epc:raw:", NDEF_URI_PREFIX_URN_EPC_RAW);
+            NDEF_URI_TRY_PREFIX("urn:epc:", NDEF_URI_PREFIX_URN_EPC);
+            NDEF_URI_TRY_PREFIX("urn:nfc:", NDEF_URI_PREFIX_URN_NFC);
+            NDEF_URI_TRY_PREFIX("urn:", NDEF_URI_PREFIX_URN);
+            break;
+    }
+    return NDEF_URI_NO_PREFIX;
+}
+
+#undef NDEF_URI_TRY_PREFIX
+
+// Make an NDEF URI from a string without calling into the library.
+static inline ndef_uri_t ndef_uri_format_inline(const char* uri, size_t uri_len) {
+    size_t            prefix_len;
+    ndef_uri_prefix_t prefix = ndef_uri_match_prefix(uri, uri_len, &prefix_len);
+    // This has a pos field, but it is ignored by `ndef_uri_write`.
+    return (ndef_uri_t){NDEF_POS_MIDDLE, prefix, uri + prefix_len, uri_len - prefix_len};
+}
+
+// Decode the payload of an NDEF URI record that has already been read.
+// The strings within are a reference to the record's payload.
+bool       ndef_uri_decode(const ndef_record_t* record, ndef_uri_t* uri_out);
 // Read an NDEF URI record.
 // The strings within are a reference to the blob passed.
+// On success, `istream` is advanced past the record.
 // Returns how long the record was read, or 0 on error.
 size_t     ndef_uri_read(ndef_istream_t* istream, ndef_uri_t* uri_out);
 // Make an NDEF URI from a string.
 ndef_uri_t ndef_uri_format(const char* uri, size_t uri_len);
 // Write an NDEF URI record.
 bool       ndef_uri_write(ndef_ostream_t* data_out, ndef_uri_t uri, ndef_pos_t pos);
+// Write an NDEF URI record whose URI is `prefix` followed by the concatenation of `slices`, e.g. a base URI and a
+// per-device suffix. The caller passes the prefix code, which `slices` must not contain; to derive it, call
+// `ndef_uri_match_prefix` on the first slice and leave the matched part out of it.
+// The header is written once for the total length and each slice is copied straight into the output.
+bool       ndef_uri_write_slices(ndef_ostream_t* data_out, ndef_uri_prefix_t prefix, const ndef_slice_t* slices,
+                                 size_t slices_len, ndef_pos_t pos);
 
 // Make and wirite an NDEF URI from a string.
 static inline bool ndef_uri_write_str(ndef_ostream_t* data_out, const char* uri, size_t uri_len, ndef_pos_t pos) {
@@ -116,8 +226,9 @@ static inline bool ndef_uri_write_str(ndef_ostream_t* data_out, const char* uri,
 }
 
 // Make an NDEF URI from a C-string.
+// Inlined so that the prefix of a literal is picked at compile time.
 static inline ndef_uri_t ndef_uri_format_cstr(const char* uri) {
-    return ndef_uri_format(uri, strlen(uri));
+    return ndef_uri_format_inline(uri, strlen(uri));
 }
 
 // Make and write an NDEF URI from a C-string.
@@ -0,0 +1,62 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// The code point that invalid input is replaced with when transcoding.
+#define NDEF_UTF_REPLACEMENT 0xfffd
+
+// State of a streaming UTF-16 to UTF-8 transcoder.
+// Zero-initialize it, or set `big_endian` to true for big-endian input without a byte order mark.
+typedef struct {
+    // Whether the input is big-endian; updated by a byte order mark at the start of the input.
+    bool    big_endian;
+    // Whether the start of the input, where a byte order mark may be, has been consumed.
+    bool    started;
+    // Number of bytes held in `pending`.
+    uint8_t pending_len;
+    // Bytes of a code unit or surrogate pair that was split across input buffers.
+    uint8_t pending[4];
+} ndef_utf16_decoder_t;
+
+// State of a streaming UTF-8 to UTF-16 transcoder.
+typedef struct {
+    // Whether to produce big-endian output.
+    bool    big_endian;
+    // Number of bytes held in `pending`.
+    uint8_t pending_len;
+    // Bytes of a sequence that was split across input buffers.
+    uint8_t pending[4];
+} ndef_utf8_decoder_t;
+
+// Check whether `data` is well-formed UTF-8: no overlong forms, surrogates or code points above U+10FFFF.
+// Runs of ASCII are skipped a machine word at a time.
+bool   ndef_utf8_valid(const uint8_t* data, size_t len);
+// Get how many bytes of UTF-16 the UTF-8 `data` transcodes to, counting replacements of invalid sequences.
+size_t ndef_utf8_utf16_len(const uint8_t* data, size_t len);
+// Get how many bytes of UTF-8 the UTF-16 `data` transcodes to, honoring and dropping a byte order mark.
+// `big_endian` is the byte order assumed if there is no byte order mark.
+size_t ndef_utf16_utf8_len(const uint8_t* data, size_t len, bool big_endian);
+
+// Transcode UTF-16 from `*in` to UTF-8 in `out`, until the input is used up or the next character does not fit.
+// Advances `*in` and `*in_len` past the consumed input and returns how many bytes were written to `out`.
+// A code unit split over two calls is kept in `decoder`; unpaired surrogates become U+FFFD.
+size_t ndef_utf16_to_utf8(ndef_utf16_decoder_t* decoder, const uint8_t** in, size_t* in_len, uint8_t* out,
+                          size_t out_cap);
+// Flush a UTF-16 to UTF-8 transcoder at the end of its input, writing U+FFFD for a truncated code unit.
+// Returns how many bytes were written to `out`, which must have room for 3.
+size_t ndef_utf16_to_utf8_finish(ndef_utf16_decoder_t* decoder, uint8_t* out, size_t out_cap);
+
+// Transcode UTF-8 from `*in` to UTF-16 in `out`, until the input is used up or the next character does not fit.
+// Advances `*in` and `*in_len` past the consumed input and returns how many bytes were written to `out`.
+// A sequence split over two calls is kept in `decoder`; invalid sequences become U+FFFD.
+size_t ndef_utf8_to_utf16(ndef_utf8_decoder_t* decoder, const uint8_t** in, size_t* in_len, uint8_t* out,
+                          size_t out_cap);
+// Flush a UTF-8 to UTF-16 transcoder at the end of its input, writing U+FFFD for a truncated sequence.
+// Returns how many bytes were written to `out`, which must have room for 2.
+size_t ndef_utf8_to_utf16_finish(ndef_utf8_decoder_t* decoder, uint8_t* out, size_t out_cap);
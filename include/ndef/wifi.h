@@ -0,0 +1,69 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <string.h>
+#include "common.h"
+
+// MIME type of a Wi-Fi Simple Configuration record.
+#define NDEF_WIFI_MIME_TYPE "application/vnd.wfa.wsc"
+
+// Wi-Fi authentication type.
+typedef enum {
+    NDEF_WIFI_AUTH_OPEN            = 0x0001,
+    NDEF_WIFI_AUTH_WPA_PERSONAL    = 0x0002,
+    NDEF_WIFI_AUTH_SHARED          = 0x0004,
+    NDEF_WIFI_AUTH_WPA_ENTERPRISE  = 0x0008,
+    NDEF_WIFI_AUTH_WPA2_ENTERPRISE = 0x0010,
+    NDEF_WIFI_AUTH_WPA2_PERSONAL   = 0x0020,
+} ndef_wifi_auth_t;
+
+// Wi-Fi encryption type.
+typedef enum {
+    NDEF_WIFI_ENCR_NONE = 0x0001,
+    NDEF_WIFI_ENCR_WEP  = 0x0002,
+    NDEF_WIFI_ENCR_TKIP = 0x0004,
+    NDEF_WIFI_ENCR_AES  = 0x0008,
+} ndef_wifi_encr_t;
+
+// Data for an NDEF Wi-Fi Simple Configuration credential record.
+typedef struct {
+    // Whether this is beginning, end, both or middle of a message.
+    // Set by `ndef_wifi_read`, ignored by `ndef_wifi_write`.
+    ndef_pos_t     pos;
+    // Network name.
+    const char*    ssid;
+    // Network name length.
+    size_t         ssid_len;
+    // Authentication types; a combination of `ndef_wifi_auth_t`.
+    uint16_t       auth;
+    // Encryption types; a combination of `ndef_wifi_encr_t`.
+    uint16_t       encr;
+    // Network key, e.g. the WPA passphrase.
+    const char*    key;
+    // Network key length.
+    size_t         key_len;
+    // 6-byte MAC address of the access point, or NULL for any.
+    const uint8_t* mac;
+} ndef_wifi_t;
+
+// Get the payload size of an NDEF Wi-Fi record.
+size_t ndef_wifi_payload_size(ndef_wifi_t wifi);
+
+// Get the encoded size of an NDEF Wi-Fi record.
+static inline size_t ndef_wifi_encoded_size(ndef_wifi_t wifi) {
+    return ndef_record_encoded_size(sizeof(NDEF_WIFI_MIME_TYPE) - 1, 0, ndef_wifi_payload_size(wifi));
+}
+
+// Decode the payload of an NDEF Wi-Fi record that has already been read.
+// Only the first credential is decoded; the strings within are a reference to the record's payload.
+bool   ndef_wifi_decode(const ndef_record_t* record, ndef_wifi_t* wifi_out);
+// Read an NDEF Wi-Fi record.
+// The strings within are a reference to the blob passed.
+// On success, `istream` is advanced past the record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_wifi_read(ndef_istream_t* istream, ndef_wifi_t* wifi_out);
+// Write an NDEF Wi-Fi record with a single credential.
+bool   ndef_wifi_write(ndef_ostream_t* data_out, ndef_wifi_t wifi, ndef_pos_t pos);
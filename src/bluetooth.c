@@ -0,0 +1,125 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/bluetooth.h"
+
+// Get the next AD structure of out-of-band data.
+bool ndef_bt_ad_next(const uint8_t* data, size_t len, size_t* offset, ndef_bt_ad_t* ad_out) {
+    NDEF_RETURN_ON_FALSE(*offset < len && data[*offset] != 0);
+    size_t ad_len = data[*offset];
+    NDEF_RETURN_ON_FALSE(len - *offset - 1 >= ad_len);
+    *ad_out = (ndef_bt_ad_t){
+        .type = data[*offset + 1],
+        .data = data + *offset + 2,
+        .len  = ad_len - 1,
+    };
+    *offset += 1 + ad_len;
+    return true;
+}
+
+// Whether a record is a Bluetooth LE carrier configuration record.
+static inline bool ndef_ble_oob_is_type(const ndef_record_t* record) {
+    return ndef_record_is_type(record, NDEF_TNF_MIME_MEDIA, NDEF_BLE_OOB_MIME_TYPE, sizeof(NDEF_BLE_OOB_MIME_TYPE) - 1);
+}
+
+// Decode the payload of an NDEF Bluetooth LE carrier configuration record that has already been read.
+bool ndef_ble_oob_decode(const ndef_record_t* record, ndef_ble_oob_t* oob_out) {
+    NDEF_RETURN_ON_FALSE(ndef_ble_oob_is_type(record));
+    *oob_out = (ndef_ble_oob_t){
+        .pos    = record->pos,
+        .id     = record->id,
+        .id_len = record->id_len,
+        .ad     = record->payload,
+        .ad_len = record->payload_len,
+    };
+
+    // Walk the AD structures once, keeping references into the payload.
+    size_t       offset        = 0;
+    bool         name_complete = false;
+    ndef_bt_ad_t ad;
+    while (ndef_bt_ad_next(record->payload, record->payload_len, &offset, &ad)) {
+        switch (ad.type) {
+            case NDEF_BT_AD_LE_ADDRESS:
+                NDEF_RETURN_ON_FALSE(ad.len == 7, NDEF_STATS_FAIL(PAYLOAD););
+                memcpy(oob_out->address, ad.data, sizeof(oob_out->address));
+                oob_out->has_address    = true;
+                oob_out->address_random = ad.data[6] & 0x01;
+                break;
+            case NDEF_BT_AD_LE_ROLE:
+                NDEF_RETURN_ON_FALSE(ad.len == 1, NDEF_STATS_FAIL(PAYLOAD););
+                oob_out->has_role = true;
+                oob_out->role     = ad.data[0];
+                break;
+            case NDEF_BT_AD_NAME_SHORT:
+            case NDEF_BT_AD_NAME_COMPLETE:
+                // The complete name wins over a shortened one.
+                if (!name_complete) {
+                    name_complete     = ad.type == NDEF_BT_AD_NAME_COMPLETE;
+                    oob_out->name     = (const char*)ad.data;
+                    oob_out->name_len = ad.len;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    // The structures must end with the payload or with a structure of length 0.
+    NDEF_RETURN_ON_FALSE(offset == record->payload_len || record->payload[offset] == 0, NDEF_STATS_FAIL(PAYLOAD););
+    return true;
+}
+
+// Read an NDEF Bluetooth LE carrier configuration record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_ble_oob_read(ndef_istream_t* istream, ndef_ble_oob_t* oob_out) {
+    ndef_record_t record;
+    size_t        record_len = NDEF_RETURN_ON_FALSE(ndef_read_record(istream, &record));
+    NDEF_RETURN_ON_FALSE(ndef_ble_oob_decode(&record, oob_out),
+                         ndef_istream_reject(istream, record_len, ndef_ble_oob_is_type(&record)););
+    return record_len;
+}
+
+// Write an NDEF Bluetooth LE carrier configuration record made of `ads_len` AD structures.
+// Returns how long the record was written, or 0 on error.
+size_t ndef_ble_oob_write(ndef_ostream_t* data_out, const char* id, size_t id_len, const ndef_bt_ad_t* ads,
+                          size_t ads_len, ndef_pos_t pos) {
+    for (size_t i = 0; i < ads_len; i++) {
+        NDEF_RETURN_ON_FALSE(ads[i].len <= 254, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    }
+    ndef_record_t record = {
+        .pos         = pos,
+        .tnf         = NDEF_TNF_MIME_MEDIA,
+        .type_len    = sizeof(NDEF_BLE_OOB_MIME_TYPE) - 1,
+        .type        = NDEF_BLE_OOB_MIME_TYPE,
+        .id_len      = id_len,
+        .id          = id,
+        .payload_len = ndef_bt_ad_size(ads, ads_len),
+    };
+    // The header reserves space for the whole payload.
+    size_t start = data_out->len;
+    NDEF_RETURN_ON_FALSE(ndef_write_header(data_out, &record));
+    for (size_t i = 0; i < ads_len; i++) {
+        NDEF_RETURN_ON_FALSE(ndef_ostream_push(data_out, 1 + ads[i].len), data_out->len = start;);
+        NDEF_RETURN_ON_FALSE(ndef_ostream_push(data_out, ads[i].type), data_out->len = start;);
+        NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, ads[i].data, ads[i].len), data_out->len = start;);
+    }
+    return data_out->len - start;
+}
+
+// Write an NDEF Bluetooth LE carrier configuration record with the ID and AD structures of `oob` as they were read.
+// Returns how long the record was written, or 0 on error.
+size_t ndef_ble_oob_write_ad(ndef_ostream_t* data_out, ndef_ble_oob_t oob, ndef_pos_t pos) {
+    ndef_record_t record = {
+        .pos         = pos,
+        .tnf         = NDEF_TNF_MIME_MEDIA,
+        .type_len    = sizeof(NDEF_BLE_OOB_MIME_TYPE) - 1,
+        .type        = NDEF_BLE_OOB_MIME_TYPE,
+        .id_len      = oob.id_len,
+        .id          = oob.id,
+        .payload_len = oob.ad_len,
+        .payload     = oob.ad,
+    };
+    size_t start = data_out->len;
+    NDEF_RETURN_ON_FALSE(ndef_write_raw(data_out, &record), data_out->len = start;);
+    return data_out->len - start;
+}
@@ -3,15 +3,68 @@
 // SPDX-License-Identifier: MIT
 
 #include "ndef/common.h"
+#include "ndef/common_inline.h"
 #include <malloc.h>
 #include <string.h>
 
-// Reserve capacity.
-bool ndef_ostream_reserve(ndef_ostream_t* arr, size_t min_cap) {
+// Allocate `size` bytes from an arena.
+// Returns NULL if the arena is out of space.
+void* ndef_arena_alloc(ndef_arena_t* arena, size_t size) {
+    if (arena->cap - arena->len < size) {
+        return NULL;
+    }
+    void* mem   = arena->data + arena->len;
+    arena->len += size;
+    return mem;
+}
+
+// Whether `arr` holds the most recent allocation of its arena.
+static inline bool ndef_ostream_is_arena_top(const ndef_ostream_t* arr) {
+    return arr->data && arr->data + arr->cap == arr->arena->data + arr->arena->len;
+}
+
+// Reserve capacity in an arena-backed stream.
+static bool ndef_ostream_reserve_arena(ndef_ostream_t* arr, size_t min_cap) {
+    ndef_arena_t* arena = arr->arena;
+    if (ndef_ostream_is_arena_top(arr)) {
+        // Grow in place.
+        NDEF_RETURN_ON_FALSE(arena->cap - arena->len >= min_cap - arr->cap, ndef_ostream_fail(arr, NDEF_ERR_NO_MEM););
+        arena->len += min_cap - arr->cap;
+        arr->cap    = min_cap;
+        NDEF_STATS_MAX(peak_capacity, min_cap);
+        return true;
+    }
+    uint8_t* mem = NDEF_RETURN_ON_FALSE(ndef_arena_alloc(arena, min_cap), ndef_ostream_fail(arr, NDEF_ERR_NO_MEM););
+    if (arr->len) {
+        memcpy(mem, arr->data, arr->len);
+    }
+    NDEF_STATS_ADD(reallocs, 1);
+    arr->data = mem;
+    arr->cap  = min_cap;
+    NDEF_STATS_MAX(peak_capacity, min_cap);
+    return true;
+}
+
+// Grow an output stream to hold at least `min_cap` bytes; the slow path of `ndef_ostream_reserve`.
+bool ndef_ostream_grow(ndef_ostream_t* arr, size_t min_cap) {
     if (arr->len > min_cap) {
         min_cap = arr->len;
     }
-    if (min_cap & (min_cap - 1)) {
+    if (arr->cap >= min_cap) {
+        return true;
+    }
+
+    if (arr->mode == NDEF_OSTREAM_MODE_FIXED) {
+        ndef_ostream_fail(arr, NDEF_ERR_NO_SPACE);
+        return false;
+    } else if (arr->mode == NDEF_OSTREAM_MODE_ARENA) {
+        return ndef_ostream_reserve_arena(arr, min_cap);
+    }
+
+    if (min_cap < NDEF_OSTREAM_MIN_CAP) {
+        min_cap = NDEF_OSTREAM_MIN_CAP;
+    } else if ((min_cap & (min_cap - 1)) && min_cap <= SIZE_MAX / 2) {
+        // Above half the address space, the next power of two would wrap around to 0.
         min_cap |= min_cap >> 1;
         min_cap |= min_cap >> 2;
         min_cap |= min_cap >> 4;
@@ -23,87 +76,241 @@ bool ndef_ostream_reserve(ndef_ostream_t* arr, size_t min_cap) {
         min_cap++;
     }
 
-    if (!arr->len) {
+    NDEF_STATS_ADD(reallocs, 1);
+    void* mem = NDEF_RETURN_ON_FALSE(realloc(arr->data, min_cap), ndef_ostream_fail(arr, NDEF_ERR_NO_MEM););
+    arr->data = mem;
+    arr->cap  = min_cap;
+    NDEF_STATS_MAX(peak_capacity, min_cap);
+    return true;
+}
+
+// Release the memory owned by an output stream and make it empty.
+void ndef_ostream_free(ndef_ostream_t* arr) {
+    arr->len = 0;
+    if (arr->mode == NDEF_OSTREAM_MODE_FIXED) {
+        return;
+    } else if (arr->mode == NDEF_OSTREAM_MODE_ARENA) {
+        if (ndef_ostream_is_arena_top(arr)) {
+            arr->arena->len -= arr->cap;
+        }
+    } else {
         free(arr->data);
-        arr->data = NULL;
-        arr->cap  = 0;
-        return true;
     }
+    arr->data = NULL;
+    arr->cap  = 0;
+}
 
-    if (arr->cap >= min_cap) {
-        return true;
-    }
+// Try to write an NDEF record described by `record` whose payload is the concatenation of `slices`.
+bool ndef_write_raw_slices(ndef_ostream_t* data_out, const ndef_record_t* record, const ndef_slice_t* slices,
+                           size_t slices_len) {
+    // A total that overflows saturates, and the header rejects it.
+    ndef_record_t header = *record;
+    header.payload_len   = ndef_slices_len(slices, slices_len);
+    NDEF_RETURN_ON_FALSE(ndef_write_header(data_out, &header));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend_slices(data_out, slices, slices_len));
+    return true;
+}
 
-    void* mem = realloc(arr->data, min_cap);
-    if (mem) {
-        arr->data = mem;
-        arr->cap  = min_cap;
+// Get the encoded size of an NDEF record whose payload is split into chunks of at most `chunk_size` bytes.
+size_t ndef_chunked_encoded_size(size_t type_len, size_t id_len, size_t payload_len, size_t chunk_size) {
+    if (!chunk_size) {
+        return 0;
+    } else if (payload_len <= chunk_size) {
+        return ndef_record_encoded_size(type_len, id_len, payload_len);
+    }
+    size_t full_chunks = payload_len / chunk_size;
+    size_t last_len    = payload_len % chunk_size;
+    size_t size        = type_len + (id_len ? 1 + id_len : 0) + full_chunks * ndef_record_encoded_size(0, 0, chunk_size);
+    if (last_len) {
+        size += ndef_record_encoded_size(0, 0, last_len);
     }
-    return mem != NULL;
+    return size;
 }
 
-// Append one byte.
-bool ndef_ostream_push(ndef_ostream_t* arr, uint8_t value) {
-    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve(arr, arr->len + 1));
-    arr->data[arr->len++] = value;
-    return true;
-}
+// Try to write an NDEF record described by `record`, splitting its payload into chunks of at most `chunk_size` bytes.
+bool ndef_write_chunked(ndef_ostream_t* data_out, const ndef_record_t* record, size_t chunk_size) {
+    NDEF_RETURN_ON_FALSE(chunk_size, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    if (record->payload_len <= chunk_size) {
+        ndef_record_t single = *record;
+        single.chunked       = false;
+        return ndef_write_raw(data_out, &single);
+    }
+    size_t size = ndef_chunked_encoded_size(record->type_len, record->id_len, record->payload_len, chunk_size);
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve_extra(data_out, size));
 
-// Append multiple bytes.
-bool ndef_ostream_extend(ndef_ostream_t* arr, uint8_t* value, size_t value_len) {
-    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve(arr, arr->len + value_len));
-    memcpy(arr->data + arr->len, value, value_len);
-    arr->len += value_len;
-    return true;
+    ndef_record_t chunk = {
+        .pos      = record->pos & NDEF_POS_START,
+        .tnf      = record->tnf,
+        .type_len = record->type_len,
+        .type     = record->type,
+        .id_len   = record->id_len,
+        .id       = record->id,
+        .payload  = record->payload,
+        .chunked  = true,
+    };
+    size_t remaining = record->payload_len;
+    while (remaining > chunk_size) {
+        chunk.payload_len = chunk_size;
+        NDEF_RETURN_ON_FALSE(ndef_write_raw(data_out, &chunk));
+        chunk.pos       = NDEF_POS_MIDDLE;
+        chunk.tnf       = NDEF_TNF_UNCHANGED;
+        chunk.type_len  = 0;
+        chunk.type      = NULL;
+        chunk.id_len    = 0;
+        chunk.id        = NULL;
+        chunk.payload  += chunk_size;
+        remaining      -= chunk_size;
+    }
+    chunk.pos         = record->pos & NDEF_POS_END;
+    chunk.payload_len = remaining;
+    chunk.chunked     = false;
+    return ndef_write_raw(data_out, &chunk);
 }
 
-// Try to write an NDEF record without its payload.
-bool ndef_write_record(ndef_ostream_t* data_out, ndef_tnf_t tnf, const char* type, ndef_pos_t pos, size_t payload_len) {
-    bool    is_short = payload_len < 256;
-    uint8_t flags    = pos + is_short * NDEF_FLAG_SHORT_RECORD + tnf;
-    NDEF_RETURN_ON_FALSE(ndef_ostream_push(data_out, flags));
+// Begin writing an NDEF record whose payload length is not known in advance, such as a nested message.
+bool ndef_write_record_begin(ndef_ostream_t* data_out, ndef_tnf_t tnf, const char* type, ndef_pos_t pos,
+                             size_t* mark_out) {
     size_t type_len = type ? strlen(type) : 0;
-    NDEF_RETURN_ON_FALSE(ndef_ostream_push(data_out, type_len));
-    if (is_short) {
-        NDEF_RETURN_ON_FALSE(ndef_ostream_push(data_out, payload_len));
-    } else {
-        uint8_t len_bytes[4] = {
-            (uint8_t)(payload_len >> 24),
-            (uint8_t)(payload_len >> 16),
-            (uint8_t)(payload_len >> 8),
-            (uint8_t)(payload_len),
-        };
-        NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, len_bytes, sizeof(len_bytes)));
-    }
-    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, (uint8_t*)type, type_len));
+    NDEF_RETURN_ON_FALSE(type_len <= 255, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve_extra(data_out, 6 + type_len));
+    *mark_out = data_out->len;
+    // The 4-byte length field is filled in by `ndef_write_record_end`.
+    uint8_t header[6] = {pos + tnf, type_len, 0, 0, 0, 0};
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, header, sizeof(header)));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, (const uint8_t*)type, type_len));
     return true;
 }
 
-// Try to read an NDEF record.
-// Returns how long the record was read, or 0 on error.
-size_t ndef_read_record(ndef_istream_t* istream, ndef_record_t* well_known_out) {
-    NDEF_RETURN_ON_FALSE(ndef_istream_available(istream) >= 3);
-    size_t  index            = istream->index;
-    uint8_t flags            = istream->data[index++];
-    well_known_out->pos      = flags & (NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_MESSAGE_END);
-    well_known_out->type_len = istream->data[index++];
-    bool is_short            = flags & NDEF_FLAG_SHORT_RECORD;
-    if (is_short) {
-        NDEF_RETURN_ON_FALSE(ndef_istream_available(istream) >= 1);
-        well_known_out->payload_len = istream->data[index++];
+// Finish writing an NDEF record started with `ndef_write_record_begin`.
+size_t ndef_write_record_end(ndef_ostream_t* data_out, size_t mark) {
+    uint8_t* header      = data_out->data + mark;
+    size_t   type_len    = header[1];
+    size_t   payload_pos = mark + 6 + type_len;
+    NDEF_RETURN_ON_FALSE(data_out->len >= payload_pos, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    size_t payload_len = data_out->len - payload_pos;
+    NDEF_RETURN_ON_FALSE(payload_len <= UINT32_MAX, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    if (payload_len < 256) {
+        header[0] |= NDEF_FLAG_SHORT_RECORD;
+        header[2]  = payload_len;
+        memmove(header + 3, header + 6, type_len + payload_len);
+        data_out->len -= 3;
     } else {
-        NDEF_RETURN_ON_FALSE(ndef_istream_available(istream) >= 4);
-        uint32_t tmp  = 0;
-        tmp          |= (uint32_t)istream->data[index++] << 24;
-        tmp          |= (uint32_t)istream->data[index++] << 16;
-        tmp          |= (uint32_t)istream->data[index++] << 8;
-        tmp          |= (uint32_t)istream->data[index++];
-
-        well_known_out->payload_len = tmp;
-    }
-    NDEF_RETURN_ON_FALSE(ndef_istream_available(istream) >= well_known_out->type_len + well_known_out->payload_len);
-    well_known_out->type     = (const char*)(istream->data + index);
-    index                   += well_known_out->type_len;
-    well_known_out->payload  = istream->data + index;
-    return index - istream->index + well_known_out->payload_len;
+        header[2] = payload_len >> 24;
+        header[3] = payload_len >> 16;
+        header[4] = payload_len >> 8;
+        header[5] = payload_len;
+    }
+    NDEF_STATS_ADD(bytes_encoded, data_out->len - mark);
+    return data_out->len - mark;
+}
+
+// Record that the chunk at `offset` does not continue the chunked record before it.
+static void ndef_read_bad_chunk(ndef_istream_t* istream, size_t offset) {
+    NDEF_STATS_FAIL(CHUNK);
+    ndef_istream_fail(istream, NDEF_ERR_MALFORMED, offset);
+}
+
+// Read the chunks of a record, advancing `istream` past them.
+// Returns the number of chunks, or 0 on error.
+static size_t ndef_read_chunks(ndef_istream_t* istream, ndef_record_t* record_out, ndef_slice_t* slices,
+                               size_t slices_cap) {
+    size_t slices_len = 0;
+    size_t offset     = istream->index;
+    NDEF_RETURN_ON_FALSE(ndef_read_record(istream, record_out));
+    NDEF_RETURN_ON_FALSE(record_out->tnf != NDEF_TNF_UNCHANGED, ndef_read_bad_chunk(istream, offset););
+
+    ndef_record_t chunk = *record_out;
+    while (true) {
+        if (slices) {
+            NDEF_RETURN_ON_FALSE(slices_len < slices_cap, ndef_istream_fail(istream, NDEF_ERR_NO_SPACE, offset););
+            slices[slices_len] = (ndef_slice_t){chunk.payload, chunk.payload_len};
+        }
+        slices_len++;
+        if (!chunk.chunked) {
+            break;
+        }
+        // Following chunks have no type and may not begin a message.
+        offset = istream->index;
+        NDEF_RETURN_ON_FALSE(!(chunk.pos & NDEF_POS_END), ndef_read_bad_chunk(istream, offset););
+        NDEF_RETURN_ON_FALSE(ndef_read_record(istream, &chunk));
+        NDEF_RETURN_ON_FALSE(chunk.tnf == NDEF_TNF_UNCHANGED && chunk.type_len == 0 && chunk.id_len == 0,
+                             ndef_read_bad_chunk(istream, offset););
+        NDEF_RETURN_ON_FALSE(!(chunk.pos & NDEF_POS_START), ndef_read_bad_chunk(istream, offset););
+        NDEF_RETURN_ON_FALSE(record_out->payload_len <= SIZE_MAX - chunk.payload_len,
+                             ndef_read_bad_chunk(istream, offset););
+        record_out->payload_len += chunk.payload_len;
+    }
+    record_out->pos     |= chunk.pos & NDEF_POS_END;
+    record_out->chunked  = false;
+    if (slices_len > 1) {
+        record_out->payload = NULL;
+    }
+    return slices_len;
+}
+
+// Try to read an NDEF record that may be split into chunks.
+// Returns how long the chunks were read, or 0 on error or if there are more than `slices_cap` chunks.
+size_t ndef_read_chunked(ndef_istream_t* istream, ndef_record_t* record_out, ndef_slice_t* slices, size_t slices_cap,
+                         size_t* slices_len_out) {
+    // Read from a copy so that `istream` is left where it was on error.
+    ndef_istream_t tmp        = *istream;
+    size_t         slices_len = NDEF_RETURN_ON_FALSE(ndef_read_chunks(&tmp, record_out, slices, slices_cap),
+                                                     istream->result = tmp.result;);
+    size_t         record_len = tmp.index - istream->index;
+    istream->index            = tmp.index;
+    *slices_len_out           = slices_len;
+    return record_len;
+}
+
+// Try to read an NDEF record that may be split into chunks, reassembling the payload in `payload_out`.
+// Returns how long the chunks were read, or 0 on error.
+size_t ndef_read_chunked_into(ndef_istream_t* istream, ndef_record_t* record_out, ndef_ostream_t* payload_out) {
+    // Find the total length first so the payload is reserved once.
+    size_t         start = istream->index;
+    size_t         slices_len;
+    size_t         record_len = NDEF_RETURN_ON_FALSE(ndef_read_chunked(istream, record_out, NULL, 0, &slices_len));
+    ndef_istream_t chunks     = {.data = istream->data, .len = istream->index, .index = start};
+    size_t         offset     = payload_out->len;
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve_extra(payload_out, record_out->payload_len), istream->index = start;
+                         ndef_istream_fail(istream, payload_out->result.err, start););
+
+    for (size_t i = 0; i < slices_len; i++) {
+        ndef_record_t chunk = {0};
+        ndef_read_record(&chunks, &chunk);
+        ndef_ostream_extend(payload_out, chunk.payload, chunk.payload_len);
+    }
+    record_out->payload = payload_out->data + offset;
+    return record_len;
+}
+
+// Read the next record of an NDEF message, checking that only the first record has the message begin flag.
+// Returns how long the record was read, or 0 at the end of the message or on error.
+size_t ndef_message_next(ndef_message_iter_t* iter, ndef_record_t* record_out) {
+    NDEF_STATS_FN(MESSAGE_NEXT);
+    ndef_istream_t* istream = iter->istream;
+    NDEF_RETURN_ON_FALSE(!iter->ended, ndef_istream_fail(istream, NDEF_ERR_END, istream->index););
+    size_t record_len = NDEF_RETURN_ON_FALSE(ndef_read_record(istream, record_out));
+    bool   is_begin   = record_out->pos & NDEF_POS_START;
+    NDEF_RETURN_ON_FALSE(is_begin == (iter->count == 0), NDEF_STATS_FAIL(MESSAGE_FLAGS);
+                         istream->index -= record_len; ndef_istream_fail(istream, NDEF_ERR_MALFORMED, istream->index););
+    iter->count++;
+    iter->ended = record_out->pos & NDEF_POS_END;
+    return record_len;
+}
+
+// Get a short name for an error, for logging.
+const char* ndef_err_name(ndef_err_t err) {
+    switch (err) {
+        case NDEF_OK: return "ok";
+        case NDEF_ERR_TRUNCATED: return "truncated";
+        case NDEF_ERR_MALFORMED: return "malformed";
+        case NDEF_ERR_TYPE: return "type";
+        case NDEF_ERR_PAYLOAD: return "payload";
+        case NDEF_ERR_END: return "end";
+        case NDEF_ERR_NO_MEM: return "no_mem";
+        case NDEF_ERR_NO_SPACE: return "no_space";
+        case NDEF_ERR_INVALID_ARG: return "invalid_arg";
+        case NDEF_ERR_ABORTED: return "aborted";
+    }
+    return "unknown";
 }
@@ -0,0 +1,70 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/diff.h"
+#include <string.h>
+
+// Find the first byte at or after `index` that differs, comparing a word at a time while the data is equal.
+static size_t ndef_diff_next_change(const uint8_t* old_data, const uint8_t* new_data, size_t common, size_t index) {
+    while (index + sizeof(uint64_t) <= common) {
+        uint64_t a, b;
+        memcpy(&a, old_data + index, sizeof(a));
+        memcpy(&b, new_data + index, sizeof(b));
+        if (a != b) {
+            break;
+        }
+        index += sizeof(uint64_t);
+    }
+    while (index < common && old_data[index] == new_data[index]) {
+        index++;
+    }
+    return index;
+}
+
+// Find the ranges of `new_data` that differ from `old_data`, with blocks aligned in tag memory where `new_data` starts
+// at `base_offset`.
+size_t ndef_diff_at(const uint8_t* old_data, size_t old_len, const uint8_t* new_data, size_t new_len,
+                    size_t base_offset, size_t block_size, ndef_diff_range_t* ranges_out, size_t cap) {
+    NDEF_STATS_FN(DIFF);
+    NDEF_RETURN_ON_FALSE(cap);
+    size_t unit   = block_size > 1 ? block_size : 1;
+    // How far into its block the data starts.
+    size_t skew   = base_offset % unit;
+    size_t common = old_len < new_len ? old_len : new_len;
+    size_t count  = 0;
+    size_t index  = 0;
+    while (index < new_len) {
+        size_t start = ndef_diff_next_change(old_data, new_data, common, index);
+        if (start >= new_len) {
+            break;
+        }
+        size_t end = start + 1;
+        while (end < new_len && (end >= common || old_data[end] != new_data[end])) {
+            end++;
+        }
+        // Widen to whole blocks; the part of the last block after `end` is covered, so continue after it.
+        // The first block may begin before the data, in which case the range starts with the data.
+        start += skew;
+        start  = start - start % unit >= skew ? start - start % unit - skew : 0;
+        end   += skew;
+        if (end % unit) {
+            end += unit - end % unit;
+        }
+        end   -= skew;
+        end    = end < new_len ? end : new_len;
+        index  = end;
+
+        ndef_diff_range_t* last = count ? &ranges_out[count - 1] : NULL;
+        if (last && start <= last->offset + last->len) {
+            last->len = end - last->offset;
+        } else if (count < cap) {
+            ranges_out[count++] = (ndef_diff_range_t){start, end - start};
+        } else {
+            // Out of ranges; cover everything that is left.
+            last->len = new_len - last->offset;
+            break;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,78 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/external.h"
+
+// Decode an NDEF external type record that has already been read.
+bool ndef_external_decode(const ndef_record_t* record, ndef_external_t* external_out) {
+    NDEF_RETURN_ON_FALSE(record->tnf == NDEF_TNF_EXTERNAL_TYPE && record->type_len > 0);
+    *external_out = (ndef_external_t){
+        .pos         = record->pos,
+        .type        = record->type,
+        .type_len    = record->type_len,
+        .payload     = record->payload,
+        .payload_len = record->payload_len,
+    };
+    return true;
+}
+
+// Read an NDEF external type record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_external_read(ndef_istream_t* istream, ndef_external_t* external_out) {
+    ndef_record_t record;
+    size_t        record_len = NDEF_RETURN_ON_FALSE(ndef_read_record(istream, &record));
+    NDEF_RETURN_ON_FALSE(ndef_external_decode(&record, external_out), ndef_istream_reject(istream, record_len, false););
+    return record_len;
+}
+
+// Write an NDEF external type record.
+bool ndef_external_write(ndef_ostream_t* data_out, ndef_external_t external, ndef_pos_t pos) {
+    ndef_slice_t slice = {external.payload, external.payload_len};
+    return ndef_external_write_slices(data_out, external.type, external.type_len, &slice, 1, pos);
+}
+
+// Write an NDEF external type record whose payload is the concatenation of `slices`.
+bool ndef_external_write_slices(ndef_ostream_t* data_out, const char* type, size_t type_len,
+                                const ndef_slice_t* slices, size_t slices_len, ndef_pos_t pos) {
+    NDEF_RETURN_ON_FALSE(type_len > 0, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    ndef_record_t record = {
+        .pos      = pos,
+        .tnf      = NDEF_TNF_EXTERNAL_TYPE,
+        .type_len = type_len,
+        .type     = type,
+    };
+    return ndef_write_raw_slices(data_out, &record, slices, slices_len);
+}
+
+// Whether a record is an Android Application Record.
+static bool ndef_aar_is_type(const ndef_record_t* record) {
+    return ndef_record_is_type(record, NDEF_TNF_EXTERNAL_TYPE, NDEF_AAR_TYPE, sizeof(NDEF_AAR_TYPE) - 1);
+}
+
+// Decode an Android Application Record that has already been read.
+bool ndef_aar_decode(const ndef_record_t* record, ndef_aar_t* aar_out) {
+    NDEF_RETURN_ON_FALSE(ndef_aar_is_type(record));
+    NDEF_RETURN_ON_FALSE(record->payload_len > 0);
+    aar_out->pos         = record->pos;
+    aar_out->package     = (const char*)record->payload;
+    aar_out->package_len = record->payload_len;
+    return true;
+}
+
+// Read an Android Application Record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_aar_read(ndef_istream_t* istream, ndef_aar_t* aar_out) {
+    ndef_record_t record;
+    size_t        record_len = NDEF_RETURN_ON_FALSE(ndef_read_record(istream, &record));
+    NDEF_RETURN_ON_FALSE(ndef_aar_decode(&record, aar_out),
+                         ndef_istream_reject(istream, record_len, ndef_aar_is_type(&record)););
+    return record_len;
+}
+
+// Write an Android Application Record.
+bool ndef_aar_write(ndef_ostream_t* data_out, ndef_aar_t aar, ndef_pos_t pos) {
+    NDEF_RETURN_ON_FALSE(aar.package_len > 0, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    ndef_slice_t slice = {(const uint8_t*)aar.package, aar.package_len};
+    return ndef_external_write_slices(data_out, NDEF_AAR_TYPE, sizeof(NDEF_AAR_TYPE) - 1, &slice, 1, pos);
+}
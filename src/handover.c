@@ -0,0 +1,242 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/handover.h"
+
+// Get the length of `count` auxiliary data references at the start of `data`.
+// Returns false if they do not fit in `len` bytes.
+static bool ndef_handover_aux_len(const uint8_t* data, size_t len, size_t count, size_t* aux_len_out) {
+    size_t index = 0;
+    for (size_t i = 0; i < count; i++) {
+        NDEF_RETURN_ON_FALSE(index < len && len - index - 1 >= data[index]);
+        index += 1 + data[index];
+    }
+    *aux_len_out = index;
+    return true;
+}
+
+// Decode the payload of an Alternative Carrier record that has already been read.
+bool ndef_handover_ac_decode(const ndef_record_t* record, ndef_handover_ac_t* ac_out) {
+    NDEF_RETURN_ON_FALSE(ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "ac", 2));
+    const uint8_t* payload = record->payload;
+    size_t         len     = record->payload_len;
+    NDEF_RETURN_ON_FALSE(len >= 3 && len - 3 >= payload[1], NDEF_STATS_FAIL(PAYLOAD););
+    size_t ref_len = payload[1];
+
+    *ac_out = (ndef_handover_ac_t){
+        .cps             = payload[0] & 0x03,
+        .carrier_ref     = (const char*)payload + 2,
+        .carrier_ref_len = ref_len,
+        .aux_count       = payload[2 + ref_len],
+        .aux_refs        = payload + 3 + ref_len,
+    };
+    // Bytes after the references are reserved for future versions and ignored.
+    NDEF_RETURN_ON_FALSE(
+        ndef_handover_aux_len(ac_out->aux_refs, len - 3 - ref_len, ac_out->aux_count, &ac_out->aux_refs_len),
+        NDEF_STATS_FAIL(PAYLOAD););
+    return true;
+}
+
+// Get the next auxiliary data reference of an Alternative Carrier.
+bool ndef_handover_next_aux(const ndef_handover_ac_t* ac, size_t* offset, const char** ref_out, size_t* ref_len_out) {
+    NDEF_RETURN_ON_FALSE(*offset < ac->aux_refs_len);
+    size_t ref_len = ac->aux_refs[*offset];
+    NDEF_RETURN_ON_FALSE(ac->aux_refs_len - *offset - 1 >= ref_len);
+    *ref_out      = (const char*)ac->aux_refs + *offset + 1;
+    *ref_len_out  = ref_len;
+    *offset      += 1 + ref_len;
+    return true;
+}
+
+// Whether a record is a Handover Select or Handover Request record.
+static inline bool ndef_handover_is_type(const ndef_record_t* record) {
+    return ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Hs", 2) ||
+           ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Hr", 2);
+}
+
+// Decode the payload of an NDEF Handover Select or Handover Request record that has already been read.
+bool ndef_handover_decode(const ndef_record_t* record, ndef_handover_t* handover_out) {
+    NDEF_RETURN_ON_FALSE(ndef_handover_is_type(record));
+    // Later minor versions are compatible.
+    NDEF_RETURN_ON_FALSE(record->payload_len >= 1 && (record->payload[0] >> 4) == (NDEF_HANDOVER_VERSION >> 4),
+                         NDEF_STATS_FAIL(PAYLOAD););
+
+    *handover_out = (ndef_handover_t){
+        .pos         = record->pos,
+        .request     = record->type[1] == 'r',
+        .version     = record->payload[0],
+        .records     = record->payload + 1,
+        .records_len = record->payload_len - 1,
+    };
+    ndef_istream_t      inner = NDEF_ISTREAM_NEW(handover_out->records, handover_out->records_len);
+    ndef_message_iter_t iter  = NDEF_MESSAGE_ITER_NEW(&inner);
+
+    // Walk the inner message once, counting the carriers instead of storing them.
+    // A handover record without alternative carriers has an empty inner message.
+    while (ndef_istream_available(&inner) && !ndef_message_done(&iter)) {
+        ndef_record_t child;
+        NDEF_RETURN_ON_FALSE(ndef_message_next(&iter, &child));
+
+        ndef_handover_ac_t ac;
+        if (ndef_record_is_type(&child, NDEF_TNF_WELL_KNOWN, "ac", 2)) {
+            NDEF_RETURN_ON_FALSE(ndef_handover_ac_decode(&child, &ac));
+            handover_out->carriers_len++;
+        } else if (ndef_record_is_type(&child, NDEF_TNF_WELL_KNOWN, "cr", 2)) {
+            NDEF_RETURN_ON_FALSE(child.payload_len == 2, NDEF_STATS_FAIL(PAYLOAD););
+            handover_out->has_collision = true;
+            handover_out->collision     = (uint16_t)child.payload[0] << 8 | child.payload[1];
+        } else if (ndef_record_is_type(&child, NDEF_TNF_WELL_KNOWN, "err", 3)) {
+            NDEF_RETURN_ON_FALSE(child.payload_len >= 1, NDEF_STATS_FAIL(PAYLOAD););
+            handover_out->err          = child.payload[0];
+            handover_out->err_data     = child.payload + 1;
+            handover_out->err_data_len = child.payload_len - 1;
+        }
+    }
+    return true;
+}
+
+// Read an NDEF Handover Select or Handover Request record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_handover_read(ndef_istream_t* istream, ndef_handover_t* handover_out) {
+    ndef_record_t record;
+    size_t        record_len = NDEF_RETURN_ON_FALSE(ndef_read_record(istream, &record));
+    NDEF_RETURN_ON_FALSE(ndef_handover_decode(&record, handover_out),
+                         ndef_istream_reject(istream, record_len, ndef_handover_is_type(&record)););
+    return record_len;
+}
+
+// Get the next alternative carrier of a handover record read by `ndef_handover_read`.
+bool ndef_handover_next_carrier(const ndef_handover_t* handover, size_t* offset, ndef_handover_ac_t* ac_out) {
+    ndef_istream_t inner = {.data = handover->records, .len = handover->records_len, .index = *offset};
+    while (ndef_istream_available(&inner)) {
+        ndef_record_t child;
+        NDEF_RETURN_ON_FALSE(ndef_read_record(&inner, &child));
+        // Like the decoder, ignore anything after the last record of the inner message.
+        if (child.pos & NDEF_POS_END) {
+            inner.index = inner.len;
+        }
+        if (ndef_handover_ac_decode(&child, ac_out)) {
+            *offset = inner.index;
+            return true;
+        }
+    }
+    *offset = inner.index;
+    return false;
+}
+
+// Find the carrier configuration record that an alternative carrier refers to in the NDEF message `message`.
+bool ndef_handover_find_config(const uint8_t* message, size_t message_len, const ndef_handover_ac_t* ac,
+                               ndef_record_t* config_out) {
+    NDEF_RETURN_ON_FALSE(ac->carrier_ref_len > 0);
+    ndef_istream_t      istream = NDEF_ISTREAM_NEW(message, message_len);
+    ndef_message_iter_t iter    = NDEF_MESSAGE_ITER_NEW(&istream);
+    while (!ndef_message_done(&iter)) {
+        NDEF_RETURN_ON_FALSE(ndef_message_next(&iter, config_out));
+        if (config_out->id_len == ac->carrier_ref_len &&
+            memcmp(config_out->id, ac->carrier_ref, ac->carrier_ref_len) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whether a handover record is written from its inner message as read instead of from its fields.
+static inline bool ndef_handover_is_verbatim(const ndef_handover_t* handover) {
+    return !handover->carriers && handover->records;
+}
+
+// Get the number of inner records of a handover record that is written from its fields.
+static size_t ndef_handover_count(const ndef_handover_t* handover) {
+    return handover->has_collision + handover->carriers_len + (handover->err != NDEF_HANDOVER_ERR_NONE);
+}
+
+// Get the payload size of an NDEF handover record.
+size_t ndef_handover_payload_size(const ndef_handover_t handover) {
+    if (ndef_handover_is_verbatim(&handover)) {
+        return 1 + handover.records_len;
+    }
+    size_t size = 1;
+    if (handover.has_collision) {
+        size += ndef_record_encoded_size(2, 0, 2);
+    }
+    for (size_t i = 0; i < handover.carriers_len; i++) {
+        size += ndef_record_encoded_size(2, 0, ndef_handover_ac_payload_size(handover.carriers[i]));
+    }
+    if (handover.err != NDEF_HANDOVER_ERR_NONE) {
+        size += ndef_record_encoded_size(3, 0, 1 + handover.err_data_len);
+    }
+    return size;
+}
+
+// Whether the fields of a handover record can be written.
+static bool ndef_handover_valid(const ndef_handover_t* handover) {
+    if (ndef_handover_is_verbatim(handover)) {
+        return true;
+    }
+    NDEF_RETURN_ON_FALSE(handover->carriers || !handover->carriers_len);
+    NDEF_RETURN_ON_FALSE(!handover->request || handover->has_collision);
+    NDEF_RETURN_ON_FALSE(handover->err <= 0xff && handover->err_data_len <= 0xff);
+    for (size_t i = 0; i < handover->carriers_len; i++) {
+        const ndef_handover_ac_t* ac = &handover->carriers[i];
+        size_t                    aux_refs_len;
+        NDEF_RETURN_ON_FALSE(ac->carrier_ref_len > 0 && ac->carrier_ref_len <= 0xff && ac->aux_count <= 0xff);
+        NDEF_RETURN_ON_FALSE(ndef_handover_aux_len(ac->aux_refs, ac->aux_refs_len, ac->aux_count, &aux_refs_len) &&
+                             aux_refs_len == ac->aux_refs_len);
+    }
+    return true;
+}
+
+// Write an Alternative Carrier record.
+static bool ndef_handover_ac_write(ndef_ostream_t* ostream, const ndef_handover_ac_t* ac, ndef_pos_t pos) {
+    NDEF_RETURN_ON_FALSE(
+        ndef_write_record(ostream, NDEF_TNF_WELL_KNOWN, "ac", pos, ndef_handover_ac_payload_size(*ac)));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_push(ostream, ac->cps));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_push(ostream, ac->carrier_ref_len));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(ostream, (const uint8_t*)ac->carrier_ref, ac->carrier_ref_len));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_push(ostream, ac->aux_count));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(ostream, ac->aux_refs, ac->aux_refs_len));
+    return true;
+}
+
+// Write the inner records of a handover record.
+static bool ndef_handover_write_inner(ndef_ostream_t* ostream, const ndef_handover_t* handover) {
+    if (ndef_handover_is_verbatim(handover)) {
+        return ndef_ostream_extend(ostream, handover->records, handover->records_len);
+    }
+    size_t count = ndef_handover_count(handover);
+    size_t index = 0;
+
+    // The collision resolution record comes first in a Handover Request.
+    if (handover->has_collision) {
+        uint8_t collision[2] = {handover->collision >> 8, handover->collision};
+        NDEF_RETURN_ON_FALSE(ndef_write_record(ostream, NDEF_TNF_WELL_KNOWN, "cr", ndef_pos_at(index++, count), 2));
+        NDEF_RETURN_ON_FALSE(ndef_ostream_extend(ostream, collision, sizeof(collision)));
+    }
+    for (size_t i = 0; i < handover->carriers_len; i++) {
+        NDEF_RETURN_ON_FALSE(ndef_handover_ac_write(ostream, &handover->carriers[i], ndef_pos_at(index++, count)));
+    }
+    if (handover->err != NDEF_HANDOVER_ERR_NONE) {
+        NDEF_RETURN_ON_FALSE(ndef_write_record(ostream, NDEF_TNF_WELL_KNOWN, "err", ndef_pos_at(index++, count),
+                                               1 + handover->err_data_len));
+        NDEF_RETURN_ON_FALSE(ndef_ostream_push(ostream, handover->err));
+        NDEF_RETURN_ON_FALSE(ndef_ostream_extend(ostream, handover->err_data, handover->err_data_len));
+    }
+    return true;
+}
+
+// Write an NDEF Handover Select or Handover Request record.
+// Returns how long the record was written, or 0 on error.
+size_t ndef_handover_write(ndef_ostream_t* ostream, const ndef_handover_t handover, ndef_pos_t pos) {
+    NDEF_RETURN_ON_FALSE(ndef_handover_valid(&handover), ndef_ostream_fail(ostream, NDEF_ERR_INVALID_ARG););
+
+    // The header reserves space for the whole payload, so the inner records are written in place.
+    size_t start = ostream->len;
+    NDEF_RETURN_ON_FALSE(ndef_write_record(ostream, NDEF_TNF_WELL_KNOWN, handover.request ? "Hr" : "Hs", pos,
+                                           ndef_handover_payload_size(handover)));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_push(ostream, handover.version ? handover.version : NDEF_HANDOVER_VERSION),
+                         ostream->len = start;);
+    NDEF_RETURN_ON_FALSE(ndef_handover_write_inner(ostream, &handover), ostream->len = start;);
+
+    return ostream->len - start;
+}
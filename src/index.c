@@ -0,0 +1,135 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/index.h"
+#include <stdlib.h>
+
+// Hash some bytes with 32-bit FNV-1a, continuing from `hash`.
+static uint32_t ndef_index_hash(uint32_t hash, const void* data, size_t len) {
+    const uint8_t* bytes = data;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Hash a type name format and type, folding ASCII case if the type name format requires it.
+static inline uint32_t ndef_index_hash_type(ndef_tnf_t tnf, const char* type, size_t type_len) {
+    uint8_t  tnf_byte = tnf;
+    uint32_t hash     = ndef_index_hash(2166136261u, &tnf_byte, 1);
+    if (!ndef_tnf_folds_case(tnf)) {
+        return ndef_index_hash(hash, type, type_len);
+    }
+    for (size_t i = 0; i < type_len; i++) {
+        uint8_t c = ndef_ascii_lower(type[i]);
+        hash      = ndef_index_hash(hash, &c, 1);
+    }
+    return hash;
+}
+
+// Hash an ID.
+static inline uint32_t ndef_index_hash_id(const char* id, size_t id_len) {
+    return ndef_index_hash(2166136261u, id, id_len);
+}
+
+// Order entries by hash, then by offset so that equal keys stay in message order.
+static int ndef_index_compare(const void* a_ptr, const void* b_ptr) {
+    const ndef_index_entry_t* a = a_ptr;
+    const ndef_index_entry_t* b = b_ptr;
+    if (a->hash != b->hash) {
+        return a->hash < b->hash ? -1 : 1;
+    }
+    return a->offset < b->offset ? -1 : a->offset > b->offset;
+}
+
+// Find the first entry with a given hash.
+static size_t ndef_index_lower_bound(const ndef_index_entry_t* entries, size_t len, uint32_t hash) {
+    size_t lo = 0;
+    size_t hi = len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (entries[mid].hash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Read the record an entry refers to.
+static inline size_t ndef_index_read(const ndef_index_t* index, const ndef_index_entry_t* entry,
+                                     ndef_record_t* record_out) {
+    ndef_istream_t istream = {.data = index->data, .len = index->len, .index = entry->offset};
+    return ndef_read_record(&istream, record_out);
+}
+
+// Build an index of an NDEF message in one pass.
+bool ndef_index_build(ndef_index_t* index, const uint8_t* data, size_t len, ndef_index_entry_t* entries,
+                      size_t entries_cap) {
+    NDEF_RETURN_ON_FALSE(len <= UINT32_MAX);
+    *index = (ndef_index_t){
+        .data    = data,
+        .len     = len,
+        .by_type = entries,
+    };
+
+    // Type entries grow up from the start of `entries`, ID entries down from the end.
+    ndef_istream_t      istream = NDEF_ISTREAM_NEW(data, len);
+    ndef_message_iter_t iter    = NDEF_MESSAGE_ITER_NEW(&istream);
+    ndef_index_entry_t* id_end  = entries + entries_cap;
+    while (!ndef_message_done(&iter)) {
+        size_t        offset = istream.index;
+        ndef_record_t record;
+        NDEF_RETURN_ON_FALSE(ndef_message_next(&iter, &record));
+        if (record.tnf == NDEF_TNF_UNCHANGED) {
+            continue;
+        }
+        NDEF_RETURN_ON_FALSE(index->by_type_len + index->by_id_len < entries_cap);
+        index->by_type[index->by_type_len++] = (ndef_index_entry_t){
+            ndef_index_hash_type(record.tnf, record.type, record.type_len),
+            offset,
+        };
+        if (record.id_len) {
+            NDEF_RETURN_ON_FALSE(index->by_type_len + index->by_id_len < entries_cap);
+            index->by_id_len++;
+            id_end[-(ptrdiff_t)index->by_id_len] = (ndef_index_entry_t){
+                ndef_index_hash_id(record.id, record.id_len),
+                offset,
+            };
+        }
+    }
+    index->by_id = id_end - index->by_id_len;
+
+    qsort(index->by_type, index->by_type_len, sizeof(ndef_index_entry_t), ndef_index_compare);
+    qsort(index->by_id, index->by_id_len, sizeof(ndef_index_entry_t), ndef_index_compare);
+    return true;
+}
+
+// Find the record with a given ID.
+size_t ndef_index_find_id(const ndef_index_t* index, const char* id, size_t id_len, ndef_record_t* record_out) {
+    uint32_t hash = ndef_index_hash_id(id, id_len);
+    for (size_t i = ndef_index_lower_bound(index->by_id, index->by_id_len, hash);
+         i < index->by_id_len && index->by_id[i].hash == hash; i++) {
+        size_t record_len = ndef_index_read(index, &index->by_id[i], record_out);
+        if (record_len && record_out->id_len == id_len && memcmp(record_out->id, id, id_len) == 0) {
+            return record_len;
+        }
+    }
+    return 0;
+}
+
+// Find the `nth` record, counting from 0 in message order, with a given type name format and type.
+size_t ndef_index_find_type(const ndef_index_t* index, ndef_tnf_t tnf, const char* type, size_t type_len, size_t nth,
+                            ndef_record_t* record_out) {
+    uint32_t hash = ndef_index_hash_type(tnf, type, type_len);
+    for (size_t i = ndef_index_lower_bound(index->by_type, index->by_type_len, hash);
+         i < index->by_type_len && index->by_type[i].hash == hash; i++) {
+        size_t record_len = ndef_index_read(index, &index->by_type[i], record_out);
+        if (record_len && ndef_record_is_type(record_out, tnf, type, type_len) && nth-- == 0) {
+            return record_len;
+        }
+    }
+    return 0;
+}
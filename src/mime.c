@@ -0,0 +1,46 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/mime.h"
+
+// Decode an NDEF MIME record that has already been read.
+bool ndef_mime_decode(const ndef_record_t* record, ndef_mime_t* mime_out) {
+    NDEF_RETURN_ON_FALSE(record->tnf == NDEF_TNF_MIME_MEDIA && record->type_len > 0);
+    *mime_out = (ndef_mime_t){
+        .pos         = record->pos,
+        .type        = record->type,
+        .type_len    = record->type_len,
+        .payload     = record->payload,
+        .payload_len = record->payload_len,
+    };
+    return true;
+}
+
+// Read an NDEF MIME record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_mime_read(ndef_istream_t* istream, ndef_mime_t* mime_out) {
+    ndef_record_t record;
+    size_t        record_len = NDEF_RETURN_ON_FALSE(ndef_read_record(istream, &record));
+    NDEF_RETURN_ON_FALSE(ndef_mime_decode(&record, mime_out), ndef_istream_reject(istream, record_len, false););
+    return record_len;
+}
+
+// Write an NDEF MIME record.
+bool ndef_mime_write(ndef_ostream_t* data_out, ndef_mime_t mime, ndef_pos_t pos) {
+    ndef_slice_t slice = {mime.payload, mime.payload_len};
+    return ndef_mime_write_slices(data_out, mime.type, mime.type_len, &slice, 1, pos);
+}
+
+// Write an NDEF MIME record whose payload is the concatenation of `slices`.
+bool ndef_mime_write_slices(ndef_ostream_t* data_out, const char* type, size_t type_len, const ndef_slice_t* slices,
+                            size_t slices_len, ndef_pos_t pos) {
+    NDEF_RETURN_ON_FALSE(type_len > 0, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    ndef_record_t record = {
+        .pos      = pos,
+        .tnf      = NDEF_TNF_MIME_MEDIA,
+        .type_len = type_len,
+        .type     = type,
+    };
+    return ndef_write_raw_slices(data_out, &record, slices, slices_len);
+}
@@ -3,3 +3,298 @@
 // SPDX-License-Identifier: MIT
 
 #include "ndef.h"
+
+// Decode a record with the built-in decoder for its type, storing in `known_out` whether there is one.
+// The decoder is picked by a switch on the type name format and type length, so at most one type is compared.
+static ndef_decd_type_t ndef_decd_builtin(const ndef_record_t* record, ndef_decd_record_t* decd_out,
+                                          bool* known_out) {
+    *known_out = false;
+    switch (record->tnf) {
+        case NDEF_TNF_WELL_KNOWN:
+            if (record->type_len == 1 && record->type[0] == 'U') {
+                *known_out = true;
+                return ndef_uri_decode(record, &decd_out->data.uri) ? NDEF_DECD_TYPE_URI : NDEF_DECD_TYPE_UNKNOWN;
+            } else if (record->type_len == 1 && record->type[0] == 'T') {
+                *known_out = true;
+                return ndef_text_decode(record, &decd_out->data.text) ? NDEF_DECD_TYPE_TEXT : NDEF_DECD_TYPE_UNKNOWN;
+            } else if (ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Sp", 2)) {
+                *known_out = true;
+                return ndef_smartposter_decode(record, &decd_out->data.smartposter, NULL, 0)
+                           ? NDEF_DECD_TYPE_SMART_POSTER
+                           : NDEF_DECD_TYPE_UNKNOWN;
+            } else if (ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Hs", 2) ||
+                       ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Hr", 2)) {
+                *known_out = true;
+                return ndef_handover_decode(record, &decd_out->data.handover) ? NDEF_DECD_TYPE_HANDOVER
+                                                                              : NDEF_DECD_TYPE_UNKNOWN;
+            } else if (ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Sig", 3)) {
+                *known_out = true;
+                return ndef_sig_decode(record, &decd_out->data.sig) ? NDEF_DECD_TYPE_SIGNATURE : NDEF_DECD_TYPE_UNKNOWN;
+            }
+            return NDEF_DECD_TYPE_UNKNOWN;
+
+        case NDEF_TNF_MIME_MEDIA:
+            // Malformed Wi-Fi and Bluetooth LE records are still exposed as MIME records.
+            if (record->type_len == sizeof(NDEF_WIFI_MIME_TYPE) - 1 && ndef_wifi_decode(record, &decd_out->data.wifi)) {
+                return NDEF_DECD_TYPE_WIFI;
+            } else if (record->type_len == sizeof(NDEF_BLE_OOB_MIME_TYPE) - 1 &&
+                       ndef_ble_oob_decode(record, &decd_out->data.ble_oob)) {
+                return NDEF_DECD_TYPE_BLE_OOB;
+            }
+            return ndef_mime_decode(record, &decd_out->data.mime) ? NDEF_DECD_TYPE_MIME : NDEF_DECD_TYPE_UNKNOWN;
+
+        case NDEF_TNF_EXTERNAL_TYPE:
+            if (record->type_len == sizeof(NDEF_AAR_TYPE) - 1 && ndef_aar_decode(record, &decd_out->data.aar)) {
+                return NDEF_DECD_TYPE_AAR;
+            }
+            return ndef_external_decode(record, &decd_out->data.external) ? NDEF_DECD_TYPE_EXTERNAL
+                                                                         : NDEF_DECD_TYPE_UNKNOWN;
+
+        default:
+            return NDEF_DECD_TYPE_UNKNOWN;
+    }
+}
+
+// Decode the payload of an NDEF record that has already been read, storing in `known_out` whether a decoder of
+// `registry` or a built-in one is meant for its type.
+static bool ndef_decd_decode_known(const ndef_registry_t* registry, const ndef_record_t* record,
+                                   ndef_decd_record_t* decd_out, bool* known_out) {
+    decd_out->pos = record->pos;
+    bool app_known = false;
+    if (registry) {
+        const ndef_decd_decoder_t* decoder = ndef_registry_find_record(registry, record);
+        if (decoder) {
+            app_known             = true;
+            decd_out->data.record = *record;
+            if (decoder->decode(record, decd_out, decoder->cookie)) {
+                *known_out = true;
+                return true;
+            }
+        }
+    }
+    decd_out->type  = ndef_decd_builtin(record, decd_out, known_out);
+    *known_out     |= app_known;
+    if (decd_out->type == NDEF_DECD_TYPE_UNKNOWN) {
+        decd_out->data.record = *record;
+        return false;
+    }
+    return true;
+}
+
+// Decode the payload of an NDEF record that has already been read, consulting the application-defined decoders of
+// `registry` first.
+bool ndef_decd_decode_with(const ndef_registry_t* registry, const ndef_record_t* record, ndef_decd_record_t* decd_out) {
+    NDEF_STATS_FN(DECD_DECODE);
+    bool known;
+    return ndef_decd_decode_known(registry, record, decd_out, &known);
+}
+
+// Read and decode an NDEF record, consulting the application-defined decoders of `registry` first.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_decd_read_with(const ndef_registry_t* registry, ndef_istream_t* istream, ndef_decd_record_t* decd_out) {
+    NDEF_STATS_FN(DECD_DECODE);
+    ndef_record_t record;
+    bool          known;
+    size_t        record_len = NDEF_RETURN_ON_FALSE(ndef_read_record(istream, &record));
+    NDEF_RETURN_ON_FALSE(ndef_decd_decode_known(registry, &record, decd_out, &known),
+                         ndef_istream_reject(istream, record_len, known););
+    return record_len;
+}
+
+// Get the encoded size of a decoded NDEF record.
+// Returns 0 if the record type cannot be encoded.
+size_t ndef_decd_encoded_size(const ndef_decd_record_t* record) {
+    switch (record->type) {
+        case NDEF_DECD_TYPE_URI:
+            return ndef_uri_encoded_size(record->data.uri);
+        case NDEF_DECD_TYPE_TEXT:
+            return ndef_text_encoded_size(record->data.text);
+        case NDEF_DECD_TYPE_SMART_POSTER:
+            return ndef_smartposter_encoded_size(record->data.smartposter);
+        case NDEF_DECD_TYPE_WIFI:
+            return ndef_wifi_encoded_size(record->data.wifi);
+        case NDEF_DECD_TYPE_AAR:
+            return ndef_aar_encoded_size(record->data.aar);
+        case NDEF_DECD_TYPE_MIME:
+            return ndef_mime_encoded_size(record->data.mime);
+        case NDEF_DECD_TYPE_EXTERNAL:
+            return ndef_external_encoded_size(record->data.external);
+        case NDEF_DECD_TYPE_SIGNATURE:
+            return ndef_sig_encoded_size(record->data.sig);
+        case NDEF_DECD_TYPE_HANDOVER:
+            return ndef_handover_encoded_size(record->data.handover);
+        case NDEF_DECD_TYPE_BLE_OOB:
+            return ndef_ble_oob_encoded_size(record->data.ble_oob);
+        default:
+            if (record->type < NDEF_DECD_TYPE_APP) {
+                return 0;
+            }
+            const ndef_record_t* raw = &record->data.record;
+            return ndef_record_encoded_size(raw->type_len, raw->id_len, raw->payload_len);
+    }
+}
+
+// Write a decoded NDEF record.
+bool ndef_decd_write(ndef_ostream_t* ostream, const ndef_decd_record_t* record, ndef_pos_t pos) {
+    NDEF_STATS_FN(DECD_WRITE);
+    switch (record->type) {
+        case NDEF_DECD_TYPE_URI:
+            return ndef_uri_write(ostream, record->data.uri, pos);
+        case NDEF_DECD_TYPE_TEXT:
+            return ndef_text_write(ostream, record->data.text, pos);
+        case NDEF_DECD_TYPE_SMART_POSTER:
+            return ndef_smartposter_write(ostream, record->data.smartposter, pos) != 0;
+        case NDEF_DECD_TYPE_WIFI:
+            return ndef_wifi_write(ostream, record->data.wifi, pos);
+        case NDEF_DECD_TYPE_AAR:
+            return ndef_aar_write(ostream, record->data.aar, pos);
+        case NDEF_DECD_TYPE_MIME:
+            return ndef_mime_write(ostream, record->data.mime, pos);
+        case NDEF_DECD_TYPE_EXTERNAL:
+            return ndef_external_write(ostream, record->data.external, pos);
+        case NDEF_DECD_TYPE_SIGNATURE:
+            return ndef_sig_write(ostream, record->data.sig, pos);
+        case NDEF_DECD_TYPE_HANDOVER:
+            return ndef_handover_write(ostream, record->data.handover, pos) != 0;
+        case NDEF_DECD_TYPE_BLE_OOB:
+            return ndef_ble_oob_write_ad(ostream, record->data.ble_oob, pos) != 0;
+        default:
+            if (record->type < NDEF_DECD_TYPE_APP) {
+                ndef_ostream_fail(ostream, NDEF_ERR_INVALID_ARG);
+                return false;
+            }
+            ndef_record_t raw = record->data.record;
+            raw.pos           = pos;
+            raw.chunked       = false;
+            return ndef_write_raw(ostream, &raw);
+    }
+}
+
+// Get the encoded size of an NDEF message made of `records_len` records.
+// Returns 0 if any of the records cannot be encoded or the size does not fit in a `size_t`.
+size_t ndef_message_encoded_size(const ndef_decd_record_t* records, size_t records_len) {
+    size_t size = 0;
+    for (size_t i = 0; i < records_len; i++) {
+        size_t record_size = NDEF_RETURN_ON_FALSE(ndef_decd_encoded_size(&records[i]));
+        NDEF_RETURN_ON_FALSE(!__builtin_add_overflow(size, record_size, &size));
+    }
+    return size;
+}
+
+// Write an NDEF message made of `records_len` records.
+bool ndef_message_write(ndef_ostream_t* ostream, const ndef_decd_record_t* records, size_t records_len) {
+    NDEF_STATS_FN(MESSAGE_WRITE);
+    NDEF_RETURN_ON_FALSE(records_len, ndef_ostream_fail(ostream, NDEF_ERR_INVALID_ARG););
+    size_t size = NDEF_RETURN_ON_FALSE(ndef_message_encoded_size(records, records_len),
+                                       ndef_ostream_fail(ostream, NDEF_ERR_INVALID_ARG););
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve_extra(ostream, size));
+    for (size_t i = 0; i < records_len; i++) {
+        NDEF_RETURN_ON_FALSE(ndef_decd_write(ostream, &records[i], ndef_pos_at(i, records_len)));
+    }
+    return true;
+}
+
+// Write an NDEF message like `ndef_message_write` and find the ranges that differ from `old_data`.
+bool ndef_message_rewrite(ndef_ostream_t* ostream, const uint8_t* old_data, size_t old_len,
+                          const ndef_decd_record_t* records, size_t records_len, size_t base_offset,
+                          size_t block_size, ndef_diff_range_t* ranges_out, size_t cap, size_t* ranges_len_out) {
+    size_t start = ostream->len;
+    NDEF_RETURN_ON_FALSE(ndef_message_write(ostream, records, records_len), ostream->len = start;);
+    *ranges_len_out = ndef_diff_at(old_data, old_len, ostream->data + start, ostream->len - start, base_offset,
+                                   block_size, ranges_out, cap);
+    return true;
+}
+
+// Get the encoded size of `messages_len` messages written back to back.
+// Returns 0 if any of the messages is empty or cannot be encoded, or the size does not fit in a `size_t`.
+size_t ndef_batch_encoded_size(const ndef_batch_message_t* messages, size_t messages_len) {
+    size_t size = 0;
+    for (size_t i = 0; i < messages_len; i++) {
+        NDEF_RETURN_ON_FALSE(messages[i].records_len);
+        size_t len = NDEF_RETURN_ON_FALSE(ndef_message_encoded_size(messages[i].records, messages[i].records_len));
+        NDEF_RETURN_ON_FALSE(!__builtin_add_overflow(size, len, &size));
+    }
+    return size;
+}
+
+// Write the header of a well-known record with a one-character type into memory that has been reserved for it.
+// Returns how many bytes were written.
+static inline size_t ndef_batch_put_header(uint8_t* out, char type, ndef_pos_t pos, size_t payload_len) {
+    if (payload_len < 256) {
+        out[0] = pos | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_WELL_KNOWN;
+        out[1] = 1;
+        out[2] = payload_len;
+        out[3] = type;
+        return 4;
+    }
+    out[0] = pos | NDEF_TNF_WELL_KNOWN;
+    out[1] = 1;
+    out[2] = payload_len >> 24;
+    out[3] = payload_len >> 16;
+    out[4] = payload_len >> 8;
+    out[5] = payload_len;
+    out[6] = type;
+    return 7;
+}
+
+// Write a record into memory that has been reserved for it.
+static bool ndef_batch_put_record(ndef_ostream_t* ostream, const ndef_decd_record_t* record, ndef_pos_t pos) {
+    uint8_t* out = ostream->data + ostream->len;
+    if (record->type == NDEF_DECD_TYPE_URI) {
+        ndef_uri_t uri  = record->data.uri;
+        out            += ndef_batch_put_header(out, 'U', pos, ndef_uri_payload_size(uri));
+        *out++          = uri.prefix;
+        if (uri.uri_len) {
+            memcpy(out, uri.uri, uri.uri_len);
+        }
+        ostream->len = out + uri.uri_len - ostream->data;
+        NDEF_STATS_ADD(bytes_encoded, ndef_uri_encoded_size(uri));
+        return true;
+    } else if (record->type == NDEF_DECD_TYPE_TEXT && record->data.text.encoding == NDEF_TEXT_UTF8 &&
+               record->data.text.lang_len <= 0x3f) {
+        ndef_text_t text = record->data.text;
+        NDEF_RETURN_ON_FALSE(ndef_utf8_valid((const uint8_t*)text.text, text.text_len),
+                             ndef_ostream_fail(ostream, NDEF_ERR_INVALID_ARG););
+        out   += ndef_batch_put_header(out, 'T', pos, ndef_text_payload_size(text));
+        *out++ = text.lang_len;
+        if (text.lang_len) {
+            memcpy(out, text.lang, text.lang_len);
+        }
+        out += text.lang_len;
+        if (text.text_len) {
+            memcpy(out, text.text, text.text_len);
+        }
+        ostream->len = out + text.text_len - ostream->data;
+        NDEF_STATS_ADD(bytes_encoded, ndef_text_encoded_size(text));
+        return true;
+    }
+    return ndef_decd_write(ostream, record, pos);
+}
+
+// Write `messages_len` NDEF messages back to back and store where each one ended up in `entries_out`.
+bool ndef_batch_write(ndef_ostream_t* ostream, const ndef_batch_message_t* messages, size_t messages_len,
+                      ndef_batch_entry_t* entries_out) {
+    NDEF_STATS_FN(BATCH_WRITE);
+    // Lay out the batch first so that it can be reserved at once.
+    size_t start  = ostream->len;
+    size_t offset = start;
+    for (size_t i = 0; i < messages_len; i++) {
+        NDEF_RETURN_ON_FALSE(messages[i].records_len, ndef_ostream_fail(ostream, NDEF_ERR_INVALID_ARG););
+        size_t len     = NDEF_RETURN_ON_FALSE(ndef_message_encoded_size(messages[i].records, messages[i].records_len),
+                                              ndef_ostream_fail(ostream, NDEF_ERR_INVALID_ARG););
+        entries_out[i] = (ndef_batch_entry_t){offset, len};
+        NDEF_RETURN_ON_FALSE(!__builtin_add_overflow(offset, len, &offset),
+                             ndef_ostream_fail(ostream, ostream->mode == NDEF_OSTREAM_MODE_FIXED ? NDEF_ERR_NO_SPACE
+                                                                                                 : NDEF_ERR_NO_MEM););
+    }
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve(ostream, offset));
+
+    for (size_t i = 0; i < messages_len; i++) {
+        const ndef_batch_message_t* message = &messages[i];
+        for (size_t j = 0; j < message->records_len; j++) {
+            ndef_pos_t pos = ndef_pos_at(j, message->records_len);
+            NDEF_RETURN_ON_FALSE(ndef_batch_put_record(ostream, &message->records[j], pos), ostream->len = start;);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,251 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/parser.h"
+#include <string.h>
+
+// Get the length of the fixed part of a record header from its flags.
+static inline size_t ndef_parser_header_len(uint8_t flags) {
+    return 2 + (flags & NDEF_FLAG_SHORT_RECORD ? 1 : 4) + !!(flags & NDEF_FLAG_ID_LENGTH);
+}
+
+// Record why parsing failed at the current offset.
+static void ndef_parser_error(ndef_parser_t* parser, ndef_err_t err) {
+    parser->result = (ndef_result_t){err, parser->offset};
+}
+
+// Put the parser in the error state; the reason must already be recorded with `ndef_parser_error`.
+// Always returns 0.
+static size_t ndef_parser_fail(ndef_parser_t* parser) {
+    parser->state = NDEF_PARSER_STATE_ERROR;
+    return 0;
+}
+
+// Check that only the first record of a message has the message begin flag.
+static inline bool ndef_parser_check_pos(const ndef_parser_t* parser, ndef_pos_t pos) {
+    return !!(pos & NDEF_POS_START) == (parser->count == 0);
+}
+
+// Report a complete record and get ready for the next one.
+static bool ndef_parser_emit(ndef_parser_t* parser, const ndef_record_t* record) {
+    NDEF_RETURN_ON_FALSE(parser->on_record(parser->cookie, record), ndef_parser_error(parser, NDEF_ERR_ABORTED););
+    parser->count++;
+    parser->header_have = 0;
+    parser->state       = record->pos & NDEF_POS_END ? NDEF_PARSER_STATE_DONE : NDEF_PARSER_STATE_HEADER;
+    return true;
+}
+
+// Decode the fixed part of a record header, whose length is given by `ndef_parser_header_len`.
+static void ndef_parser_decode_header(const uint8_t* header, ndef_record_t* record_out) {
+    size_t index = 2;
+    *record_out  = (ndef_record_t){
+        .pos      = header[0] & (NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_MESSAGE_END),
+        .tnf      = header[0] & NDEF_FLAG_TYPE_NAME_FORMAT,
+        .type_len = header[1],
+        .chunked  = header[0] & NDEF_FLAG_CHUNKED_RECORD,
+    };
+    if (header[0] & NDEF_FLAG_SHORT_RECORD) {
+        record_out->payload_len = header[index++];
+    } else {
+        record_out->payload_len = (uint32_t)header[index] << 24 | (uint32_t)header[index + 1] << 16 |
+                                  (uint32_t)header[index + 2] << 8 | header[index + 3];
+        index                        += 4;
+        record_out->long_payload_len  = record_out->payload_len < 256;
+    }
+    record_out->id_len       = header[0] & NDEF_FLAG_ID_LENGTH ? header[index] : 0;
+    record_out->empty_id_len = (header[0] & NDEF_FLAG_ID_LENGTH) && !record_out->id_len;
+}
+
+// Check whether a whole record lies within `data`.
+static inline bool ndef_parser_is_whole(const uint8_t* data, size_t len) {
+    size_t header_len = ndef_parser_header_len(data[0]);
+    if (len < header_len) {
+        return false;
+    }
+    ndef_record_t record;
+    ndef_parser_decode_header(data, &record);
+    len -= header_len;
+    return len >= record.type_len + record.id_len && len - record.type_len - record.id_len >= record.payload_len;
+}
+
+// Try to report a record that lies entirely within `data` without copying it.
+// Returns how long the record was, or 0 if it is not complete.
+static size_t ndef_parser_try_whole(ndef_parser_t* parser, const uint8_t* data, size_t len) {
+    // Check first, so that a record split across chunks is not counted as a failed read.
+    if (!ndef_parser_is_whole(data, len)) {
+        return 0;
+    }
+    ndef_istream_t istream    = NDEF_ISTREAM_NEW(data, len);
+    ndef_record_t  record;
+    size_t         record_len = ndef_read_record(&istream, &record);
+    // Checked here too, so that the limit does not depend on how the data is split into chunks.
+    if (record.payload_len > parser->max_payload_len) {
+        ndef_parser_error(parser, NDEF_ERR_PAYLOAD);
+        return ndef_parser_fail(parser);
+    }
+    if (!ndef_parser_check_pos(parser, record.pos)) {
+        NDEF_STATS_FAIL(MESSAGE_FLAGS);
+        ndef_parser_error(parser, NDEF_ERR_MALFORMED);
+        return ndef_parser_fail(parser);
+    }
+    if (parser->on_header) {
+        ndef_record_t header = record;
+        header.payload       = NULL;
+        if (!parser->on_header(parser->cookie, &header)) {
+            record.payload = NULL;
+        }
+    }
+    if (!ndef_parser_emit(parser, &record)) {
+        return ndef_parser_fail(parser);
+    }
+    return record_len;
+}
+
+// Decode the fixed part of a record header once it has been received.
+static bool ndef_parser_begin_record(ndef_parser_t* parser) {
+    ndef_record_t* record = &parser->record;
+    ndef_parser_decode_header(parser->header, record);
+    NDEF_RETURN_ON_FALSE(ndef_parser_check_pos(parser, record->pos), NDEF_STATS_FAIL(MESSAGE_FLAGS);
+                         ndef_parser_error(parser, NDEF_ERR_MALFORMED););
+    NDEF_RETURN_ON_FALSE(record->payload_len <= SIZE_MAX - record->type_len - record->id_len,
+                         ndef_parser_error(parser, NDEF_ERR_MALFORMED););
+    // The length comes from the tag, so it is checked before anything is reserved for the payload.
+    NDEF_RETURN_ON_FALSE(record->payload_len <= parser->max_payload_len, ndef_parser_error(parser, NDEF_ERR_PAYLOAD););
+
+    parser->buffer.len = 0;
+    parser->need       = record->type_len + record->id_len;
+    parser->state      = NDEF_PARSER_STATE_TYPE;
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve(&parser->buffer, parser->need),
+                         ndef_parser_error(parser, parser->buffer.result.err););
+    return true;
+}
+
+// Decide whether to keep the payload once the type and ID have been received.
+static bool ndef_parser_begin_payload(ndef_parser_t* parser) {
+    ndef_record_t* record = &parser->record;
+    record->type          = (const char*)parser->buffer.data;
+    record->id            = record->type + record->type_len;
+    parser->skip_payload  = parser->on_header && !parser->on_header(parser->cookie, record);
+    parser->need          = record->payload_len;
+    parser->state         = NDEF_PARSER_STATE_PAYLOAD;
+    if (!parser->skip_payload) {
+        NDEF_RETURN_ON_FALSE(ndef_ostream_reserve_extra(&parser->buffer, record->payload_len),
+                             ndef_parser_error(parser, parser->buffer.result.err););
+    }
+    return true;
+}
+
+// Report a record once its payload has been received.
+static bool ndef_parser_end_record(ndef_parser_t* parser) {
+    ndef_record_t* record = &parser->record;
+    size_t         offset = record->type_len + record->id_len;
+    record->type          = (const char*)parser->buffer.data;
+    record->id            = record->type + record->type_len;
+    record->payload       = parser->skip_payload ? NULL : parser->buffer.data + offset;
+    // A record without type, ID or payload can complete before the buffer has any memory; it must not look skipped.
+    if (!parser->skip_payload && !record->payload) {
+        record->payload = (const uint8_t*)"";
+    }
+    return ndef_parser_emit(parser, record);
+}
+
+// Consume some of `data` according to the current state.
+// Returns how many bytes were consumed.
+static size_t ndef_parser_step(ndef_parser_t* parser, const uint8_t* data, size_t len) {
+    size_t used;
+    switch (parser->state) {
+        case NDEF_PARSER_STATE_HEADER:
+            if (parser->header_have == 0) {
+                used = ndef_parser_try_whole(parser, data, len);
+                if (used || parser->state == NDEF_PARSER_STATE_ERROR) {
+                    return used;
+                }
+                parser->header_need = ndef_parser_header_len(data[0]);
+            }
+            used = parser->header_need - parser->header_have;
+            used = used < len ? used : len;
+            memcpy(parser->header + parser->header_have, data, used);
+            parser->header_have += used;
+            if (parser->header_have == parser->header_need && !ndef_parser_begin_record(parser)) {
+                return ndef_parser_fail(parser);
+            }
+            break;
+
+        case NDEF_PARSER_STATE_TYPE:
+            used = parser->need < len ? parser->need : len;
+            if (!ndef_ostream_extend(&parser->buffer, data, used)) {
+                ndef_parser_error(parser, parser->buffer.result.err);
+                return ndef_parser_fail(parser);
+            }
+            parser->need -= used;
+            break;
+
+        case NDEF_PARSER_STATE_PAYLOAD:
+            used = parser->need < len ? parser->need : len;
+            if (!parser->skip_payload && !ndef_ostream_extend(&parser->buffer, data, used)) {
+                ndef_parser_error(parser, parser->buffer.result.err);
+                return ndef_parser_fail(parser);
+            }
+            parser->need -= used;
+            break;
+
+        default:
+            return 0;
+    }
+
+    // Records with an empty type or payload complete without consuming more data.
+    if (parser->state == NDEF_PARSER_STATE_TYPE && !parser->need && !ndef_parser_begin_payload(parser)) {
+        return ndef_parser_fail(parser);
+    }
+    if (parser->state == NDEF_PARSER_STATE_PAYLOAD && !parser->need && !ndef_parser_end_record(parser)) {
+        return ndef_parser_fail(parser);
+    }
+    return used;
+}
+
+// Initialize a parser that buffers records spanning multiple chunks in `buffer`.
+void ndef_parser_init(ndef_parser_t* parser, ndef_ostream_t buffer, size_t max_payload_len,
+                      ndef_parser_header_cb_t on_header, ndef_parser_record_cb_t on_record, void* cookie) {
+    *parser = (ndef_parser_t){
+        .state           = NDEF_PARSER_STATE_HEADER,
+        .buffer          = buffer,
+        .max_payload_len = max_payload_len,
+        .on_header       = on_header,
+        .on_record       = on_record,
+        .cookie          = cookie,
+    };
+}
+
+// Release the buffer of a parser.
+void ndef_parser_free(ndef_parser_t* parser) {
+    ndef_ostream_free(&parser->buffer);
+}
+
+// Feed a chunk of data to the parser, calling the callbacks for every record completed by it.
+bool ndef_parser_feed(ndef_parser_t* parser, const uint8_t* data, size_t len) {
+    NDEF_STATS_FN(PARSER_FEED);
+    while (len && parser->state != NDEF_PARSER_STATE_DONE) {
+        size_t used = ndef_parser_step(parser, data, len);
+        NDEF_RETURN_ON_FALSE(parser->state != NDEF_PARSER_STATE_ERROR);
+        data           += used;
+        len            -= used;
+        parser->offset += used;
+    }
+    return parser->state != NDEF_PARSER_STATE_ERROR;
+}
+
+// Get how many more bytes the parser needs to complete the current record, or its header if that is incomplete.
+size_t ndef_parser_needed(const ndef_parser_t* parser) {
+    switch (parser->state) {
+        case NDEF_PARSER_STATE_HEADER:
+            // The shortest header is 3 bytes; the flags tell the real length.
+            return parser->header_have ? parser->header_need - parser->header_have : 3;
+        case NDEF_PARSER_STATE_TYPE:
+            return parser->need + parser->record.payload_len;
+        case NDEF_PARSER_STATE_PAYLOAD:
+            return parser->need;
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,74 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/registry.h"
+#include <string.h>
+
+// Hash a type name format and type with 32-bit FNV-1a, folding ASCII case if the type name format requires it.
+static uint32_t ndef_registry_hash(ndef_tnf_t tnf, const char* type, size_t type_len) {
+    bool     fold = ndef_tnf_folds_case(tnf);
+    uint32_t hash = (2166136261u ^ tnf) * 16777619u;
+    for (size_t i = 0; i < type_len; i++) {
+        uint8_t c = fold ? ndef_ascii_lower(type[i]) : type[i];
+        hash      = (hash ^ c) * 16777619u;
+    }
+    return hash;
+}
+
+// Whether an entry holds a certain type.
+static inline bool ndef_registry_matches(const ndef_registry_entry_t* entry, uint32_t hash, ndef_tnf_t tnf,
+                                         const char* type, size_t type_len) {
+    if (entry->hash != hash || entry->tnf != tnf || entry->type_len != type_len) {
+        return false;
+    } else if (type_len == 0) {
+        return true;
+    } else if (ndef_tnf_folds_case(tnf)) {
+        return ndef_type_equal_nocase(entry->type, type, type_len);
+    }
+    return memcmp(entry->type, type, type_len) == 0;
+}
+
+// Find the slot that holds a type, or the empty slot where it would go.
+static ndef_registry_entry_t* ndef_registry_slot(const ndef_registry_t* registry, uint32_t hash, ndef_tnf_t tnf,
+                                                 const char* type, size_t type_len) {
+    size_t mask = registry->cap - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        ndef_registry_entry_t* entry = &registry->entries[i];
+        if (!entry->value || ndef_registry_matches(entry, hash, tnf, type, type_len)) {
+            return entry;
+        }
+    }
+}
+
+// Initialize an empty registry in `entries`, of which there must be a power of two.
+void ndef_registry_init(ndef_registry_t* registry, ndef_registry_entry_t* entries, size_t cap) {
+    memset(entries, 0, cap * sizeof(ndef_registry_entry_t));
+    *registry = (ndef_registry_t){entries, cap, 0};
+}
+
+// Register `value` for a record type, replacing the value registered before for the same type.
+bool ndef_registry_add(ndef_registry_t* registry, ndef_tnf_t tnf, const char* type, size_t type_len,
+                       const void* value) {
+    NDEF_RETURN_ON_FALSE(value);
+    NDEF_RETURN_ON_FALSE(registry->cap && (registry->cap & (registry->cap - 1)) == 0);
+    uint32_t               hash  = ndef_registry_hash(tnf, type, type_len);
+    ndef_registry_entry_t* entry = ndef_registry_slot(registry, hash, tnf, type, type_len);
+    if (!entry->value) {
+        // Keep a quarter of the slots free so that probe sequences stay short, and at least one so that they end.
+        size_t len = registry->len + 1;
+        NDEF_RETURN_ON_FALSE(len < registry->cap && len <= registry->cap - registry->cap / 4);
+        registry->len++;
+    }
+    *entry = (ndef_registry_entry_t){hash, tnf, type, type_len, value};
+    return true;
+}
+
+// Find the value registered for a record type.
+const void* ndef_registry_find(const ndef_registry_t* registry, ndef_tnf_t tnf, const char* type, size_t type_len) {
+    if (!registry->len) {
+        return NULL;
+    }
+    uint32_t hash = ndef_registry_hash(tnf, type, type_len);
+    return ndef_registry_slot(registry, hash, tnf, type, type_len)->value;
+}
@@ -0,0 +1,158 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/sha256.h"
+#include <string.h>
+
+#if NDEF_CRYPTO_MBEDTLS
+
+// Start a new hash.
+void ndef_sha256_init(ndef_sha256_t* ctx) {
+    mbedtls_sha256_init(&ctx->mbedtls);
+    mbedtls_sha256_starts(&ctx->mbedtls, 0);
+}
+
+// Add `len` bytes to the hash.
+void ndef_sha256_update(ndef_sha256_t* ctx, const void* data, size_t len) {
+    mbedtls_sha256_update(&ctx->mbedtls, data, len);
+}
+
+// Finish the hash and store the digest in `digest_out`.
+void ndef_sha256_finish(ndef_sha256_t* ctx, uint8_t digest_out[NDEF_SHA256_LEN]) {
+    mbedtls_sha256_finish(&ctx->mbedtls, digest_out);
+    mbedtls_sha256_free(&ctx->mbedtls);
+}
+
+// Abandon a hash without finishing it, releasing what the backend holds for it.
+void ndef_sha256_free(ndef_sha256_t* ctx) {
+    mbedtls_sha256_free(&ctx->mbedtls);
+}
+
+#else
+
+// Round constants: the first 32 bits of the fractional parts of the cube roots of the first 64 primes.
+static const uint32_t ndef_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t ndef_sha256_rotr(uint32_t x, unsigned n) {
+    return x >> n | x << (32 - n);
+}
+
+// Compress one 64-byte block into the hash state.
+static void ndef_sha256_compress(uint32_t state[8], const uint8_t* block) {
+    uint32_t w[64];
+    for (size_t i = 0; i < 16; i++) {
+        w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 | (uint32_t)block[i * 4 + 2] << 8 |
+               block[i * 4 + 3];
+    }
+    for (size_t i = 16; i < 64; i++) {
+        uint32_t s0 = ndef_sha256_rotr(w[i - 15], 7) ^ ndef_sha256_rotr(w[i - 15], 18) ^ w[i - 15] >> 3;
+        uint32_t s1 = ndef_sha256_rotr(w[i - 2], 17) ^ ndef_sha256_rotr(w[i - 2], 19) ^ w[i - 2] >> 10;
+        w[i]        = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (size_t i = 0; i < 64; i++) {
+        uint32_t s1 = ndef_sha256_rotr(e, 6) ^ ndef_sha256_rotr(e, 11) ^ ndef_sha256_rotr(e, 25);
+        uint32_t t1 = h + s1 + ((e & f) ^ (~e & g)) + ndef_sha256_k[i] + w[i];
+        uint32_t s0 = ndef_sha256_rotr(a, 2) ^ ndef_sha256_rotr(a, 13) ^ ndef_sha256_rotr(a, 22);
+        uint32_t t2 = s0 + ((a & b) ^ (a & c) ^ (b & c));
+        h           = g;
+        g           = f;
+        f           = e;
+        e           = d + t1;
+        d           = c;
+        c           = b;
+        b           = a;
+        a           = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+// Start a new hash.
+void ndef_sha256_init(ndef_sha256_t* ctx) {
+    static const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memcpy(ctx->state, initial, sizeof(initial));
+    ctx->len = 0;
+}
+
+// Add `len` bytes to the hash.
+void ndef_sha256_update(ndef_sha256_t* ctx, const void* data, size_t len) {
+    if (!len) {
+        return;
+    }
+    const uint8_t* in   = data;
+    size_t         have = ctx->len % 64;
+    ctx->len           += len;
+
+    // Top up a partial block first.
+    if (have) {
+        size_t take = 64 - have < len ? 64 - have : len;
+        memcpy(ctx->block + have, in, take);
+        in  += take;
+        len -= take;
+        if (have + take < 64) {
+            return;
+        }
+        ndef_sha256_compress(ctx->state, ctx->block);
+    }
+    // Then compress whole blocks straight from the input.
+    for (; len >= 64; in += 64, len -= 64) {
+        ndef_sha256_compress(ctx->state, in);
+    }
+    if (len) {
+        memcpy(ctx->block, in, len);
+    }
+}
+
+// Finish the hash and store the digest in `digest_out`.
+void ndef_sha256_finish(ndef_sha256_t* ctx, uint8_t digest_out[NDEF_SHA256_LEN]) {
+    // Pad with a 1 bit, zeroes and the length in bits so that the input is a whole number of blocks.
+    uint64_t bits = ctx->len * 8;
+    size_t   have = ctx->len % 64;
+
+    ctx->block[have++] = 0x80;
+    if (have > 56) {
+        memset(ctx->block + have, 0, 64 - have);
+        ndef_sha256_compress(ctx->state, ctx->block);
+        have = 0;
+    }
+    memset(ctx->block + have, 0, 56 - have);
+    for (size_t i = 0; i < 8; i++) {
+        ctx->block[56 + i] = bits >> (56 - i * 8);
+    }
+    ndef_sha256_compress(ctx->state, ctx->block);
+
+    for (size_t i = 0; i < 8; i++) {
+        digest_out[i * 4]     = ctx->state[i] >> 24;
+        digest_out[i * 4 + 1] = ctx->state[i] >> 16;
+        digest_out[i * 4 + 2] = ctx->state[i] >> 8;
+        digest_out[i * 4 + 3] = ctx->state[i];
+    }
+}
+
+// Abandon a hash without finishing it, releasing what the backend holds for it.
+void ndef_sha256_free(ndef_sha256_t* ctx) {
+    (void)ctx;
+}
+
+#endif
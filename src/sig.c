@@ -0,0 +1,237 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/sig.h"
+
+#if NDEF_CRYPTO_MBEDTLS
+#include "mbedtls/pk.h"
+#endif
+
+// Flag in the signature and certificate chain fields that a URI follows instead of the data itself.
+#define NDEF_SIG_URI_PRESENT 0x80
+
+// Read a 16-bit big-endian length.
+static inline size_t ndef_sig_u16(const uint8_t* data) {
+    return (size_t)data[0] << 8 | data[1];
+}
+
+// Decode the payload of a Signature record.
+static bool ndef_sig_decode_payload(const uint8_t* payload, size_t len, ndef_sig_t* sig_out) {
+    // Version and signature field; minor versions are compatible.
+    NDEF_RETURN_ON_FALSE(len >= 5 && (payload[0] & 0xf0) == (NDEF_SIG_VERSION & 0xf0));
+    size_t signature_len = ndef_sig_u16(payload + 3);
+    NDEF_RETURN_ON_FALSE(len - 5 >= signature_len);
+    sig_out->type             = payload[1] & ~NDEF_SIG_URI_PRESENT;
+    sig_out->signature_is_uri = payload[1] & NDEF_SIG_URI_PRESENT;
+    sig_out->hash             = payload[2];
+    sig_out->signature        = payload + 5;
+    sig_out->signature_len    = signature_len;
+    size_t index              = 5 + signature_len;
+    if (index == len && sig_out->type == NDEF_SIG_TYPE_NONE) {
+        // A marker may leave out the certificate chain.
+        return true;
+    }
+
+    // Certificate chain field.
+    NDEF_RETURN_ON_FALSE(index < len);
+    uint8_t chain          = payload[index++];
+    sig_out->cert_format   = (chain >> 4) & 0x07;
+    sig_out->cert_count    = chain & 0x0f;
+    sig_out->certs         = payload + index;
+    for (size_t i = 0; i < sig_out->cert_count; i++) {
+        NDEF_RETURN_ON_FALSE(len - index >= 2);
+        size_t cert_len  = ndef_sig_u16(payload + index);
+        index           += 2;
+        NDEF_RETURN_ON_FALSE(len - index >= cert_len);
+        index += cert_len;
+    }
+    sig_out->certs_len = payload + index - sig_out->certs;
+    if (chain & NDEF_SIG_URI_PRESENT) {
+        NDEF_RETURN_ON_FALSE(len - index >= 2);
+        size_t uri_len  = ndef_sig_u16(payload + index);
+        index          += 2;
+        NDEF_RETURN_ON_FALSE(len - index >= uri_len);
+        sig_out->cert_uri     = (const char*)payload + index;
+        sig_out->cert_uri_len = uri_len;
+        index                += uri_len;
+    }
+    return index == len;
+}
+
+// Decode the payload of an NDEF Signature record that has already been read.
+bool ndef_sig_decode(const ndef_record_t* record, ndef_sig_t* sig_out) {
+    NDEF_RETURN_ON_FALSE(ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Sig", 3));
+    *sig_out = (ndef_sig_t){.pos = record->pos};
+    NDEF_RETURN_ON_FALSE(ndef_sig_decode_payload(record->payload, record->payload_len, sig_out),
+                         NDEF_STATS_FAIL(PAYLOAD););
+    return true;
+}
+
+// Read an NDEF Signature record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_sig_read(ndef_istream_t* istream, ndef_sig_t* sig_out) {
+    ndef_record_t record;
+    size_t        record_len = NDEF_RETURN_ON_FALSE(ndef_read_record(istream, &record));
+    NDEF_RETURN_ON_FALSE(
+        ndef_sig_decode(&record, sig_out),
+        ndef_istream_reject(istream, record_len, ndef_record_is_type(&record, NDEF_TNF_WELL_KNOWN, "Sig", 3)););
+    return record_len;
+}
+
+// Get the next certificate of a Signature record.
+bool ndef_sig_next_cert(const ndef_sig_t* sig, size_t* offset, const uint8_t** cert_out, size_t* cert_len_out) {
+    NDEF_RETURN_ON_FALSE(*offset <= sig->certs_len && sig->certs_len - *offset >= 2);
+    size_t cert_len = ndef_sig_u16(sig->certs + *offset);
+    NDEF_RETURN_ON_FALSE(sig->certs_len - *offset - 2 >= cert_len);
+    *cert_out      = sig->certs + *offset + 2;
+    *cert_len_out  = cert_len;
+    *offset       += 2 + cert_len;
+    return true;
+}
+
+// Get the payload size of an NDEF Signature record.
+size_t ndef_sig_payload_size(ndef_sig_t sig) {
+    return 5 + sig.signature_len + 1 + sig.certs_len + (sig.cert_uri_len ? 2 + sig.cert_uri_len : 0);
+}
+
+// Whether the certificates of a Signature record are well-formed and as many as it says.
+static bool ndef_sig_certs_valid(const ndef_sig_t* sig) {
+    size_t         offset = 0;
+    size_t         count  = 0;
+    const uint8_t* cert;
+    size_t         cert_len;
+    while (ndef_sig_next_cert(sig, &offset, &cert, &cert_len)) {
+        count++;
+    }
+    return offset == sig->certs_len && count == sig->cert_count;
+}
+
+// Write an NDEF Signature record.
+bool ndef_sig_write(ndef_ostream_t* data_out, ndef_sig_t sig, ndef_pos_t pos) {
+    NDEF_RETURN_ON_FALSE(sig.type < NDEF_SIG_URI_PRESENT && sig.hash <= 0xff && sig.signature_len <= 0xffff &&
+                             sig.cert_format <= 0x07 && sig.cert_count <= 0x0f && sig.cert_uri_len <= 0xffff &&
+                             ndef_sig_certs_valid(&sig),
+                         ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    NDEF_RETURN_ON_FALSE(ndef_write_record(data_out, NDEF_TNF_WELL_KNOWN, "Sig", pos, ndef_sig_payload_size(sig)));
+
+    uint8_t signature_field[5] = {
+        NDEF_SIG_VERSION,
+        sig.type | (sig.signature_is_uri ? NDEF_SIG_URI_PRESENT : 0),
+        sig.hash,
+        sig.signature_len >> 8,
+        sig.signature_len,
+    };
+    uint8_t chain = (sig.cert_uri_len ? NDEF_SIG_URI_PRESENT : 0) | sig.cert_format << 4 | sig.cert_count;
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, signature_field, sizeof(signature_field)));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, sig.signature, sig.signature_len));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_push(data_out, chain));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, sig.certs, sig.certs_len));
+    if (sig.cert_uri_len) {
+        uint8_t uri_len[2] = {sig.cert_uri_len >> 8, sig.cert_uri_len};
+        NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, uri_len, sizeof(uri_len)));
+        NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, (const uint8_t*)sig.cert_uri, sig.cert_uri_len));
+    }
+    return true;
+}
+
+// Add a record to the hash of the records covered by a signature.
+void ndef_sig_hash_record(ndef_sha256_t* hash, const ndef_record_t* record) {
+    // The header fields after the flags, as they are encoded.
+    uint8_t header[6];
+    size_t  len   = 0;
+    header[len++] = record->type_len;
+    if (record->payload_len < 256 && !record->long_payload_len) {
+        header[len++] = record->payload_len;
+    } else {
+        header[len++] = record->payload_len >> 24;
+        header[len++] = record->payload_len >> 16;
+        header[len++] = record->payload_len >> 8;
+        header[len++] = record->payload_len;
+    }
+    if (record->id_len || record->empty_id_len) {
+        header[len++] = record->id_len;
+    }
+    ndef_sha256_update(hash, header, len);
+    ndef_sha256_update(hash, record->type, record->type_len);
+    ndef_sha256_update(hash, record->id, record->id_len);
+    ndef_sha256_update(hash, record->payload, record->payload_len);
+}
+
+// Start verifying a message.
+void ndef_sig_verifier_init(ndef_sig_verifier_t* verifier, ndef_sig_verify_cb_t verify, void* cookie) {
+    *verifier = (ndef_sig_verifier_t){
+        .verify = verify,
+        .cookie = cookie,
+    };
+    ndef_sha256_init(&verifier->hash);
+}
+
+// Feed the next record of the message.
+bool ndef_sig_verifier_feed(ndef_sig_verifier_t* verifier, const ndef_record_t* record) {
+    if (!ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Sig", 3)) {
+        ndef_sig_hash_record(&verifier->hash, record);
+        verifier->pending++;
+        return true;
+    }
+
+    // The next signature covers the records after this one.
+    uint8_t digest[NDEF_SHA256_LEN];
+    size_t  covered = verifier->pending;
+    ndef_sha256_finish(&verifier->hash, digest);
+    ndef_sha256_init(&verifier->hash);
+    verifier->pending = 0;
+
+    ndef_sig_t sig;
+    NDEF_RETURN_ON_FALSE(ndef_sig_decode(record, &sig));
+    if (sig.type == NDEF_SIG_TYPE_NONE) {
+        verifier->unsigned_records += covered;
+        return true;
+    }
+    NDEF_RETURN_ON_FALSE(sig.hash == NDEF_SIG_HASH_SHA256 && !sig.signature_is_uri);
+    NDEF_RETURN_ON_FALSE(verifier->verify(verifier->cookie, &sig, digest, sizeof(digest)));
+    verifier->verified++;
+    return true;
+}
+
+// Release a verifier, whether or not the message was read to the end.
+void ndef_sig_verifier_free(ndef_sig_verifier_t* verifier) {
+    ndef_sha256_free(&verifier->hash);
+}
+
+// Read the NDEF message in `istream`, verifying its Signature records.
+bool ndef_sig_verify_message(ndef_istream_t* istream, ndef_sig_verify_cb_t verify, void* cookie) {
+    ndef_sig_verifier_t verifier;
+    ndef_sig_verifier_init(&verifier, verify, cookie);
+    ndef_message_iter_t iter = NDEF_MESSAGE_ITER_NEW(istream);
+    bool                ok   = true;
+    while (ok && !ndef_message_done(&iter)) {
+        ndef_record_t record;
+        ok = ndef_message_next(&iter, &record) && ndef_sig_verifier_feed(&verifier, &record);
+    }
+    ok = ok && ndef_sig_verifier_all_signed(&verifier);
+    ndef_sig_verifier_free(&verifier);
+    return ok;
+}
+
+#if NDEF_CRYPTO_MBEDTLS
+// Verify callback that checks signatures with mbedTLS; `cookie` is the `mbedtls_pk_context*` of the public key.
+bool ndef_sig_verify_mbedtls(void* cookie, const ndef_sig_t* sig, const uint8_t* digest, size_t digest_len) {
+    mbedtls_pk_context* key = cookie;
+    NDEF_RETURN_ON_FALSE(sig->hash == NDEF_SIG_HASH_SHA256);
+    if (sig->type == NDEF_SIG_TYPE_RSASSA_PSS) {
+        NDEF_RETURN_ON_FALSE(mbedtls_pk_can_do(key, MBEDTLS_PK_RSA));
+        mbedtls_pk_rsassa_pss_options options = {
+            .mgf1_hash_id      = MBEDTLS_MD_SHA256,
+            .expected_salt_len = MBEDTLS_RSA_SALT_LEN_ANY,
+        };
+        return mbedtls_pk_verify_ext(MBEDTLS_PK_RSASSA_PSS, &options, key, MBEDTLS_MD_SHA256, digest, digest_len,
+                                     sig->signature, sig->signature_len) == 0;
+    }
+    // For these, the padding or algorithm follows from the key.
+    bool key_matches = (sig->type == NDEF_SIG_TYPE_RSASSA_PKCS1 && mbedtls_pk_can_do(key, MBEDTLS_PK_RSA)) ||
+                       (sig->type == NDEF_SIG_TYPE_ECDSA && mbedtls_pk_can_do(key, MBEDTLS_PK_ECDSA));
+    NDEF_RETURN_ON_FALSE(key_matches);
+    return mbedtls_pk_verify(key, MBEDTLS_MD_SHA256, digest, digest_len, sig->signature, sig->signature_len) == 0;
+}
+#endif
@@ -3,44 +3,246 @@
 // SPDX-License-Identifier: MIT
 
 #include "ndef/smartposter.h"
+#include <strings.h>
+
+// Compare two language codes, ignoring case.
+static bool ndef_lang_equal(const char* a, size_t a_len, const char* b, size_t b_len) {
+    return a_len == b_len && strncasecmp(a, b, a_len) == 0;
+}
+
+// Get the length of the primary subtag of a language code, e.g. 2 for "en-US".
+static size_t ndef_lang_primary_len(const char* lang, size_t lang_len) {
+    const char* dash = memchr(lang, '-', lang_len);
+    return dash ? (size_t)(dash - lang) : lang_len;
+}
+
+// Rank the language of a title against the preferred languages; lower is better.
+static size_t ndef_lang_rank(const char* lang, size_t lang_len, const char* const* langs, size_t langs_len) {
+    size_t primary_len = ndef_lang_primary_len(lang, lang_len);
+    for (size_t i = 0; i < langs_len; i++) {
+        size_t pref_len = strlen(langs[i]);
+        if (ndef_lang_equal(lang, lang_len, langs[i], pref_len)) {
+            return 2 * i;
+        }
+        if (ndef_lang_equal(lang, primary_len, langs[i], ndef_lang_primary_len(langs[i], pref_len))) {
+            return 2 * i + 1;
+        }
+    }
+    return SIZE_MAX;
+}
+
+// Decode the payload of an NDEF Smart Poster record that has already been read.
+bool ndef_smartposter_decode(const ndef_record_t* record, ndef_smartposter_t* poster_out, const char* const* langs,
+                             size_t langs_len) {
+    NDEF_STATS_FN(SMARTPOSTER_DECODE);
+    NDEF_RETURN_ON_FALSE(ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Sp", 2));
+
+    *poster_out = (ndef_smartposter_t){
+        .pos         = record->pos,
+        .records     = record->payload,
+        .records_len = record->payload_len,
+    };
+    ndef_istream_t      inner      = NDEF_ISTREAM_NEW(record->payload, record->payload_len);
+    ndef_message_iter_t iter       = NDEF_MESSAGE_ITER_NEW(&inner);
+    bool                has_uri    = false;
+    size_t              title_rank = SIZE_MAX;
+
+    // Walk the inner message once, keeping references into the payload.
+    while (!ndef_message_done(&iter)) {
+        ndef_record_t child;
+        NDEF_RETURN_ON_FALSE(ndef_message_next(&iter, &child));
+
+        ndef_uri_t  uri;
+        ndef_text_t title;
+        if (ndef_uri_decode(&child, &uri)) {
+            NDEF_RETURN_ON_FALSE(!has_uri, NDEF_STATS_FAIL(PAYLOAD););
+            has_uri             = true;
+            poster_out->prefix  = uri.prefix;
+            poster_out->uri     = uri.uri;
+            poster_out->uri_len = uri.uri_len;
+        } else if (ndef_text_decode(&child, &title)) {
+            size_t rank = ndef_lang_rank(title.lang, title.lang_len, langs, langs_len);
+            if (poster_out->title_count++ == 0 || rank < title_rank) {
+                title_rank                 = rank;
+                poster_out->title          = title.text;
+                poster_out->title_len      = title.text_len;
+                poster_out->title_encoding = title.encoding;
+                poster_out->title_lang     = title.lang;
+                poster_out->title_lang_len = title.lang_len;
+            }
+        } else if (ndef_record_is_type(&child, NDEF_TNF_WELL_KNOWN, "act", 3)) {
+            NDEF_RETURN_ON_FALSE(child.payload_len == 1, NDEF_STATS_FAIL(PAYLOAD););
+            poster_out->has_action = true;
+            poster_out->action     = child.payload[0];
+        } else if (ndef_record_is_type(&child, NDEF_TNF_WELL_KNOWN, "s", 1)) {
+            NDEF_RETURN_ON_FALSE(child.payload_len == 4, NDEF_STATS_FAIL(PAYLOAD););
+            poster_out->has_size = true;
+            poster_out->size     = (uint32_t)child.payload[0] << 24 | (uint32_t)child.payload[1] << 16 |
+                                   (uint32_t)child.payload[2] << 8 | child.payload[3];
+        } else if (ndef_record_is_type(&child, NDEF_TNF_WELL_KNOWN, "t", 1)) {
+            poster_out->mime_type     = (const char*)child.payload;
+            poster_out->mime_type_len = child.payload_len;
+        } else if (child.tnf == NDEF_TNF_MIME_MEDIA && child.type_len >= 6 &&
+                   (strncmp(child.type, "image/", 6) == 0 || strncmp(child.type, "video/", 6) == 0)) {
+            poster_out->icon_type     = child.type;
+            poster_out->icon_type_len = child.type_len;
+            poster_out->icon          = child.payload;
+            poster_out->icon_len      = child.payload_len;
+        }
+    }
+
+    NDEF_RETURN_ON_FALSE(has_uri, NDEF_STATS_FAIL(PAYLOAD););
+    return true;
+}
+
+// Read an NDEF Smart Poster record, choosing the title by a list of language codes in order of preference.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_smartposter_read_lang(ndef_istream_t* istream, ndef_smartposter_t* poster_out, const char* const* langs,
+                                  size_t langs_len) {
+    ndef_record_t well_known;
+    size_t        record_len = NDEF_RETURN_ON_FALSE(ndef_read_record(istream, &well_known));
+    NDEF_RETURN_ON_FALSE(
+        ndef_smartposter_decode(&well_known, poster_out, langs, langs_len),
+        ndef_istream_reject(istream, record_len, ndef_record_is_type(&well_known, NDEF_TNF_WELL_KNOWN, "Sp", 2)););
+    return record_len;
+}
 
 // Read an NDEF Smart Poster record.
 // The strings within are a reference to the blob passed.
 // Returns how long the record was read, or 0 on error.
-size_t ndef_smartposter_read(ndef_istream_t* istream, ndef_smartposter_t* poster_out);
+size_t ndef_smartposter_read(ndef_istream_t* istream, ndef_smartposter_t* poster_out) {
+    return ndef_smartposter_read_lang(istream, poster_out, NULL, 0);
+}
 
-// Write an NDEF Smart Poster record.
-// Returns how long the record was written, or 0 on error.
-size_t ndef_smartposter_write(ndef_ostream_t* ostream, const ndef_smartposter_t poster, ndef_pos_t pos) {
-    NDEF_RETURN_ON_FALSE(poster.uri_len);
+// Get the next title of a Smart Poster read by `ndef_smartposter_read`.
+bool ndef_smartposter_next_title(const ndef_smartposter_t* poster, size_t* offset, ndef_text_t* title_out) {
+    ndef_istream_t inner = {.data = poster->records, .len = poster->records_len, .index = *offset};
+    while (ndef_istream_available(&inner)) {
+        ndef_record_t child;
+        NDEF_RETURN_ON_FALSE(ndef_read_record(&inner, &child));
+        // Like the decoder, ignore anything after the last record of the inner message.
+        if (child.pos & NDEF_POS_END) {
+            inner.index = inner.len;
+        }
+        if (ndef_text_decode(&child, title_out)) {
+            *offset = inner.index;
+            return true;
+        }
+    }
+    *offset = inner.index;
+    return false;
+}
 
-    // Create inner records.
-    ndef_ostream_t inner_ostream = NDEF_OSTREAM_NEW();
+// Get the inner URI record of a Smart Poster.
+static inline ndef_uri_t ndef_smartposter_uri(const ndef_smartposter_t* poster) {
+    return (ndef_uri_t){
+        .prefix  = poster->prefix,
+        .uri     = poster->uri,
+        .uri_len = poster->uri_len,
+    };
+}
 
-    ndef_uri_t uri = {
-        .prefix  = poster.prefix,
-        .uri     = poster.uri,
-        .uri_len = poster.uri_len,
+// Get the inner title record of a Smart Poster.
+static inline ndef_text_t ndef_smartposter_title(const ndef_smartposter_t* poster) {
+    return (ndef_text_t){
+        .encoding = poster->title_encoding,
+        .lang     = poster->title_lang,
+        .lang_len = poster->title_lang_len,
+        .text     = poster->title,
+        .text_len = poster->title_len,
     };
-    NDEF_RETURN_ON_FALSE(ndef_uri_write(&inner_ostream, uri, poster.title_len ? NDEF_POS_START : NDEF_POS_START_END),
-                         free(inner_ostream.data););
+}
+
+// Get the inner icon record of a Smart Poster.
+static inline ndef_record_t ndef_smartposter_icon(const ndef_smartposter_t* poster) {
+    return (ndef_record_t){
+        .tnf         = NDEF_TNF_MIME_MEDIA,
+        .type_len    = poster->icon_type_len,
+        .type        = poster->icon_type,
+        .payload_len = poster->icon_len,
+        .payload     = poster->icon,
+    };
+}
 
+// Get the number of inner records of a Smart Poster.
+static size_t ndef_smartposter_count(const ndef_smartposter_t* poster) {
+    return 1 + !!poster->title_len + poster->has_action + poster->has_size + !!poster->mime_type_len +
+           !!poster->icon_type_len;
+}
+
+// Get the payload size of an NDEF Smart Poster record.
+size_t ndef_smartposter_payload_size(const ndef_smartposter_t poster) {
+    size_t size = ndef_uri_encoded_size(ndef_smartposter_uri(&poster));
     if (poster.title_len) {
-        ndef_text_t title = {
-            .lang     = NULL,
-            .lang_len = 0,
-            .text     = poster.title,
-            .text_len = poster.title_len,
+        size += ndef_text_encoded_size(ndef_smartposter_title(&poster));
+    }
+    if (poster.has_action) {
+        size += ndef_record_encoded_size(3, 0, 1);
+    }
+    if (poster.has_size) {
+        size += ndef_record_encoded_size(1, 0, 4);
+    }
+    if (poster.mime_type_len) {
+        size += ndef_record_encoded_size(1, 0, poster.mime_type_len);
+    }
+    if (poster.icon_type_len) {
+        size += ndef_record_encoded_size(poster.icon_type_len, 0, poster.icon_len);
+    }
+    return size;
+}
+
+// Get the encoded size of an NDEF Smart Poster record.
+size_t ndef_smartposter_encoded_size(const ndef_smartposter_t poster) {
+    return ndef_record_encoded_size(2, 0, ndef_smartposter_payload_size(poster));
+}
+
+// Write the inner records of a Smart Poster.
+static bool ndef_smartposter_write_inner(ndef_ostream_t* ostream, const ndef_smartposter_t* poster) {
+    size_t count = ndef_smartposter_count(poster);
+    size_t index = 0;
+
+    NDEF_RETURN_ON_FALSE(ndef_uri_write(ostream, ndef_smartposter_uri(poster), ndef_pos_at(index++, count)));
+    if (poster->title_len) {
+        NDEF_RETURN_ON_FALSE(ndef_text_write(ostream, ndef_smartposter_title(poster), ndef_pos_at(index++, count)));
+    }
+    if (poster->has_action) {
+        NDEF_RETURN_ON_FALSE(ndef_write_record(ostream, NDEF_TNF_WELL_KNOWN, "act", ndef_pos_at(index++, count), 1));
+        NDEF_RETURN_ON_FALSE(ndef_ostream_push(ostream, poster->action));
+    }
+    if (poster->has_size) {
+        uint8_t size_bytes[4] = {
+            (uint8_t)(poster->size >> 24),
+            (uint8_t)(poster->size >> 16),
+            (uint8_t)(poster->size >> 8),
+            (uint8_t)(poster->size),
         };
-        NDEF_RETURN_ON_FALSE(ndef_text_write(&inner_ostream, title, NDEF_POS_END), free(inner_ostream.data););
+        NDEF_RETURN_ON_FALSE(ndef_write_record(ostream, NDEF_TNF_WELL_KNOWN, "s", ndef_pos_at(index++, count), 4));
+        NDEF_RETURN_ON_FALSE(ndef_ostream_extend(ostream, size_bytes, sizeof(size_bytes)));
+    }
+    if (poster->mime_type_len) {
+        NDEF_RETURN_ON_FALSE(
+            ndef_write_record(ostream, NDEF_TNF_WELL_KNOWN, "t", ndef_pos_at(index++, count), poster->mime_type_len));
+        NDEF_RETURN_ON_FALSE(ndef_ostream_extend(ostream, (const uint8_t*)poster->mime_type, poster->mime_type_len));
     }
+    if (poster->icon_type_len) {
+        ndef_record_t icon = ndef_smartposter_icon(poster);
+        icon.pos           = ndef_pos_at(index++, count);
+        NDEF_RETURN_ON_FALSE(ndef_write_raw(ostream, &icon));
+    }
+    return true;
+}
+
+// Write an NDEF Smart Poster record.
+// Returns how long the record was written, or 0 on error.
+size_t ndef_smartposter_write(ndef_ostream_t* ostream, const ndef_smartposter_t poster, ndef_pos_t pos) {
+    NDEF_STATS_FN(SMARTPOSTER_WRITE);
+    NDEF_RETURN_ON_FALSE(poster.uri_len, ndef_ostream_fail(ostream, NDEF_ERR_INVALID_ARG););
 
-    // Write the outer record.
-    size_t header_size = NDEF_RETURN_ON_FALSE(
-        ndef_write_record(ostream, NDEF_TNF_WELL_KNOWN, "Sp", pos, inner_ostream.len), free(inner_ostream.data););
-    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(ostream, inner_ostream.data, inner_ostream.len),
-                         free(inner_ostream.data););
+    // The header reserves space for the whole payload, so the inner records are written in place.
+    size_t start = ostream->len;
+    NDEF_RETURN_ON_FALSE(
+        ndef_write_record(ostream, NDEF_TNF_WELL_KNOWN, "Sp", pos, ndef_smartposter_payload_size(poster)));
+    NDEF_RETURN_ON_FALSE(ndef_smartposter_write_inner(ostream, &poster), ostream->len = start;);
 
-    free(inner_ostream.data);
-    return inner_ostream.len + header_size;
+    return ostream->len - start;
 }
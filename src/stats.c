@@ -0,0 +1,95 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/stats.h"
+#include <string.h>
+
+#if NDEF_STATS
+ndef_stats_t       ndef_stats_live;
+ndef_stats_clock_t ndef_stats_clock;
+
+// Number of word-sized counters at the start of `ndef_stats_t`, before the times.
+#define NDEF_STATS_NUM_COUNTERS (offsetof(ndef_stats_t, time) / sizeof(ndef_stats_counter_t))
+
+_Static_assert(__atomic_always_lock_free(sizeof(ndef_stats_time_t), 0), "times must be updated without locking");
+#endif
+
+// Names of the instrumented functions.
+static const char* const ndef_stats_fn_names[NDEF_STATS_FN_COUNT] = {
+    [NDEF_STATS_FN_READ_RECORD]        = "read_record",
+    [NDEF_STATS_FN_WRITE_HEADER]       = "write_header",
+    [NDEF_STATS_FN_MESSAGE_NEXT]       = "message_next",
+    [NDEF_STATS_FN_MESSAGE_WRITE]      = "message_write",
+    [NDEF_STATS_FN_BATCH_WRITE]        = "batch_write",
+    [NDEF_STATS_FN_DECD_DECODE]        = "decd_decode",
+    [NDEF_STATS_FN_DECD_WRITE]         = "decd_write",
+    [NDEF_STATS_FN_PARSER_FEED]        = "parser_feed",
+    [NDEF_STATS_FN_URI_DECODE]         = "uri_decode",
+    [NDEF_STATS_FN_URI_WRITE]          = "uri_write",
+    [NDEF_STATS_FN_TEXT_DECODE]        = "text_decode",
+    [NDEF_STATS_FN_TEXT_WRITE]         = "text_write",
+    [NDEF_STATS_FN_SMARTPOSTER_DECODE] = "smartposter_decode",
+    [NDEF_STATS_FN_SMARTPOSTER_WRITE]  = "smartposter_write",
+    [NDEF_STATS_FN_WIFI_DECODE]        = "wifi_decode",
+    [NDEF_STATS_FN_WIFI_WRITE]         = "wifi_write",
+    [NDEF_STATS_FN_TLV_READ]           = "tlv_read",
+    [NDEF_STATS_FN_DIFF]               = "diff",
+};
+
+// Names of the parse failure reasons.
+static const char* const ndef_stats_fail_names[NDEF_STATS_FAIL_COUNT] = {
+    [NDEF_STATS_FAIL_TRUNCATED]     = "truncated",
+    [NDEF_STATS_FAIL_MESSAGE_FLAGS] = "message_flags",
+    [NDEF_STATS_FAIL_CHUNK]         = "chunk",
+    [NDEF_STATS_FAIL_PAYLOAD]       = "payload",
+};
+
+// Set the clock used to time instrumented functions, or NULL to stop timing them.
+void ndef_stats_set_clock(ndef_stats_clock_t clock) {
+#if NDEF_STATS
+    __atomic_store_n(&ndef_stats_clock, clock, __ATOMIC_RELAXED);
+#else
+    (void)clock;
+#endif
+}
+
+// Copy the current statistics into `stats_out`.
+void ndef_stats_snapshot(ndef_stats_t* stats_out) {
+#if NDEF_STATS
+    // The statistics are nothing but counters and times, so they can be copied one by one.
+    const ndef_stats_counter_t* src = (const ndef_stats_counter_t*)&ndef_stats_live;
+    ndef_stats_counter_t*       dst = (ndef_stats_counter_t*)stats_out;
+    for (size_t i = 0; i < NDEF_STATS_NUM_COUNTERS; i++) {
+        dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+    }
+    for (size_t i = 0; i < NDEF_STATS_FN_COUNT; i++) {
+        stats_out->time[i] = __atomic_load_n(&ndef_stats_live.time[i], __ATOMIC_RELAXED);
+    }
+#else
+    memset(stats_out, 0, sizeof(ndef_stats_t));
+#endif
+}
+
+// Reset all statistics to zero.
+void ndef_stats_reset(void) {
+#if NDEF_STATS
+    ndef_stats_counter_t* counters = (ndef_stats_counter_t*)&ndef_stats_live;
+    for (size_t i = 0; i < NDEF_STATS_NUM_COUNTERS; i++) {
+        __atomic_store_n(&counters[i], 0, __ATOMIC_RELAXED);
+    }
+    for (size_t i = 0; i < NDEF_STATS_FN_COUNT; i++) {
+        __atomic_store_n(&ndef_stats_live.time[i], 0, __ATOMIC_RELAXED);
+    }
+#endif
+}
+
+// Get the name of an instrumented function.
+const char* ndef_stats_fn_name(ndef_stats_fn_t fn) {
+    return (size_t)fn < NDEF_STATS_FN_COUNT ? ndef_stats_fn_names[fn] : "unknown";
+}
+
+// Get the name of a parse failure reason.
+const char* ndef_stats_fail_name(ndef_stats_fail_t reason) {
+    return (size_t)reason < NDEF_STATS_FAIL_COUNT ? ndef_stats_fail_names[reason] : "unknown";
+}
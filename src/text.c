@@ -3,29 +3,116 @@
 // SPDX-License-Identifier: MIT
 
 #include "ndef/text.h"
+#include "ndef/utf.h"
+
+// Decode the payload of an NDEF text record that has already been read.
+// The strings within are a reference to the record's payload.
+bool ndef_text_decode(const ndef_record_t* record, ndef_text_t* text_out) {
+    NDEF_STATS_FN(TEXT_DECODE);
+    NDEF_RETURN_ON_FALSE(ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "T", 1));
+    NDEF_RETURN_ON_FALSE(record->payload_len >= 1, NDEF_STATS_FAIL(PAYLOAD););
+    // Status byte: bit 7 is the encoding, bit 6 is reserved and bits 5-0 are the language code length.
+    size_t lang_len = record->payload[0] & 0x3f;
+    NDEF_RETURN_ON_FALSE(record->payload_len - 1 >= lang_len, NDEF_STATS_FAIL(PAYLOAD););
+    text_out->pos      = record->pos;
+    text_out->encoding = record->payload[0] & 0x80 ? NDEF_TEXT_UTF16 : NDEF_TEXT_UTF8;
+    text_out->lang_len = lang_len;
+    text_out->text_len = record->payload_len - lang_len - 1;
+    text_out->lang     = (const char*)record->payload + 1;
+    text_out->text     = text_out->lang + text_out->lang_len;
+    return true;
+}
 
 // Read an NDEF text record.
 // The strings within are a reference to the blob passed.
+// On success, `istream` is advanced past the record.
 // Returns how long the record was read, or 0 on error.
 size_t ndef_text_read(ndef_istream_t* istream, ndef_text_t* text_out) {
     ndef_record_t well_known;
     size_t        record_len = NDEF_RETURN_ON_FALSE(ndef_read_record(istream, &well_known));
-    NDEF_RETURN_ON_FALSE(well_known.type_len == 1 && well_known.type[0] == 'T');
-    NDEF_RETURN_ON_FALSE(well_known.payload_len >= 1);
-    text_out->pos      = well_known.pos;
-    text_out->lang_len = well_known.payload[0] & 0x3f;
-    text_out->text_len = well_known.payload_len - text_out->lang_len - 1;
-    text_out->lang     = (const char*)well_known.payload + 1;
-    text_out->text     = text_out->lang + text_out->lang_len;
+    NDEF_RETURN_ON_FALSE(
+        ndef_text_decode(&well_known, text_out),
+        ndef_istream_reject(istream, record_len, ndef_record_is_type(&well_known, NDEF_TNF_WELL_KNOWN, "T", 1)););
     return record_len;
 }
 
 // Write an NDEF text record.
 bool ndef_text_write(ndef_ostream_t* data_out, ndef_text_t text, ndef_pos_t pos) {
-    NDEF_RETURN_ON_FALSE(ndef_write_record(data_out, NDEF_TNF_WELL_KNOWN, "T", pos, text.lang_len + text.text_len + 1));
-    NDEF_RETURN_ON_FALSE(text.lang_len <= 0x3f);
-    NDEF_RETURN_ON_FALSE(ndef_ostream_push(data_out, text.lang_len));
-    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, (uint8_t*)text.lang, text.lang_len));
-    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, (uint8_t*)text.text, text.text_len));
+    NDEF_STATS_FN(TEXT_WRITE);
+    NDEF_RETURN_ON_FALSE(text.lang_len <= 0x3f, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    if (text.encoding == NDEF_TEXT_UTF16) {
+        NDEF_RETURN_ON_FALSE(text.text_len % 2 == 0, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    } else {
+        NDEF_RETURN_ON_FALSE(ndef_utf8_valid((const uint8_t*)text.text, text.text_len),
+                             ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    }
+    NDEF_RETURN_ON_FALSE(ndef_write_record(data_out, NDEF_TNF_WELL_KNOWN, "T", pos, ndef_text_payload_size(text)));
+    uint8_t status = text.lang_len | (text.encoding == NDEF_TEXT_UTF16 ? 0x80 : 0);
+    NDEF_RETURN_ON_FALSE(ndef_ostream_push(data_out, status));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, (const uint8_t*)text.lang, text.lang_len));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, (const uint8_t*)text.text, text.text_len));
+    return true;
+}
+
+// Write an NDEF text record whose text is the concatenation of `slices`, in `encoding`.
+bool ndef_text_write_slices(ndef_ostream_t* data_out, ndef_text_encoding_t encoding, const char* lang, size_t lang_len,
+                            const ndef_slice_t* slices, size_t slices_len, ndef_pos_t pos) {
+    NDEF_STATS_FN(TEXT_WRITE);
+    size_t text_len = ndef_slices_len(slices, slices_len);
+    NDEF_RETURN_ON_FALSE(lang_len <= 0x3f && (encoding != NDEF_TEXT_UTF16 || text_len % 2 == 0),
+                         ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    size_t start = data_out->len;
+    NDEF_RETURN_ON_FALSE(ndef_write_record(data_out, NDEF_TNF_WELL_KNOWN, "T", pos, 1 + lang_len + text_len));
+    uint8_t status = lang_len | (encoding == NDEF_TEXT_UTF16 ? 0x80 : 0);
+    NDEF_RETURN_ON_FALSE(ndef_ostream_push(data_out, status), data_out->len = start;);
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, (const uint8_t*)lang, lang_len), data_out->len = start;);
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend_slices(data_out, slices, slices_len), data_out->len = start;);
+    if (encoding != NDEF_TEXT_UTF16) {
+        // Checked in the output, where the pieces are contiguous.
+        NDEF_RETURN_ON_FALSE(ndef_utf8_valid(data_out->data + data_out->len - text_len, text_len),
+                             data_out->len = start; ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    }
+    return true;
+}
+
+// Write an NDEF text record with UTF-16 text transcoded from the UTF-8 `text`.
+bool ndef_text_write_utf16(ndef_ostream_t* data_out, const char* lang, size_t lang_len, const char* text,
+                           size_t text_len, ndef_pos_t pos) {
+    NDEF_RETURN_ON_FALSE(lang_len <= 0x3f, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    NDEF_RETURN_ON_FALSE(ndef_utf8_valid((const uint8_t*)text, text_len),
+                         ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    size_t utf16_len = ndef_utf8_utf16_len((const uint8_t*)text, text_len);
+    size_t start     = data_out->len;
+    NDEF_RETURN_ON_FALSE(ndef_write_record(data_out, NDEF_TNF_WELL_KNOWN, "T", pos, 1 + lang_len + utf16_len));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_push(data_out, lang_len | 0x80), data_out->len = start;);
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, (const uint8_t*)lang, lang_len), data_out->len = start;);
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve_extra(data_out, utf16_len), data_out->len = start;);
+
+    // Transcode in place instead of building the UTF-16 text in a separate buffer first.
+    ndef_utf8_decoder_t decoder = {.big_endian = true};
+    const uint8_t*      in      = (const uint8_t*)text;
+    data_out->len += ndef_utf8_to_utf16(&decoder, &in, &text_len, data_out->data + data_out->len, utf16_len);
+    return true;
+}
+
+// Get the text of an NDEF text record as UTF-8.
+bool ndef_text_get_utf8(const ndef_text_t* text, char* buf, size_t buf_cap, const char** utf8_out,
+                        size_t* utf8_len_out) {
+    if (text->encoding == NDEF_TEXT_UTF8) {
+        // Fast path: the text is already UTF-8 and only needs to be checked.
+        NDEF_RETURN_ON_FALSE(ndef_utf8_valid((const uint8_t*)text->text, text->text_len));
+        *utf8_out     = text->text;
+        *utf8_len_out = text->text_len;
+        return true;
+    }
+    ndef_utf16_decoder_t decoder = {.big_endian = true};
+    const uint8_t*       in      = (const uint8_t*)text->text;
+    size_t               in_len  = text->text_len;
+    size_t               len     = ndef_utf16_to_utf8(&decoder, &in, &in_len, (uint8_t*)buf, buf_cap);
+    NDEF_RETURN_ON_FALSE(in_len == 0);
+    len += ndef_utf16_to_utf8_finish(&decoder, (uint8_t*)buf + len, buf_cap - len);
+    NDEF_RETURN_ON_FALSE(decoder.pending_len == 0);
+    *utf8_out     = buf;
+    *utf8_len_out = len;
     return true;
 }
@@ -0,0 +1,129 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/tlv.h"
+#include <string.h>
+
+// Write the header of a TLV block whose value of `len` bytes is written next, e.g. by `ndef_message_write`.
+bool ndef_tlv_write_header(ndef_ostream_t* data_out, ndef_tlv_type_t type, size_t len) {
+    NDEF_RETURN_ON_FALSE(len <= NDEF_TLV_MAX_LEN, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve_extra(data_out, ndef_tlv_encoded_size(len)));
+    if (len < 0xff) {
+        uint8_t header[2] = {type, len};
+        return ndef_ostream_extend(data_out, header, sizeof(header));
+    }
+    uint8_t header[4] = {type, 0xff, len >> 8, len};
+    return ndef_ostream_extend(data_out, header, sizeof(header));
+}
+
+// Write a TLV block.
+bool ndef_tlv_write(ndef_ostream_t* data_out, ndef_tlv_type_t type, const uint8_t* value, size_t len) {
+    NDEF_RETURN_ON_FALSE(ndef_tlv_write_header(data_out, type, len));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, value, len));
+    return true;
+}
+
+// Begin writing a TLV block whose length is not known in advance.
+bool ndef_tlv_write_begin(ndef_ostream_t* data_out, ndef_tlv_type_t type, size_t* mark_out) {
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve_extra(data_out, 4));
+    *mark_out = data_out->len;
+    // The 2-byte length is filled in by `ndef_tlv_write_end`.
+    uint8_t header[4] = {type, 0xff, 0, 0};
+    return ndef_ostream_extend(data_out, header, sizeof(header));
+}
+
+// Finish writing a TLV block started with `ndef_tlv_write_begin`.
+size_t ndef_tlv_write_end(ndef_ostream_t* data_out, size_t mark) {
+    NDEF_RETURN_ON_FALSE(data_out->len >= mark + 4, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    uint8_t* header = data_out->data + mark;
+    size_t   len    = data_out->len - mark - 4;
+    NDEF_RETURN_ON_FALSE(len <= NDEF_TLV_MAX_LEN, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    if (len < 0xff) {
+        header[1] = len;
+        memmove(header + 2, header + 4, len);
+        data_out->len -= 2;
+    } else {
+        header[2] = len >> 8;
+        header[3] = len;
+    }
+    return data_out->len - mark;
+}
+
+// Write a Terminator TLV and pad the output with NULL TLVs up to a multiple of `page_size` bytes.
+bool ndef_tlv_write_terminator(ndef_ostream_t* data_out, size_t page_size) {
+    size_t len = data_out->len + 1;
+    if (page_size > 1 && len % page_size) {
+        len += page_size - len % page_size;
+    }
+    NDEF_RETURN_ON_FALSE(ndef_ostream_reserve(data_out, len));
+    data_out->data[data_out->len] = NDEF_TLV_TERMINATOR;
+    memset(data_out->data + data_out->len + 1, NDEF_TLV_NULL, len - data_out->len - 1);
+    data_out->len = len;
+    return true;
+}
+
+// Read a TLV block.
+// Returns how long the block was read, or 0 on error.
+size_t ndef_tlv_read(ndef_istream_t* istream, ndef_tlv_t* tlv_out) {
+    NDEF_STATS_FN(TLV_READ);
+    size_t available = ndef_istream_available(istream);
+    NDEF_RETURN_ON_FALSE(available >= 1, ndef_istream_truncated(istream););
+    const uint8_t* data = istream->data + istream->index;
+    *tlv_out            = (ndef_tlv_t){
+        .type   = data[0],
+        .offset = istream->index,
+        .value  = data + 1,
+        .len    = 0,
+    };
+    if (data[0] == NDEF_TLV_NULL || data[0] == NDEF_TLV_TERMINATOR) {
+        istream->index++;
+        return 1;
+    }
+
+    size_t header_len;
+    NDEF_RETURN_ON_FALSE(available >= 2, ndef_istream_truncated(istream););
+    if (data[1] == 0xff) {
+        NDEF_RETURN_ON_FALSE(available >= 4, ndef_istream_truncated(istream););
+        tlv_out->len = (size_t)data[2] << 8 | data[3];
+        header_len   = 4;
+    } else {
+        tlv_out->len = data[1];
+        header_len   = 2;
+    }
+    NDEF_RETURN_ON_FALSE(available - header_len >= tlv_out->len, ndef_istream_truncated(istream););
+    tlv_out->value  = data + header_len;
+    istream->index += header_len + tlv_out->len;
+    return header_len + tlv_out->len;
+}
+
+// Find the first TLV block of type `type`, stopping at a Terminator TLV.
+bool ndef_tlv_find(ndef_istream_t* istream, ndef_tlv_type_t type, ndef_tlv_t* tlv_out) {
+    size_t start = istream->index;
+    while (ndef_tlv_read(istream, tlv_out)) {
+        if (tlv_out->type == type) {
+            return true;
+        } else if (tlv_out->type == NDEF_TLV_TERMINATOR) {
+            break;
+        }
+    }
+    istream->index = start;
+    return false;
+}
+
+// Decode the value of a Lock Control or Memory Control TLV.
+bool ndef_tlv_control_decode(const ndef_tlv_t* tlv, ndef_tlv_control_t* control_out) {
+    NDEF_RETURN_ON_FALSE(tlv->type == NDEF_TLV_LOCK_CONTROL || tlv->type == NDEF_TLV_MEMORY_CONTROL);
+    NDEF_RETURN_ON_FALSE(tlv->len == 3);
+    // Position: number of major and minor offsets; page control: bytes locked per bit and major offset size.
+    const uint8_t* value      = tlv->value;
+    size_t         majors     = value[0] >> 4;
+    size_t         minors     = value[0] & 0x0f;
+    size_t         major_size = (size_t)1 << (value[2] & 0x0f);
+    *control_out              = (ndef_tlv_control_t){
+        .address            = majors * major_size + minors,
+        .size               = value[1] ? value[1] : 256,
+        .bytes_per_lock_bit = tlv->type == NDEF_TLV_LOCK_CONTROL ? (size_t)1 << (value[2] >> 4) : 0,
+    };
+    return true;
+}
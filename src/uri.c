@@ -43,46 +43,57 @@ const char* const ndef_uri_prefixes[] = {
     [NDEF_URI_PREFIX_URN_NFC]                 = "urn:nfc:",
 };
 
+// Decode the payload of an NDEF URI record that has already been read.
+// The strings within are a reference to the record's payload.
+bool ndef_uri_decode(const ndef_record_t* record, ndef_uri_t* uri_out) {
+    NDEF_STATS_FN(URI_DECODE);
+    NDEF_RETURN_ON_FALSE(ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "U", 1));
+    NDEF_RETURN_ON_FALSE(record->payload_len >= 1 && record->payload[0] < NDEF_URI_NUM_PREFIX,
+                         NDEF_STATS_FAIL(PAYLOAD););
+    uri_out->prefix  = record->payload[0];
+    uri_out->uri     = (const char*)(record->payload + 1);
+    uri_out->uri_len = record->payload_len - 1;
+    uri_out->pos     = record->pos;
+    return true;
+}
+
 // Read an NDEF URI record.
 // The strings within are a reference to the blob passed.
+// On success, `istream` is advanced past the record.
 // Returns how long the record was read, or 0 on error.
 size_t ndef_uri_read(ndef_istream_t* istream, ndef_uri_t* uri_out) {
     ndef_record_t well_known;
     size_t        record_len = NDEF_RETURN_ON_FALSE(ndef_read_record(istream, &well_known));
-    NDEF_RETURN_ON_FALSE(well_known.type_len == 1 && well_known.type[0] == 'U');
-    uri_out->prefix = istream->data[istream->index++];
-    NDEF_RETURN_ON_FALSE(uri_out->prefix < NDEF_URI_NUM_PREFIX);
-    uri_out->uri     = (const char*)(well_known.payload + 1);
-    uri_out->uri_len = well_known.payload_len - 1;
-    uri_out->pos     = well_known.pos;
+    NDEF_RETURN_ON_FALSE(
+        ndef_uri_decode(&well_known, uri_out),
+        ndef_istream_reject(istream, record_len, ndef_record_is_type(&well_known, NDEF_TNF_WELL_KNOWN, "U", 1)););
     return record_len;
 }
 
 // Make an NDEF URI from a string.
 ndef_uri_t ndef_uri_format(const char* uri, size_t uri_len) {
-    // This has a pos field, but it is ignored by `ndef_uri_write`.
-    ndef_uri_t cur        = {NDEF_POS_MIDDLE, NDEF_URI_NO_PREFIX, uri, uri_len};
-    size_t     prefix_len = 0;
-    for (ndef_uri_prefix_t prefix = 0; prefix < NDEF_URI_NUM_PREFIX; prefix++) {
-        const char* prefix_str = ndef_uri_prefixes[prefix];
-        if (!prefix_str) {
-            continue;
-        }
-        size_t len = strlen(prefix_str);
-        if (len > prefix_len && uri_len >= len && strncmp(uri, prefix_str, len) == 0) {
-            cur.prefix  = prefix;
-            cur.uri     = uri + len;
-            cur.uri_len = uri_len - len;
-            prefix_len  = len;
-        }
-    }
-    return cur;
+    return ndef_uri_format_inline(uri, uri_len);
 }
 
 // Write an NDEF URI record.
 bool ndef_uri_write(ndef_ostream_t* data_out, ndef_uri_t uri, ndef_pos_t pos) {
-    NDEF_RETURN_ON_FALSE(ndef_write_record(data_out, NDEF_TNF_WELL_KNOWN, "U", pos, uri.uri_len + 1));
+    NDEF_STATS_FN(URI_WRITE);
+    NDEF_RETURN_ON_FALSE(ndef_write_record(data_out, NDEF_TNF_WELL_KNOWN, "U", pos, ndef_uri_payload_size(uri)));
     NDEF_RETURN_ON_FALSE(ndef_ostream_push(data_out, uri.prefix));
-    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, (uint8_t*)uri.uri, uri.uri_len));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend(data_out, (const uint8_t*)uri.uri, uri.uri_len));
+    return true;
+}
+
+// Write an NDEF URI record whose URI is `prefix` followed by the concatenation of `slices`.
+bool ndef_uri_write_slices(ndef_ostream_t* data_out, ndef_uri_prefix_t prefix, const ndef_slice_t* slices,
+                           size_t slices_len, ndef_pos_t pos) {
+    NDEF_STATS_FN(URI_WRITE);
+    size_t uri_len = ndef_slices_len(slices, slices_len);
+    // A saturated length would wrap around to an empty payload.
+    NDEF_RETURN_ON_FALSE(uri_len < SIZE_MAX, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    size_t start = data_out->len;
+    NDEF_RETURN_ON_FALSE(ndef_write_record(data_out, NDEF_TNF_WELL_KNOWN, "U", pos, 1 + uri_len));
+    NDEF_RETURN_ON_FALSE(ndef_ostream_push(data_out, prefix), data_out->len = start;);
+    NDEF_RETURN_ON_FALSE(ndef_ostream_extend_slices(data_out, slices, slices_len), data_out->len = start;);
     return true;
 }
@@ -0,0 +1,396 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/utf.h"
+#include <string.h>
+
+// Decoded in place of a code point for invalid input.
+#define NDEF_UTF_INVALID UINT32_MAX
+// Decoded in place of a code point for a byte order mark, which produces no output.
+#define NDEF_UTF_NONE    (UINT32_MAX - 1)
+
+// Decode one UTF-8 sequence.
+// Returns its length, or 0 if `len` ends within an otherwise valid sequence.
+// An invalid sequence decodes as `NDEF_UTF_INVALID` and has the length of its longest valid prefix, at least 1.
+static inline size_t ndef_utf8_decode(const uint8_t* data, size_t len, uint32_t* cp_out) {
+    uint8_t  lead = data[0];
+    uint8_t  lo   = 0x80;
+    uint8_t  hi   = 0xbf;
+    size_t   seq_len;
+    uint32_t cp;
+    if (lead < 0x80) {
+        *cp_out = lead;
+        return 1;
+    } else if (lead < 0xc2) {
+        // Continuation byte, or the lead of an overlong 2-byte form.
+        *cp_out = NDEF_UTF_INVALID;
+        return 1;
+    } else if (lead < 0xe0) {
+        seq_len = 2;
+        cp      = lead & 0x1f;
+    } else if (lead < 0xf0) {
+        // Exclude overlong forms and UTF-16 surrogates.
+        seq_len = 3;
+        cp      = lead & 0x0f;
+        lo      = lead == 0xe0 ? 0xa0 : 0x80;
+        hi      = lead == 0xed ? 0x9f : 0xbf;
+    } else if (lead < 0xf5) {
+        // Exclude overlong forms and code points above U+10FFFF.
+        seq_len = 4;
+        cp      = lead & 0x07;
+        lo      = lead == 0xf0 ? 0x90 : 0x80;
+        hi      = lead == 0xf4 ? 0x8f : 0xbf;
+    } else {
+        *cp_out = NDEF_UTF_INVALID;
+        return 1;
+    }
+    for (size_t i = 1; i < seq_len; i++) {
+        if (i >= len) {
+            return 0;
+        } else if (data[i] < lo || data[i] > hi) {
+            *cp_out = NDEF_UTF_INVALID;
+            return i;
+        }
+        cp = cp << 6 | (data[i] & 0x3f);
+        lo = 0x80;
+        hi = 0xbf;
+    }
+    *cp_out = cp;
+    return seq_len;
+}
+
+// Get the UTF-8 length of a code point.
+static inline size_t ndef_utf8_cp_len(uint32_t cp) {
+    return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+}
+
+// Encode a code point as UTF-8; `out` must have room for `ndef_utf8_cp_len(cp)` bytes.
+static inline void ndef_utf8_put(uint8_t* out, uint32_t cp) {
+    if (cp < 0x80) {
+        out[0] = cp;
+    } else if (cp < 0x800) {
+        out[0] = 0xc0 | cp >> 6;
+        out[1] = 0x80 | (cp & 0x3f);
+    } else if (cp < 0x10000) {
+        out[0] = 0xe0 | cp >> 12;
+        out[1] = 0x80 | (cp >> 6 & 0x3f);
+        out[2] = 0x80 | (cp & 0x3f);
+    } else {
+        out[0] = 0xf0 | cp >> 18;
+        out[1] = 0x80 | (cp >> 12 & 0x3f);
+        out[2] = 0x80 | (cp >> 6 & 0x3f);
+        out[3] = 0x80 | (cp & 0x3f);
+    }
+}
+
+// Get a UTF-16 code unit.
+static inline uint16_t ndef_utf16_get(const uint8_t* data, bool big_endian) {
+    return big_endian ? data[0] << 8 | data[1] : data[1] << 8 | data[0];
+}
+
+// Store a UTF-16 code unit.
+static inline void ndef_utf16_put(uint8_t* out, uint16_t unit, bool big_endian) {
+    out[!big_endian] = unit >> 8;
+    out[big_endian]  = unit;
+}
+
+// Check for a byte order mark and update `big_endian` accordingly.
+// Returns the length of the byte order mark, 0 if there is none.
+static inline size_t ndef_utf16_bom(const uint8_t* data, bool* big_endian) {
+    if (data[0] == 0xfe && data[1] == 0xff) {
+        *big_endian = true;
+        return 2;
+    } else if (data[0] == 0xff && data[1] == 0xfe) {
+        *big_endian = false;
+        return 2;
+    }
+    return 0;
+}
+
+// Decode one UTF-16 character.
+// Returns its length, or 0 if `len` ends within it. Unpaired surrogates decode as `NDEF_UTF_INVALID`.
+static inline size_t ndef_utf16_decode(const uint8_t* data, size_t len, bool big_endian, uint32_t* cp_out) {
+    if (len < 2) {
+        return 0;
+    }
+    uint16_t high = ndef_utf16_get(data, big_endian);
+    if (high < 0xd800 || high > 0xdfff) {
+        *cp_out = high;
+        return 2;
+    } else if (high >= 0xdc00) {
+        *cp_out = NDEF_UTF_INVALID;
+        return 2;
+    } else if (len < 4) {
+        return 0;
+    }
+    uint16_t low = ndef_utf16_get(data + 2, big_endian);
+    if (low < 0xdc00 || low > 0xdfff) {
+        *cp_out = NDEF_UTF_INVALID;
+        return 2;
+    }
+    *cp_out = 0x10000 + ((uint32_t)(high - 0xd800) << 10) + (low - 0xdc00);
+    return 4;
+}
+
+// Check whether `data` is well-formed UTF-8: no overlong forms, surrogates or code points above U+10FFFF.
+bool ndef_utf8_valid(const uint8_t* data, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        // Skip runs of ASCII a word at a time; most text on tags is ASCII.
+        while (len - i >= sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, data + i, sizeof(word));
+            if (word & 0x8080808080808080ull) {
+                break;
+            }
+            i += sizeof(word);
+        }
+        if (i >= len) {
+            break;
+        } else if (data[i] < 0x80) {
+            i++;
+            continue;
+        }
+        uint32_t cp;
+        size_t   seq_len = ndef_utf8_decode(data + i, len - i, &cp);
+        if (!seq_len || cp == NDEF_UTF_INVALID) {
+            return false;
+        }
+        i += seq_len;
+    }
+    return true;
+}
+
+// Get how many bytes of UTF-16 the UTF-8 `data` transcodes to, counting replacements of invalid sequences.
+size_t ndef_utf8_utf16_len(const uint8_t* data, size_t len) {
+    size_t out_len = 0;
+    size_t i       = 0;
+    while (i < len) {
+        uint32_t cp;
+        size_t   seq_len = ndef_utf8_decode(data + i, len - i, &cp);
+        if (!seq_len) {
+            // Truncated at the end; becomes one replacement character.
+            out_len += 2;
+            break;
+        }
+        out_len += cp != NDEF_UTF_INVALID && cp >= 0x10000 ? 4 : 2;
+        i       += seq_len;
+    }
+    return out_len;
+}
+
+// Get how many bytes of UTF-8 the UTF-16 `data` transcodes to, honoring and dropping a byte order mark.
+size_t ndef_utf16_utf8_len(const uint8_t* data, size_t len, bool big_endian) {
+    size_t out_len = 0;
+    size_t i       = len >= 2 ? ndef_utf16_bom(data, &big_endian) : 0;
+    while (i < len) {
+        uint32_t cp;
+        size_t   unit_len = ndef_utf16_decode(data + i, len - i, big_endian, &cp);
+        if (!unit_len) {
+            out_len += ndef_utf8_cp_len(NDEF_UTF_REPLACEMENT);
+            break;
+        }
+        out_len += ndef_utf8_cp_len(cp == NDEF_UTF_INVALID ? NDEF_UTF_REPLACEMENT : cp);
+        i       += unit_len;
+    }
+    return out_len;
+}
+
+// Take `len` consumed bytes, first from the pending bytes of a transcoder and then from its input.
+static inline void ndef_utf_consume(uint8_t* pending, uint8_t* pending_len, const uint8_t** in, size_t* in_len,
+                                    size_t len) {
+    size_t from_pending = len < *pending_len ? len : *pending_len;
+    memmove(pending, pending + from_pending, *pending_len - from_pending);
+    *pending_len -= from_pending;
+    *in          += len - from_pending;
+    *in_len      -= len - from_pending;
+}
+
+// Keep the rest of the input, which is too short to decode, until the next call.
+static inline void ndef_utf_stash(uint8_t* pending, uint8_t* pending_len, const uint8_t** in, size_t* in_len) {
+    if (*in_len) {
+        memcpy(pending + *pending_len, *in, *in_len);
+    }
+    *pending_len += *in_len;
+    *in          += *in_len;
+    *in_len       = 0;
+}
+
+// Gather the pending bytes of a transcoder and the start of its input into `buf`.
+// Returns how many bytes are in `buf`.
+static inline size_t ndef_utf_gather(uint8_t buf[4], const uint8_t* pending, size_t pending_len, const uint8_t* in,
+                                     size_t in_len) {
+    size_t take = 4 - pending_len < in_len ? 4 - pending_len : in_len;
+    memcpy(buf, pending, pending_len);
+    if (take) {
+        memcpy(buf + pending_len, in, take);
+    }
+    return pending_len + take;
+}
+
+// Decode the next character of a UTF-16 transcoder's input, or its byte order mark as `NDEF_UTF_NONE`.
+static inline size_t ndef_utf16_next(ndef_utf16_decoder_t* decoder, const uint8_t* data, size_t len,
+                                     uint32_t* cp_out) {
+    if (!decoder->started) {
+        if (len < 2) {
+            return 0;
+        }
+        decoder->started = true;
+        if (ndef_utf16_bom(data, &decoder->big_endian)) {
+            *cp_out = NDEF_UTF_NONE;
+            return 2;
+        }
+    }
+    return ndef_utf16_decode(data, len, decoder->big_endian, cp_out);
+}
+
+// Transcode UTF-16 from `*in` to UTF-8 in `out`, until the input is used up or the next character does not fit.
+size_t ndef_utf16_to_utf8(ndef_utf16_decoder_t* decoder, const uint8_t** in, size_t* in_len, uint8_t* out,
+                          size_t out_cap) {
+    size_t written = 0;
+
+    // Take the byte order mark and a character that was split across calls one at a time.
+    while (decoder->pending_len || !decoder->started) {
+        uint8_t        buf[4];
+        const uint8_t* data = *in;
+        size_t         len  = *in_len;
+        if (decoder->pending_len) {
+            len  = ndef_utf_gather(buf, decoder->pending, decoder->pending_len, *in, *in_len);
+            data = buf;
+        }
+        uint32_t cp;
+        size_t   unit_len = ndef_utf16_next(decoder, data, len, &cp);
+        if (!unit_len) {
+            ndef_utf_stash(decoder->pending, &decoder->pending_len, in, in_len);
+            return written;
+        }
+        if (cp != NDEF_UTF_NONE) {
+            cp            = cp == NDEF_UTF_INVALID ? NDEF_UTF_REPLACEMENT : cp;
+            size_t cp_len = ndef_utf8_cp_len(cp);
+            if (out_cap - written < cp_len) {
+                return written;
+            }
+            ndef_utf8_put(out + written, cp);
+            written += cp_len;
+        }
+        ndef_utf_consume(decoder->pending, &decoder->pending_len, in, in_len, unit_len);
+    }
+
+    // Then decode the rest straight from the input.
+    const uint8_t* data = *in;
+    size_t         len  = *in_len;
+    while (true) {
+        uint32_t cp;
+        size_t   unit_len = ndef_utf16_decode(data, len, decoder->big_endian, &cp);
+        if (!unit_len) {
+            *in     = data;
+            *in_len = len;
+            ndef_utf_stash(decoder->pending, &decoder->pending_len, in, in_len);
+            return written;
+        }
+        if (cp < 0x80 && written < out_cap) {
+            out[written++] = cp;
+        } else {
+            cp            = cp == NDEF_UTF_INVALID ? NDEF_UTF_REPLACEMENT : cp;
+            size_t cp_len = ndef_utf8_cp_len(cp);
+            if (out_cap - written < cp_len) {
+                break;
+            }
+            ndef_utf8_put(out + written, cp);
+            written += cp_len;
+        }
+        data += unit_len;
+        len  -= unit_len;
+    }
+    *in     = data;
+    *in_len = len;
+    return written;
+}
+
+// Flush a UTF-16 to UTF-8 transcoder at the end of its input, writing U+FFFD for a truncated code unit.
+size_t ndef_utf16_to_utf8_finish(ndef_utf16_decoder_t* decoder, uint8_t* out, size_t out_cap) {
+    if (!decoder->pending_len || out_cap < 3) {
+        return 0;
+    }
+    decoder->pending_len = 0;
+    ndef_utf8_put(out, NDEF_UTF_REPLACEMENT);
+    return 3;
+}
+
+// Store a code point as UTF-16, if it fits in `cap` bytes.
+// Returns how many bytes were written, or 0 if it does not fit.
+static inline size_t ndef_utf16_put_cp(uint8_t* out, size_t cap, uint32_t cp, bool big_endian) {
+    if (cp < 0x10000) {
+        if (cap < 2) {
+            return 0;
+        }
+        ndef_utf16_put(out, cp, big_endian);
+        return 2;
+    } else if (cap < 4) {
+        return 0;
+    }
+    ndef_utf16_put(out, 0xd800 + ((cp - 0x10000) >> 10), big_endian);
+    ndef_utf16_put(out + 2, 0xdc00 + ((cp - 0x10000) & 0x3ff), big_endian);
+    return 4;
+}
+
+// Transcode UTF-8 from `*in` to UTF-16 in `out`, until the input is used up or the next character does not fit.
+size_t ndef_utf8_to_utf16(ndef_utf8_decoder_t* decoder, const uint8_t** in, size_t* in_len, uint8_t* out,
+                          size_t out_cap) {
+    size_t written = 0;
+
+    // Finish a sequence that was split across calls one character at a time.
+    while (decoder->pending_len) {
+        uint8_t  buf[4];
+        size_t   len = ndef_utf_gather(buf, decoder->pending, decoder->pending_len, *in, *in_len);
+        uint32_t cp;
+        size_t   seq_len = ndef_utf8_decode(buf, len, &cp);
+        if (!seq_len) {
+            ndef_utf_stash(decoder->pending, &decoder->pending_len, in, in_len);
+            return written;
+        }
+        cp            = cp == NDEF_UTF_INVALID ? NDEF_UTF_REPLACEMENT : cp;
+        size_t cp_len = ndef_utf16_put_cp(out + written, out_cap - written, cp, decoder->big_endian);
+        if (!cp_len) {
+            return written;
+        }
+        written += cp_len;
+        ndef_utf_consume(decoder->pending, &decoder->pending_len, in, in_len, seq_len);
+    }
+
+    // Then decode the rest straight from the input.
+    const uint8_t* data = *in;
+    size_t         len  = *in_len;
+    while (len) {
+        uint32_t cp;
+        size_t   seq_len = ndef_utf8_decode(data, len, &cp);
+        if (!seq_len) {
+            *in     = data;
+            *in_len = len;
+            ndef_utf_stash(decoder->pending, &decoder->pending_len, in, in_len);
+            return written;
+        }
+        cp            = cp == NDEF_UTF_INVALID ? NDEF_UTF_REPLACEMENT : cp;
+        size_t cp_len = ndef_utf16_put_cp(out + written, out_cap - written, cp, decoder->big_endian);
+        if (!cp_len) {
+            break;
+        }
+        written += cp_len;
+        data    += seq_len;
+        len     -= seq_len;
+    }
+    *in     = data;
+    *in_len = len;
+    return written;
+}
+
+// Flush a UTF-8 to UTF-16 transcoder at the end of its input, writing U+FFFD for a truncated sequence.
+size_t ndef_utf8_to_utf16_finish(ndef_utf8_decoder_t* decoder, uint8_t* out, size_t out_cap) {
+    if (!decoder->pending_len || out_cap < 2) {
+        return 0;
+    }
+    decoder->pending_len = 0;
+    ndef_utf16_put(out, NDEF_UTF_REPLACEMENT, decoder->big_endian);
+    return 2;
+}
@@ -0,0 +1,166 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+#include "ndef/wifi.h"
+
+// Wi-Fi Simple Configuration attribute IDs.
+#define WSC_ATTR_AUTH_TYPE     0x1003
+#define WSC_ATTR_CREDENTIAL    0x100E
+#define WSC_ATTR_ENCR_TYPE     0x100F
+#define WSC_ATTR_MAC_ADDRESS   0x1020
+#define WSC_ATTR_NETWORK_INDEX 0x1026
+#define WSC_ATTR_NETWORK_KEY   0x1027
+#define WSC_ATTR_SSID          0x1045
+#define WSC_ATTR_VENDOR_EXT    0x1049
+#define WSC_ATTR_VERSION       0x104A
+
+// Wi-Fi Alliance vendor extension carrying the Version2 subelement.
+static const uint8_t wsc_version2[] = {0x00, 0x37, 0x2A, 0x00, 0x01, 0x20};
+// MAC address used when the credential applies to any access point.
+static const uint8_t wsc_any_mac[]  = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+
+// A Wi-Fi Simple Configuration attribute.
+typedef struct {
+    uint16_t       id;
+    uint16_t       len;
+    const uint8_t* data;
+} wsc_attr_t;
+
+// Read the next attribute; the data refers to the blob passed.
+static bool wsc_attr_next(ndef_istream_t* istream, wsc_attr_t* attr_out) {
+    NDEF_RETURN_ON_FALSE(ndef_istream_available(istream) >= 4);
+    const uint8_t* header = istream->data + istream->index;
+    attr_out->id          = header[0] << 8 | header[1];
+    attr_out->len         = header[2] << 8 | header[3];
+    NDEF_RETURN_ON_FALSE(ndef_istream_available(istream) - 4 >= attr_out->len);
+    attr_out->data  = header + 4;
+    istream->index += 4 + attr_out->len;
+    return true;
+}
+
+// Get a 16-bit attribute value.
+static inline bool wsc_attr_u16(const wsc_attr_t* attr, uint16_t* value_out) {
+    NDEF_RETURN_ON_FALSE(attr->len == 2);
+    *value_out = attr->data[0] << 8 | attr->data[1];
+    return true;
+}
+
+// Decode the attributes of a credential.
+static bool ndef_wifi_decode_credential(const wsc_attr_t* credential, ndef_wifi_t* wifi_out) {
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(credential->data, credential->len);
+    bool           has_ssid = false;
+    while (ndef_istream_available(&istream)) {
+        wsc_attr_t attr;
+        NDEF_RETURN_ON_FALSE(wsc_attr_next(&istream, &attr));
+        switch (attr.id) {
+            case WSC_ATTR_SSID:
+                has_ssid           = true;
+                wifi_out->ssid     = (const char*)attr.data;
+                wifi_out->ssid_len = attr.len;
+                break;
+            case WSC_ATTR_AUTH_TYPE:
+                NDEF_RETURN_ON_FALSE(wsc_attr_u16(&attr, &wifi_out->auth));
+                break;
+            case WSC_ATTR_ENCR_TYPE:
+                NDEF_RETURN_ON_FALSE(wsc_attr_u16(&attr, &wifi_out->encr));
+                break;
+            case WSC_ATTR_NETWORK_KEY:
+                wifi_out->key     = (const char*)attr.data;
+                wifi_out->key_len = attr.len;
+                break;
+            case WSC_ATTR_MAC_ADDRESS:
+                NDEF_RETURN_ON_FALSE(attr.len == 6);
+                wifi_out->mac = memcmp(attr.data, wsc_any_mac, 6) ? attr.data : NULL;
+                break;
+            default:
+                break;
+        }
+    }
+    return has_ssid;
+}
+
+// Decode the payload of an NDEF Wi-Fi record that has already been read.
+bool ndef_wifi_decode(const ndef_record_t* record, ndef_wifi_t* wifi_out) {
+    NDEF_STATS_FN(WIFI_DECODE);
+    NDEF_RETURN_ON_FALSE(
+        ndef_record_is_type(record, NDEF_TNF_MIME_MEDIA, NDEF_WIFI_MIME_TYPE, sizeof(NDEF_WIFI_MIME_TYPE) - 1));
+    *wifi_out = (ndef_wifi_t){
+        .pos  = record->pos,
+        .auth = NDEF_WIFI_AUTH_OPEN,
+        .encr = NDEF_WIFI_ENCR_NONE,
+    };
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(record->payload, record->payload_len);
+    while (ndef_istream_available(&istream)) {
+        wsc_attr_t attr;
+        NDEF_RETURN_ON_FALSE(wsc_attr_next(&istream, &attr), NDEF_STATS_FAIL(PAYLOAD););
+        if (attr.id == WSC_ATTR_CREDENTIAL) {
+            NDEF_RETURN_ON_FALSE(ndef_wifi_decode_credential(&attr, wifi_out), NDEF_STATS_FAIL(PAYLOAD););
+            return true;
+        }
+    }
+    NDEF_STATS_FAIL(PAYLOAD);
+    return false;
+}
+
+// Read an NDEF Wi-Fi record.
+// Returns how long the record was read, or 0 on error.
+size_t ndef_wifi_read(ndef_istream_t* istream, ndef_wifi_t* wifi_out) {
+    ndef_record_t record;
+    size_t        record_len = NDEF_RETURN_ON_FALSE(ndef_read_record(istream, &record));
+    NDEF_RETURN_ON_FALSE(ndef_wifi_decode(&record, wifi_out),
+                         ndef_istream_reject(istream, record_len,
+                                             ndef_record_is_type(&record, NDEF_TNF_MIME_MEDIA, NDEF_WIFI_MIME_TYPE,
+                                                                 sizeof(NDEF_WIFI_MIME_TYPE) - 1)););
+    return record_len;
+}
+
+// Get the payload size of the credential attribute.
+static inline size_t ndef_wifi_credential_size(const ndef_wifi_t* wifi) {
+    // Network index, SSID, authentication type, encryption type, network key and MAC address.
+    return 5 + 4 + wifi->ssid_len + 6 + 6 + 4 + wifi->key_len + 10;
+}
+
+// Get the payload size of an NDEF Wi-Fi record.
+size_t ndef_wifi_payload_size(ndef_wifi_t wifi) {
+    // Version, credential and the Version2 vendor extension.
+    return 5 + 4 + ndef_wifi_credential_size(&wifi) + 4 + sizeof(wsc_version2);
+}
+
+// Write an attribute header.
+static inline bool wsc_attr_write_header(ndef_ostream_t* data_out, uint16_t id, size_t len) {
+    uint8_t header[4] = {id >> 8, id, len >> 8, len};
+    return ndef_ostream_extend(data_out, header, sizeof(header));
+}
+
+// Write an attribute.
+static inline bool wsc_attr_write(ndef_ostream_t* data_out, uint16_t id, const void* data, size_t len) {
+    NDEF_RETURN_ON_FALSE(wsc_attr_write_header(data_out, id, len));
+    return ndef_ostream_extend(data_out, data, len);
+}
+
+// Write a 16-bit attribute.
+static inline bool wsc_attr_write_u16(ndef_ostream_t* data_out, uint16_t id, uint16_t value) {
+    uint8_t data[2] = {value >> 8, value};
+    return wsc_attr_write(data_out, id, data, sizeof(data));
+}
+
+// Write an NDEF Wi-Fi record with a single credential.
+bool ndef_wifi_write(ndef_ostream_t* data_out, ndef_wifi_t wifi, ndef_pos_t pos) {
+    NDEF_STATS_FN(WIFI_WRITE);
+    NDEF_RETURN_ON_FALSE(wifi.ssid_len <= 32 && wifi.key_len <= 64, ndef_ostream_fail(data_out, NDEF_ERR_INVALID_ARG););
+    uint8_t version = 0x10;
+    uint8_t index   = 1;
+    NDEF_RETURN_ON_FALSE(ndef_write_record(data_out, NDEF_TNF_MIME_MEDIA, NDEF_WIFI_MIME_TYPE, pos,
+                                           ndef_wifi_payload_size(wifi)));
+    NDEF_RETURN_ON_FALSE(wsc_attr_write(data_out, WSC_ATTR_VERSION, &version, 1));
+    NDEF_RETURN_ON_FALSE(wsc_attr_write_header(data_out, WSC_ATTR_CREDENTIAL, ndef_wifi_credential_size(&wifi)));
+    NDEF_RETURN_ON_FALSE(wsc_attr_write(data_out, WSC_ATTR_NETWORK_INDEX, &index, 1));
+    NDEF_RETURN_ON_FALSE(wsc_attr_write(data_out, WSC_ATTR_SSID, wifi.ssid, wifi.ssid_len));
+    NDEF_RETURN_ON_FALSE(wsc_attr_write_u16(data_out, WSC_ATTR_AUTH_TYPE, wifi.auth));
+    NDEF_RETURN_ON_FALSE(wsc_attr_write_u16(data_out, WSC_ATTR_ENCR_TYPE, wifi.encr));
+    NDEF_RETURN_ON_FALSE(wsc_attr_write(data_out, WSC_ATTR_NETWORK_KEY, wifi.key, wifi.key_len));
+    NDEF_RETURN_ON_FALSE(wsc_attr_write(data_out, WSC_ATTR_MAC_ADDRESS, wifi.mac ? wifi.mac : wsc_any_mac, 6));
+    NDEF_RETURN_ON_FALSE(wsc_attr_write(data_out, WSC_ATTR_VENDOR_EXT, wsc_version2, sizeof(wsc_version2)));
+    return true;
+}
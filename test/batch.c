@@ -0,0 +1,119 @@
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Tests of writing a batch of NDEF messages, which must match writing the messages one by one.
+
+#include <string.h>
+#include "ndef.h"
+#include "test.h"
+
+// Length of the URI of the long record.
+#define TEST_LONG_LEN 300
+// Number of messages in the batch.
+#define TEST_MESSAGES 3
+
+// Bytes written to the stream before the batch.
+static const uint8_t test_prefix[] = {'x', 'y', 'z'};
+
+// The first message of the batch: a URI record and a text record.
+static const uint8_t test_batch_vector[] = {
+    NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_WELL_KNOWN, 1, 12, 'U', NDEF_URI_PREFIX_HTTPS,
+    'e', 'x', 'a', 'm', 'p', 'l', 'e', '.', 'c', 'o', 'm',
+    NDEF_FLAG_MESSAGE_END | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_WELL_KNOWN, 1, 5, 'T', 2, 'e', 'n', 'h', 'i',
+};
+
+static char                     test_long_uri[TEST_LONG_LEN];
+static const ndef_decd_record_t test_records[] = {
+    // The first message.
+    {.type = NDEF_DECD_TYPE_URI, .data.uri = {.prefix = NDEF_URI_PREFIX_HTTPS, .uri = "example.com", .uri_len = 11}},
+    {.type = NDEF_DECD_TYPE_TEXT, .data.text = {.lang = "en", .lang_len = 2, .text = "hi", .text_len = 2}},
+    // The second message: a URI record with a long header.
+    {.type = NDEF_DECD_TYPE_URI, .data.uri = {.uri = test_long_uri, .uri_len = TEST_LONG_LEN}},
+    // The third message: records that are not copied straight into the output.
+    {.type      = NDEF_DECD_TYPE_TEXT,
+     .data.text = {.encoding = NDEF_TEXT_UTF16, .lang = "en", .lang_len = 2, .text = "h\0i\0", .text_len = 4}},
+    {.type = NDEF_DECD_TYPE_MIME, .data.mime = {.type = "a/b", .type_len = 3, .payload = (const uint8_t*)"c"}},
+    {.type = NDEF_DECD_TYPE_URI, .data.uri = {.uri = "", .uri_len = 0}},
+};
+
+static const ndef_batch_message_t test_messages[TEST_MESSAGES] = {
+    {test_records, 2},
+    {test_records + 2, 1},
+    {test_records + 3, 3},
+};
+
+// The batch matches its messages written one by one, after what was in the stream before.
+static void test_matches_messages(void) {
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    TEST_CHECK(ndef_ostream_extend(&ostream, test_prefix, sizeof(test_prefix)));
+    ndef_batch_entry_t entries[TEST_MESSAGES];
+    TEST_CHECK(ndef_batch_write(&ostream, test_messages, TEST_MESSAGES, entries));
+    TEST_CHECK(ostream.len == sizeof(test_prefix) + ndef_batch_encoded_size(test_messages, TEST_MESSAGES));
+    TEST_CHECK(memcmp(ostream.data, test_prefix, sizeof(test_prefix)) == 0);
+
+    TEST_CHECK(entries[0].offset == sizeof(test_prefix) && entries[0].len == sizeof(test_batch_vector));
+    TEST_CHECK(memcmp(ostream.data + entries[0].offset, test_batch_vector, sizeof(test_batch_vector)) == 0);
+
+    size_t offset = sizeof(test_prefix);
+    for (size_t i = 0; i < TEST_MESSAGES; i++) {
+        ndef_ostream_t message = NDEF_OSTREAM_NEW();
+        TEST_CHECK(ndef_message_write(&message, test_messages[i].records, test_messages[i].records_len));
+        TEST_CHECK(entries[i].offset == offset && entries[i].len == message.len);
+        TEST_CHECK(memcmp(ostream.data + offset, message.data, message.len) == 0);
+        offset += message.len;
+        ndef_ostream_free(&message);
+    }
+    TEST_CHECK(offset == ostream.len);
+
+    // The long record has a 4-byte length.
+    uint8_t long_flags = NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_MESSAGE_END | NDEF_TNF_WELL_KNOWN;
+    TEST_CHECK(ostream.data[entries[1].offset] == long_flags);
+    TEST_CHECK(entries[1].len == 7 + 1 + TEST_LONG_LEN);
+    ndef_ostream_free(&ostream);
+}
+
+// A failed batch leaves the stream as it was.
+static void test_failure(void) {
+    ndef_batch_entry_t entries[TEST_MESSAGES + 1];
+
+    // An empty message.
+    ndef_batch_message_t messages[TEST_MESSAGES + 1];
+    memcpy(messages, test_messages, sizeof(test_messages));
+    messages[TEST_MESSAGES] = (ndef_batch_message_t){test_records, 0};
+    ndef_ostream_t ostream  = NDEF_OSTREAM_NEW();
+    TEST_CHECK(ndef_ostream_extend(&ostream, test_prefix, sizeof(test_prefix)));
+    TEST_CHECK(!ndef_batch_encoded_size(messages, TEST_MESSAGES + 1));
+    TEST_CHECK(!ndef_batch_write(&ostream, messages, TEST_MESSAGES + 1, entries));
+    TEST_CHECK(ostream.len == sizeof(test_prefix) && ostream.result.err == NDEF_ERR_INVALID_ARG);
+
+    // Invalid UTF-8 in the last record, found only once the rest of the batch has been written.
+    ndef_decd_record_t bad = {
+        .type      = NDEF_DECD_TYPE_TEXT,
+        .data.text = {.lang = "en", .lang_len = 2, .text = "\xc3", .text_len = 1},
+    };
+    messages[TEST_MESSAGES] = (ndef_batch_message_t){&bad, 1};
+    ostream.result          = (ndef_result_t){NDEF_OK, 0};
+    TEST_CHECK(!ndef_batch_write(&ostream, messages, TEST_MESSAGES + 1, entries));
+    TEST_CHECK(ostream.len == sizeof(test_prefix) && ostream.result.err == NDEF_ERR_INVALID_ARG);
+    TEST_CHECK(memcmp(ostream.data, test_prefix, sizeof(test_prefix)) == 0);
+    ndef_ostream_free(&ostream);
+
+    // A fixed buffer one byte too small.
+    size_t  size = ndef_batch_encoded_size(test_messages, TEST_MESSAGES);
+    uint8_t buf[512];
+    TEST_CHECK(size < sizeof(buf));
+    ostream = NDEF_OSTREAM_NEW_FIXED(buf, size - 1);
+    TEST_CHECK(!ndef_batch_write(&ostream, test_messages, TEST_MESSAGES, entries));
+    TEST_CHECK(ostream.len == 0 && ostream.result.err == NDEF_ERR_NO_SPACE);
+    ostream = NDEF_OSTREAM_NEW_FIXED(buf, size);
+    TEST_CHECK(ndef_batch_write(&ostream, test_messages, TEST_MESSAGES, entries) && ostream.len == size);
+}
+
+int main(void) {
+    for (size_t i = 0; i < TEST_LONG_LEN; i++) {
+        test_long_uri[i] = 'a' + i % 26;
+    }
+    test_matches_messages();
+    test_failure();
+    return 0;
+}
@@ -0,0 +1,152 @@
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Tests of writing records in chunks and reading them back.
+
+#include <string.h>
+#include "test.h"
+
+// Longest payload written by the round-trip tests.
+#define TEST_MAX_PAYLOAD 600
+
+// A MIME record of type "a/b" with ID "x" and the payload "abcde", split into chunks of 2 bytes.
+static const uint8_t test_chunked_vector[] = {
+    NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_CHUNKED_RECORD | NDEF_FLAG_SHORT_RECORD | NDEF_FLAG_ID_LENGTH |
+        NDEF_TNF_MIME_MEDIA,
+    3, 2, 1, 'a', '/', 'b', 'x', 'a', 'b',
+    NDEF_FLAG_CHUNKED_RECORD | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_UNCHANGED, 0, 2, 'c', 'd',
+    NDEF_FLAG_MESSAGE_END | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_UNCHANGED, 0, 1, 'e',
+};
+
+// Make the record described by `test_chunked_vector` with a payload of `payload_len` bytes from `payload`.
+static ndef_record_t test_record(const uint8_t* payload, size_t payload_len) {
+    return (ndef_record_t){
+        .pos         = NDEF_POS_START_END,
+        .tnf         = NDEF_TNF_MIME_MEDIA,
+        .type_len    = 3,
+        .type        = "a/b",
+        .id_len      = 1,
+        .id          = "x",
+        .payload_len = payload_len,
+        .payload     = payload,
+    };
+}
+
+// The chunks of a known record, written and read back.
+static void test_vector(void) {
+    ndef_record_t  record  = test_record((const uint8_t*)"abcde", 5);
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    TEST_CHECK(ndef_write_chunked(&ostream, &record, 2));
+    TEST_CHECK(ostream.len == sizeof(test_chunked_vector));
+    TEST_CHECK(memcmp(ostream.data, test_chunked_vector, sizeof(test_chunked_vector)) == 0);
+    TEST_CHECK(ndef_chunked_encoded_size(3, 1, 5, 2) == sizeof(test_chunked_vector));
+    ndef_ostream_free(&ostream);
+
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(test_chunked_vector, sizeof(test_chunked_vector));
+    ndef_slice_t   slices[3];
+    size_t         slices_len;
+    TEST_CHECK(ndef_read_chunked(&istream, &record, slices, 3, &slices_len) == sizeof(test_chunked_vector));
+    TEST_CHECK(slices_len == 3 && record.payload_len == 5 && !record.payload && record.pos == NDEF_POS_START_END);
+    TEST_CHECK(record.type_len == 3 && memcmp(record.type, "a/b", 3) == 0);
+    TEST_CHECK(record.id_len == 1 && record.id[0] == 'x');
+    TEST_CHECK(slices[0].len == 2 && memcmp(slices[0].data, "ab", 2) == 0);
+    TEST_CHECK(slices[1].len == 2 && memcmp(slices[1].data, "cd", 2) == 0);
+    TEST_CHECK(slices[2].len == 1 && slices[2].data[0] == 'e');
+}
+
+// Payloads of many lengths in chunks of every size up to past the payload, including sizes that need long headers.
+static void test_round_trip(void) {
+    static uint8_t payload[TEST_MAX_PAYLOAD];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = i * 13 + 1;
+    }
+    static const size_t lens[] = {0, 1, 2, 3, 7, 16, 255, 256, 257, 511, TEST_MAX_PAYLOAD};
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+        size_t len = lens[l];
+        for (size_t chunk_size = 1; chunk_size <= len + 1; chunk_size++) {
+            ndef_record_t  record  = test_record(payload, len);
+            ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+            TEST_CHECK(ndef_write_chunked(&ostream, &record, chunk_size));
+            TEST_CHECK(ostream.len == ndef_chunked_encoded_size(3, 1, len, chunk_size));
+
+            size_t         chunks = len > chunk_size ? (len + chunk_size - 1) / chunk_size : 1;
+            size_t         slices_len;
+            ndef_istream_t istream = NDEF_ISTREAM_NEW(ostream.data, ostream.len);
+            TEST_CHECK(ndef_read_chunked(&istream, &record, NULL, 0, &slices_len) == ostream.len);
+            TEST_CHECK(slices_len == chunks && record.payload_len == len && record.pos == NDEF_POS_START_END);
+
+            ndef_ostream_t reassembled = NDEF_OSTREAM_NEW();
+            istream                    = NDEF_ISTREAM_NEW(ostream.data, ostream.len);
+            TEST_CHECK(ndef_read_chunked_into(&istream, &record, &reassembled) == ostream.len);
+            TEST_CHECK(record.payload_len == len && reassembled.len == len);
+            TEST_CHECK(len == 0 || memcmp(record.payload, payload, len) == 0);
+            TEST_CHECK(record.type_len == 3 && memcmp(record.type, "a/b", 3) == 0 && record.id_len == 1);
+
+            // The chunks are records of their own to a reader that does not join them.
+            istream = NDEF_ISTREAM_NEW(ostream.data, ostream.len);
+            for (size_t i = 0; i < chunks; i++) {
+                TEST_CHECK(ndef_read_record(&istream, &record));
+                TEST_CHECK(record.chunked == (i + 1 < chunks));
+                TEST_CHECK(record.tnf == (i == 0 ? NDEF_TNF_MIME_MEDIA : NDEF_TNF_UNCHANGED));
+            }
+            TEST_CHECK(istream.index == ostream.len);
+            ndef_ostream_free(&reassembled);
+            ndef_ostream_free(&ostream);
+        }
+    }
+}
+
+// A chunk size of 0 is rejected without writing anything.
+static void test_zero_chunk_size(void) {
+    ndef_record_t  record  = test_record((const uint8_t*)"abcde", 5);
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    TEST_CHECK(ndef_chunked_encoded_size(3, 1, 5, 0) == 0);
+    TEST_CHECK(!ndef_write_chunked(&ostream, &record, 0));
+    TEST_CHECK(ostream.len == 0 && ostream.result.err == NDEF_ERR_INVALID_ARG);
+    ndef_ostream_free(&ostream);
+}
+
+// Chunks out of order are malformed, and a failed read leaves the stream where it was.
+static void test_bad_chunks(void) {
+    uint8_t data[sizeof(test_chunked_vector)];
+
+    // A middle chunk with a type name format other than unchanged.
+    memcpy(data, test_chunked_vector, sizeof(data));
+    data[10] = (data[10] & ~NDEF_FLAG_TYPE_NAME_FORMAT) | NDEF_TNF_MIME_MEDIA;
+    ndef_record_t  record;
+    size_t         slices_len;
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(data, sizeof(data));
+    TEST_CHECK(!ndef_read_chunked(&istream, &record, NULL, 0, &slices_len));
+    TEST_CHECK(istream.index == 0 && istream.result.err == NDEF_ERR_MALFORMED && istream.result.offset == 10);
+
+    // A chunked record that ends the message before its last chunk.
+    memcpy(data, test_chunked_vector, sizeof(data));
+    data[10] |= NDEF_FLAG_MESSAGE_END;
+    istream   = NDEF_ISTREAM_NEW(data, sizeof(data));
+    TEST_CHECK(!ndef_read_chunked(&istream, &record, NULL, 0, &slices_len));
+    TEST_CHECK(istream.index == 0 && istream.result.err == NDEF_ERR_MALFORMED);
+
+    // A message that starts with a continuation chunk.
+    istream = NDEF_ISTREAM_NEW(test_chunked_vector + 10, sizeof(test_chunked_vector) - 10);
+    TEST_CHECK(!ndef_read_chunked(&istream, &record, NULL, 0, &slices_len));
+    TEST_CHECK(istream.index == 0 && istream.result.err == NDEF_ERR_MALFORMED);
+
+    // The last chunk is missing.
+    istream = NDEF_ISTREAM_NEW(test_chunked_vector, sizeof(test_chunked_vector) - 4);
+    TEST_CHECK(!ndef_read_chunked(&istream, &record, NULL, 0, &slices_len));
+    TEST_CHECK(istream.index == 0 && istream.result.err == NDEF_ERR_TRUNCATED);
+
+    // More chunks than slices.
+    ndef_slice_t slices[2];
+    istream = NDEF_ISTREAM_NEW(test_chunked_vector, sizeof(test_chunked_vector));
+    TEST_CHECK(!ndef_read_chunked(&istream, &record, slices, 2, &slices_len));
+    TEST_CHECK(istream.index == 0 && istream.result.err == NDEF_ERR_NO_SPACE);
+}
+
+int main(void) {
+    test_vector();
+    test_round_trip();
+    test_zero_chunk_size();
+    test_bad_chunks();
+    return 0;
+}
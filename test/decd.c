@@ -0,0 +1,77 @@
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Tests of decoding records with application-defined decoders from a registry and with the built-in ones.
+
+#include "ndef.h"
+#include "test.h"
+
+// Decode records of type "example.com:n" with a 2-byte payload, counting calls in the cookie.
+static bool test_decode(const ndef_record_t* record, ndef_decd_record_t* decd_out, void* cookie) {
+    (*(size_t*)cookie)++;
+    TEST_CHECK(decd_out->data.record.payload == record->payload);
+    NDEF_RETURN_ON_FALSE(record->payload_len == 2);
+    decd_out->type = NDEF_DECD_TYPE_APP;
+    return true;
+}
+
+// Application-defined decoders are tried before the built-in ones and report their records as known.
+static void test_decoders(void) {
+    static const uint8_t message[] = {
+        // An external record the decoder accepts.
+        NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_EXTERNAL_TYPE, 13, 2,
+        'e', 'x', 'a', 'm', 'p', 'l', 'e', '.', 'c', 'o', 'm', ':', 'N', 1, 2,
+        // One it rejects, which decodes as a generic external record.
+        NDEF_FLAG_SHORT_RECORD | NDEF_TNF_EXTERNAL_TYPE, 13, 1,
+        'e', 'x', 'a', 'm', 'p', 'l', 'e', '.', 'c', 'o', 'm', ':', 'n', 1,
+        // A well-known type the decoder rejects and no built-in decoder knows.
+        NDEF_FLAG_SHORT_RECORD | NDEF_TNF_WELL_KNOWN, 1, 1, 'Z', 1,
+        // A well-known type that nothing knows.
+        NDEF_FLAG_MESSAGE_END | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_WELL_KNOWN, 1, 1, 'Y', 1,
+    };
+    size_t                calls   = 0;
+    ndef_decd_decoder_t   decoder = {test_decode, &calls};
+    ndef_registry_entry_t entries[4];
+    ndef_registry_t       registry;
+    ndef_registry_init(&registry, entries, 4);
+    TEST_CHECK(ndef_registry_add(&registry, NDEF_TNF_EXTERNAL_TYPE, "example.com:n", 13, &decoder));
+    TEST_CHECK(ndef_registry_add(&registry, NDEF_TNF_WELL_KNOWN, "Z", 1, &decoder));
+
+    ndef_decd_record_t decd;
+    ndef_istream_t     istream = NDEF_ISTREAM_NEW(message, sizeof(message));
+    TEST_CHECK(ndef_decd_read_with(&registry, &istream, &decd) == 18 && calls == 1);
+    TEST_CHECK(decd.type == NDEF_DECD_TYPE_APP && decd.pos == NDEF_POS_START);
+    TEST_CHECK(decd.data.record.payload_len == 2 && decd.data.record.payload == message + 16);
+    TEST_CHECK(ndef_decd_encoded_size(&decd) == 18);
+
+    TEST_CHECK(ndef_decd_read_with(&registry, &istream, &decd) == 17 && calls == 2);
+    TEST_CHECK(decd.type == NDEF_DECD_TYPE_EXTERNAL && decd.data.external.payload_len == 1);
+
+    // A registered type whose decoder fails is a bad payload, an unknown type is the wrong type.
+    size_t index = istream.index;
+    TEST_CHECK(!ndef_decd_read_with(&registry, &istream, &decd) && calls == 3);
+    TEST_CHECK(istream.index == index && istream.result.err == NDEF_ERR_PAYLOAD);
+    TEST_CHECK(decd.type == NDEF_DECD_TYPE_UNKNOWN && decd.data.record.type[0] == 'Z');
+    istream.index += 5;
+    TEST_CHECK(!ndef_decd_read_with(&registry, &istream, &decd) && calls == 3);
+    TEST_CHECK(istream.index == index + 5 && istream.result.err == NDEF_ERR_TYPE);
+
+    // Without a registry only the built-in decoders are used.
+    istream = NDEF_ISTREAM_NEW(message, sizeof(message));
+    TEST_CHECK(ndef_decd_read_with(NULL, &istream, &decd) == 18 && calls == 3);
+    TEST_CHECK(decd.type == NDEF_DECD_TYPE_EXTERNAL && decd.data.external.payload_len == 2);
+
+    // Built-in decoders report their malformed records as bad payloads: a text record with a 3-byte language code in a
+    // 1-byte payload.
+    static const uint8_t bad_text[] = {
+        NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_MESSAGE_END | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_WELL_KNOWN, 1, 1, 'T', 3,
+    };
+    istream = NDEF_ISTREAM_NEW(bad_text, sizeof(bad_text));
+    TEST_CHECK(!ndef_decd_read_with(&registry, &istream, &decd));
+    TEST_CHECK(istream.index == 0 && istream.result.err == NDEF_ERR_PAYLOAD);
+}
+
+int main(void) {
+    test_decoders();
+    return 0;
+}
@@ -0,0 +1,154 @@
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Tests of finding changed ranges, checked against a byte-by-byte reference with blocks aligned in tag memory.
+
+#include <string.h>
+#include "ndef.h"
+#include "test.h"
+
+// Longest data compared by the randomised tests.
+#define TEST_MAX_LEN 48
+
+// State of the pseudo-random generator, so that failures reproduce.
+static uint32_t test_rng = 1;
+
+// Get a pseudo-random number below `limit`.
+static size_t test_random(size_t limit) {
+    test_rng = test_rng * 1103515245u + 12345u;
+    return (test_rng >> 16) % limit;
+}
+
+// Find the ranges the slow way: mark every block of tag memory holding a changed byte, then collect runs of marked
+// bytes of `new_data`.
+static size_t test_reference(const uint8_t* old_data, size_t old_len, const uint8_t* new_data, size_t new_len,
+                             size_t base_offset, size_t block_size, ndef_diff_range_t* ranges_out) {
+    size_t unit                 = block_size > 1 ? block_size : 1;
+    bool   marked[TEST_MAX_LEN] = {0};
+    for (size_t i = 0; i < new_len; i++) {
+        if (i >= old_len || old_data[i] != new_data[i]) {
+            size_t block = (base_offset + i) / unit;
+            for (size_t j = 0; j < new_len; j++) {
+                marked[j] |= (base_offset + j) / unit == block;
+            }
+        }
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < new_len; i++) {
+        if (!marked[i]) {
+            continue;
+        } else if (count && ranges_out[count - 1].offset + ranges_out[count - 1].len == i) {
+            ranges_out[count - 1].len++;
+        } else {
+            ranges_out[count++] = (ndef_diff_range_t){i, 1};
+        }
+    }
+    return count;
+}
+
+// Known cases of a message at offset 18 of a Type 2 tag, after the capability container and the TLV header.
+static void test_known(void) {
+    uint8_t           old_data[12] = {0};
+    uint8_t           new_data[12] = {0};
+    ndef_diff_range_t ranges[4];
+
+    // Byte 3 is at tag address 21, so the page of addresses 20..23 is bytes 2..5, not the 4 bytes from byte 0.
+    new_data[3] = 1;
+    TEST_CHECK(ndef_diff_at(old_data, 12, new_data, 12, 18, 4, ranges, 4) == 1);
+    TEST_CHECK(ranges[0].offset == 2 && ranges[0].len == 4);
+
+    // Byte 0 is in the page of addresses 16..19, which starts before the data.
+    new_data[0] = 1;
+    TEST_CHECK(ndef_diff_at(old_data, 12, new_data, 12, 18, 4, ranges, 4) == 1);
+    TEST_CHECK(ranges[0].offset == 0 && ranges[0].len == 6);
+
+    // Byte 11 is in the page of addresses 28..31, which ends after the data; byte 7 is in another page.
+    memset(new_data, 0, sizeof(new_data));
+    new_data[7]  = 1;
+    new_data[11] = 1;
+    TEST_CHECK(ndef_diff_at(old_data, 12, new_data, 12, 18, 4, ranges, 4) == 1);
+    TEST_CHECK(ranges[0].offset == 6 && ranges[0].len == 6);
+
+    // Counted from the start of the data, the pages are bytes 4..7 and 8..11, which touch and are merged.
+    TEST_CHECK(ndef_diff(old_data, 12, new_data, 12, 4, ranges, 4) == 1);
+    TEST_CHECK(ranges[0].offset == 4 && ranges[0].len == 8);
+    new_data[11] = 0;
+    TEST_CHECK(ndef_diff(old_data, 12, new_data, 12, 4, ranges, 4) == 1);
+    TEST_CHECK(ranges[0].offset == 4 && ranges[0].len == 4);
+    new_data[11] = 1;
+
+    // Bytes past the end of the old data changed.
+    TEST_CHECK(ndef_diff_at(new_data, 8, new_data, 12, 18, 4, ranges, 4) == 1);
+    TEST_CHECK(ranges[0].offset == 6 && ranges[0].len == 6);
+
+    // Nothing changed.
+    TEST_CHECK(ndef_diff_at(new_data, 12, new_data, 12, 18, 4, ranges, 4) == 0);
+    TEST_CHECK(ndef_diff_at(new_data, 12, new_data, 0, 18, 4, ranges, 4) == 0);
+}
+
+// Random changes match the reference for many block sizes and base offsets; with too few ranges, the last range
+// runs to the end of the data.
+static void test_random_changes(void) {
+    static const size_t block_sizes[] = {0, 1, 2, 4, 8, 16};
+    for (size_t iter = 0; iter < 20000; iter++) {
+        uint8_t old_data[TEST_MAX_LEN];
+        uint8_t new_data[TEST_MAX_LEN];
+        size_t  old_len     = test_random(TEST_MAX_LEN + 1);
+        size_t  new_len     = test_random(TEST_MAX_LEN + 1);
+        size_t  base_offset = test_random(40);
+        size_t  block_size  = block_sizes[test_random(sizeof(block_sizes) / sizeof(block_sizes[0]))];
+        size_t  changes     = test_random(6);
+        for (size_t i = 0; i < TEST_MAX_LEN; i++) {
+            old_data[i] = new_data[i] = test_random(256);
+        }
+        for (size_t i = 0; i < changes && new_len; i++) {
+            new_data[test_random(new_len)] ^= 1 + test_random(255);
+        }
+
+        ndef_diff_range_t expected[TEST_MAX_LEN];
+        ndef_diff_range_t ranges[TEST_MAX_LEN];
+
+        size_t expected_len = test_reference(old_data, old_len, new_data, new_len, base_offset, block_size, expected);
+        size_t ranges_len   = ndef_diff_at(old_data, old_len, new_data, new_len, base_offset, block_size, ranges,
+                                           TEST_MAX_LEN);
+        TEST_CHECK(ranges_len == expected_len);
+        TEST_CHECK(memcmp(ranges, expected, ranges_len * sizeof(ndef_diff_range_t)) == 0);
+
+        for (size_t cap = 1; cap < expected_len; cap++) {
+            ranges_len = ndef_diff_at(old_data, old_len, new_data, new_len, base_offset, block_size, ranges, cap);
+            TEST_CHECK(ranges_len == cap);
+            TEST_CHECK(memcmp(ranges, expected, (cap - 1) * sizeof(ndef_diff_range_t)) == 0);
+            TEST_CHECK(ranges[cap - 1].offset == expected[cap - 1].offset);
+            TEST_CHECK(ranges[cap - 1].offset + ranges[cap - 1].len == new_len);
+        }
+    }
+}
+
+// Rewriting a message finds the ranges of the new message with the same alignment.
+static void test_rewrite(void) {
+    ndef_decd_record_t record = {
+        .type     = NDEF_DECD_TYPE_URI,
+        .data.uri = {.prefix = NDEF_URI_PREFIX_HTTPS, .uri = "example.com", .uri_len = 11},
+    };
+    ndef_ostream_t old_message = NDEF_OSTREAM_NEW();
+    TEST_CHECK(ndef_message_write(&old_message, &record, 1));
+
+    // The last three bytes of the URI are at tag addresses 31..33, in the pages of addresses 28..31 and 32..35.
+    record.data.uri.uri       = "example.org";
+    ndef_ostream_t    ostream = NDEF_OSTREAM_NEW();
+    ndef_diff_range_t ranges[2];
+    size_t            ranges_len;
+    TEST_CHECK(ndef_message_rewrite(&ostream, old_message.data, old_message.len, &record, 1, 18, 4, ranges, 2,
+                                    &ranges_len));
+    TEST_CHECK(ostream.len == old_message.len && ranges_len == 1);
+    TEST_CHECK(ranges[0].offset == 10 && ranges[0].len == 6);
+    ndef_ostream_free(&ostream);
+    ndef_ostream_free(&old_message);
+}
+
+int main(void) {
+    test_known();
+    test_random_changes();
+    test_rewrite();
+    return 0;
+}
@@ -0,0 +1,142 @@
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Tests of looking up records in an NDEF message index, including lookups that miss.
+
+#include <string.h>
+#include "ndef/index.h"
+#include "test.h"
+
+// Number of records in the test message, counting a chunked record once.
+#define TEST_RECORDS 6
+// Number of records in the test message with an ID.
+#define TEST_IDS     4
+
+// A record of the test message, with an empty ID if `id` is empty.
+typedef struct {
+    ndef_tnf_t  tnf;
+    const char* type;
+    const char* id;
+    const char* payload;
+} test_record_t;
+
+// Build the test message; the record at index 4 is split into three chunks.
+static void test_message(ndef_ostream_t* ostream) {
+    static const test_record_t records[TEST_RECORDS] = {
+        {NDEF_TNF_WELL_KNOWN, "U", "a", "0"},
+        {NDEF_TNF_MIME_MEDIA, "text/plain", "b", "1"},
+        {NDEF_TNF_WELL_KNOWN, "U", "", "2"},
+        {NDEF_TNF_MIME_MEDIA, "TEXT/Plain", "", "3"},
+        {NDEF_TNF_MIME_MEDIA, "a/b", "c", "abcde"},
+        {NDEF_TNF_WELL_KNOWN, "u", "bb", "5"},
+    };
+    for (size_t i = 0; i < TEST_RECORDS; i++) {
+        ndef_record_t record = {
+            .pos         = ndef_pos_at(i, TEST_RECORDS),
+            .tnf         = records[i].tnf,
+            .type_len    = strlen(records[i].type),
+            .type        = records[i].type,
+            .id_len      = strlen(records[i].id),
+            .id          = records[i].id,
+            .payload_len = strlen(records[i].payload),
+            .payload     = (const uint8_t*)records[i].payload,
+        };
+        TEST_CHECK(i == 4 ? ndef_write_chunked(ostream, &record, 2) : ndef_write_raw(ostream, &record));
+    }
+}
+
+// Records are found by ID, misses return 0.
+static void test_find_id(ndef_index_t* index) {
+    ndef_record_t record;
+    TEST_CHECK(ndef_index_find_id(index, "a", 1, &record));
+    TEST_CHECK(record.payload_len == 1 && record.payload[0] == '0' && record.pos == NDEF_POS_START);
+    TEST_CHECK(ndef_index_find_id(index, "b", 1, &record));
+    TEST_CHECK(record.payload_len == 1 && record.payload[0] == '1');
+    TEST_CHECK(ndef_index_find_id(index, "bb", 2, &record));
+    TEST_CHECK(record.payload_len == 1 && record.payload[0] == '5' && record.pos == NDEF_POS_END);
+
+    // A chunked record is found by its first chunk.
+    TEST_CHECK(ndef_index_find_id(index, "c", 1, &record));
+    TEST_CHECK(record.chunked && record.payload_len == 2 && memcmp(record.payload, "ab", 2) == 0);
+
+    // IDs compare exactly.
+    TEST_CHECK(!ndef_index_find_id(index, "B", 1, &record));
+    TEST_CHECK(!ndef_index_find_id(index, "d", 1, &record));
+    TEST_CHECK(!ndef_index_find_id(index, "", 0, &record));
+    TEST_CHECK(!ndef_index_find_id(index, "b", 0, &record));
+    TEST_CHECK(!ndef_index_find_id(index, "bbb", 3, &record));
+}
+
+// Records are found by type in message order, misses return 0.
+static void test_find_type(ndef_index_t* index) {
+    ndef_record_t record;
+    TEST_CHECK(ndef_index_find_type(index, NDEF_TNF_WELL_KNOWN, "U", 1, 0, &record));
+    TEST_CHECK(record.payload[0] == '0');
+    TEST_CHECK(ndef_index_find_type(index, NDEF_TNF_WELL_KNOWN, "U", 1, 1, &record));
+    TEST_CHECK(record.payload[0] == '2');
+    TEST_CHECK(!ndef_index_find_type(index, NDEF_TNF_WELL_KNOWN, "U", 1, 2, &record));
+
+    // Well-known types are case-sensitive.
+    TEST_CHECK(ndef_index_find_type(index, NDEF_TNF_WELL_KNOWN, "u", 1, 0, &record));
+    TEST_CHECK(record.payload[0] == '5');
+    TEST_CHECK(!ndef_index_find_type(index, NDEF_TNF_WELL_KNOWN, "u", 1, 1, &record));
+
+    // MIME types are not.
+    TEST_CHECK(ndef_index_find_type(index, NDEF_TNF_MIME_MEDIA, "Text/PLAIN", 10, 0, &record));
+    TEST_CHECK(record.payload[0] == '1');
+    TEST_CHECK(ndef_index_find_type(index, NDEF_TNF_MIME_MEDIA, "text/plain", 10, 1, &record));
+    TEST_CHECK(record.payload[0] == '3');
+    TEST_CHECK(!ndef_index_find_type(index, NDEF_TNF_MIME_MEDIA, "text/plain", 10, 2, &record));
+
+    // Continuation chunks are not records of their own.
+    TEST_CHECK(ndef_index_find_type(index, NDEF_TNF_MIME_MEDIA, "a/b", 3, 0, &record));
+    TEST_CHECK(record.chunked && record.id_len == 1 && record.id[0] == 'c');
+    TEST_CHECK(!ndef_index_find_type(index, NDEF_TNF_MIME_MEDIA, "a/b", 3, 1, &record));
+    TEST_CHECK(!ndef_index_find_type(index, NDEF_TNF_UNCHANGED, "", 0, 0, &record));
+
+    // Misses on type name format, type and type length.
+    TEST_CHECK(!ndef_index_find_type(index, NDEF_TNF_EXTERNAL_TYPE, "U", 1, 0, &record));
+    TEST_CHECK(!ndef_index_find_type(index, NDEF_TNF_WELL_KNOWN, "T", 1, 0, &record));
+    TEST_CHECK(!ndef_index_find_type(index, NDEF_TNF_WELL_KNOWN, "Ux", 2, 0, &record));
+    TEST_CHECK(!ndef_index_find_type(index, NDEF_TNF_MIME_MEDIA, "text/plai", 9, 0, &record));
+}
+
+// An index needs one entry per record and one per ID.
+static void test_entries_cap(const ndef_ostream_t* ostream) {
+    ndef_index_entry_t entries[TEST_RECORDS + TEST_IDS];
+    ndef_index_t       index;
+    TEST_CHECK(ndef_index_build(&index, ostream->data, ostream->len, entries, TEST_RECORDS + TEST_IDS));
+    TEST_CHECK(index.by_type_len == TEST_RECORDS && index.by_id_len == TEST_IDS);
+    TEST_CHECK(!ndef_index_build(&index, ostream->data, ostream->len, entries, TEST_RECORDS + TEST_IDS - 1));
+    TEST_CHECK(!ndef_index_build(&index, ostream->data, ostream->len - 1, entries, TEST_RECORDS + TEST_IDS));
+}
+
+// A message with only an empty record finds nothing, and no message at all is malformed.
+static void test_empty(void) {
+    static const uint8_t data[] = {NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_MESSAGE_END | NDEF_FLAG_SHORT_RECORD, 0, 0};
+    ndef_index_entry_t   entries[2];
+    ndef_index_t         index;
+    ndef_record_t        record;
+    TEST_CHECK(ndef_index_build(&index, data, sizeof(data), entries, 2));
+    TEST_CHECK(index.by_type_len == 1 && index.by_id_len == 0);
+    TEST_CHECK(!ndef_index_find_id(&index, "", 0, &record));
+    TEST_CHECK(!ndef_index_find_type(&index, NDEF_TNF_WELL_KNOWN, "U", 1, 0, &record));
+    TEST_CHECK(ndef_index_find_type(&index, NDEF_TNF_EMPTY, "", 0, 0, &record) == sizeof(data));
+    TEST_CHECK(!ndef_index_build(&index, data, 0, entries, 2));
+}
+
+int main(void) {
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    test_message(&ostream);
+
+    ndef_index_entry_t entries[2 * TEST_RECORDS];
+    ndef_index_t       index;
+    TEST_CHECK(ndef_index_build(&index, ostream.data, ostream.len, entries, 2 * TEST_RECORDS));
+    test_find_id(&index);
+    test_find_type(&index);
+    test_entries_cap(&ostream);
+    test_empty();
+
+    ndef_ostream_free(&ostream);
+    return 0;
+}
@@ -0,0 +1,251 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Tests of the incremental parser, fed the same message split in every way.
+
+#include <string.h>
+#include "test.h"
+
+// Length of the payload of the long record in `test_message`.
+#define TEST_LONG_LEN 300
+// Number of records in `test_message`.
+#define TEST_RECORDS  4
+
+// Header of the long record: a MIME record of type "a/b" with ID "x" and a 300-byte payload.
+static const uint8_t test_long_header[] = {
+    NDEF_FLAG_ID_LENGTH | NDEF_TNF_MIME_MEDIA, 3, 0, 0, 1, 0x2c, 1, 'a', '/', 'b', 'x',
+};
+
+// Records after the long one: an external record with its 2-byte payload in a 4-byte length field and an empty ID
+// length, and an empty record that ends the message.
+static const uint8_t test_tail[] = {
+    NDEF_FLAG_ID_LENGTH | NDEF_TNF_EXTERNAL_TYPE, 5, 0, 0, 0, 2, 0, 'e', 'x', ':', 't', 'y', 'h', 'i',
+    NDEF_FLAG_MESSAGE_END | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_EMPTY, 0, 0,
+};
+
+// Bytes after the end of the message, which the parser must not consume.
+static const uint8_t test_trailer[] = {0xfe, 0x00};
+
+// A record as reported by the parser, copied out of the callback.
+typedef struct {
+    ndef_record_t record;
+    uint8_t       type[8];
+    uint8_t       id[8];
+    uint8_t       payload[TEST_LONG_LEN];
+    bool          has_payload;
+} test_seen_t;
+
+// What the callbacks have seen.
+typedef struct {
+    test_seen_t seen[TEST_RECORDS];
+    size_t      count;
+    // Whether `test_on_header` skips payloads.
+    bool        skip;
+    // Number of `test_on_header` calls.
+    size_t      headers;
+} test_state_t;
+
+// Build the test message: a URI record with an ID, the long record and `test_tail`, followed by `test_trailer`.
+static size_t test_message(uint8_t* out) {
+    static const uint8_t uri[] = {
+        NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_SHORT_RECORD | NDEF_FLAG_ID_LENGTH | NDEF_TNF_WELL_KNOWN,
+        1, 2, 2, 'U', 'i', 'd', 0x04, 'a',
+    };
+    size_t len = 0;
+    memcpy(out + len, uri, sizeof(uri));
+    len += sizeof(uri);
+    memcpy(out + len, test_long_header, sizeof(test_long_header));
+    len += sizeof(test_long_header);
+    for (size_t i = 0; i < TEST_LONG_LEN; i++) {
+        out[len++] = i * 7;
+    }
+    memcpy(out + len, test_tail, sizeof(test_tail));
+    len += sizeof(test_tail);
+    memcpy(out + len, test_trailer, sizeof(test_trailer));
+    return len;
+}
+
+static bool test_on_header(void* cookie, const ndef_record_t* record) {
+    test_state_t* state = cookie;
+    TEST_CHECK(!record->payload);
+    state->headers++;
+    return !state->skip;
+}
+
+static bool test_on_record(void* cookie, const ndef_record_t* record) {
+    test_state_t* state = cookie;
+    TEST_CHECK(state->count < TEST_RECORDS);
+    test_seen_t* seen = &state->seen[state->count++];
+    TEST_CHECK(record->type_len <= sizeof(seen->type) && record->id_len <= sizeof(seen->id));
+    TEST_CHECK(record->payload_len <= sizeof(seen->payload));
+    seen->record      = *record;
+    seen->has_payload = record->payload != NULL;
+    if (record->type_len) {
+        memcpy(seen->type, record->type, record->type_len);
+    }
+    if (record->id_len) {
+        memcpy(seen->id, record->id, record->id_len);
+    }
+    if (record->payload && record->payload_len) {
+        memcpy(seen->payload, record->payload, record->payload_len);
+    }
+    return true;
+}
+
+// Check the records seen against the records read from the whole message.
+static void test_check_seen(const test_state_t* state, const uint8_t* message, size_t len) {
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(message, len);
+    TEST_CHECK(state->count == TEST_RECORDS);
+    for (size_t i = 0; i < TEST_RECORDS; i++) {
+        const test_seen_t* seen = &state->seen[i];
+        ndef_record_t      want;
+        TEST_CHECK(ndef_read_record(&istream, &want));
+        TEST_CHECK(seen->record.pos == want.pos && seen->record.tnf == want.tnf);
+        TEST_CHECK(seen->record.type_len == want.type_len && memcmp(seen->type, want.type, want.type_len) == 0);
+        TEST_CHECK(seen->record.id_len == want.id_len && memcmp(seen->id, want.id, want.id_len) == 0);
+        TEST_CHECK(seen->record.long_payload_len == want.long_payload_len);
+        TEST_CHECK(seen->record.empty_id_len == want.empty_id_len);
+        TEST_CHECK(seen->record.payload_len == want.payload_len);
+        if (!state->skip) {
+            TEST_CHECK(seen->has_payload && memcmp(seen->payload, want.payload, want.payload_len) == 0);
+        } else {
+            TEST_CHECK(!seen->has_payload);
+        }
+    }
+}
+
+// Feed `len` bytes of `data` to a parser in chunks of `chunk` bytes, starting with a chunk of `first` bytes.
+// Returns false as soon as a feed fails.
+static bool test_feed(ndef_parser_t* parser, const uint8_t* data, size_t len, size_t first, size_t chunk) {
+    size_t i = 0;
+    while (i < len) {
+        size_t n = i == 0 && first ? first : chunk;
+        n        = len - i < n ? len - i : n;
+        if (!ndef_parser_feed(parser, data + i, n)) {
+            return false;
+        }
+        i += n;
+    }
+    return true;
+}
+
+// The message fed in chunks of every size from one byte to all of it, keeping or skipping payloads.
+static void test_chunk_sizes(void) {
+    uint8_t message[512];
+    size_t  len   = test_message(message);
+    size_t  total = len + sizeof(test_trailer);
+    for (int skip = 0; skip < 2; skip++) {
+        for (size_t chunk = 1; chunk <= total; chunk++) {
+            test_state_t  state = {.skip = skip};
+            ndef_parser_t parser;
+            ndef_parser_init(&parser, NDEF_OSTREAM_NEW(), SIZE_MAX, test_on_header, test_on_record, &state);
+            TEST_CHECK(test_feed(&parser, message, total, 0, chunk));
+            TEST_CHECK(ndef_parser_done(&parser) && parser.offset == len && ndef_parser_needed(&parser) == 0);
+            TEST_CHECK(state.headers == TEST_RECORDS);
+            test_check_seen(&state, message, len);
+            // Skipped payloads are never buffered.
+            TEST_CHECK(!skip || parser.buffer.cap < TEST_LONG_LEN);
+            ndef_parser_free(&parser);
+        }
+    }
+}
+
+// The message split in two at every byte, into a fixed buffer that only fits the long record.
+static void test_split_points(void) {
+    uint8_t message[512];
+    uint8_t buf[sizeof(test_long_header) + TEST_LONG_LEN];
+    size_t  len = test_message(message);
+    for (size_t split = 1; split < len; split++) {
+        test_state_t  state = {0};
+        ndef_parser_t parser;
+        ndef_parser_init(&parser, NDEF_OSTREAM_NEW_FIXED(buf, sizeof(buf)), TEST_LONG_LEN, NULL, test_on_record,
+                         &state);
+        TEST_CHECK(test_feed(&parser, message, len, split, len));
+        TEST_CHECK(ndef_parser_done(&parser));
+        test_check_seen(&state, message, len);
+    }
+}
+
+// A payload longer than the limit fails before anything is reserved for it, however the data is split.
+static void test_max_payload_len(void) {
+    uint8_t message[512];
+    size_t  len = test_message(message);
+    for (size_t chunk = 1; chunk <= len; chunk++) {
+        test_state_t  state = {0};
+        ndef_parser_t parser;
+        ndef_parser_init(&parser, NDEF_OSTREAM_NEW(), TEST_LONG_LEN - 1, NULL, test_on_record, &state);
+        TEST_CHECK(!test_feed(&parser, message, len, 0, chunk));
+        TEST_CHECK(parser.state == NDEF_PARSER_STATE_ERROR && parser.result.err == NDEF_ERR_PAYLOAD);
+        TEST_CHECK(state.count == 1 && parser.buffer.cap < TEST_LONG_LEN);
+        // A failed parser stays failed.
+        TEST_CHECK(!ndef_parser_feed(&parser, message, 1));
+        ndef_parser_free(&parser);
+    }
+}
+
+// A fixed buffer too small for a record split across chunks fails with `NDEF_ERR_NO_SPACE`.
+static void test_buffer_too_small(void) {
+    uint8_t       message[512];
+    uint8_t       buf[16];
+    size_t        len   = test_message(message);
+    test_state_t  state = {0};
+    ndef_parser_t parser;
+    ndef_parser_init(&parser, NDEF_OSTREAM_NEW_FIXED(buf, sizeof(buf)), SIZE_MAX, NULL, test_on_record, &state);
+    TEST_CHECK(!test_feed(&parser, message, len, 0, 16));
+    TEST_CHECK(parser.result.err == NDEF_ERR_NO_SPACE && state.count == 1);
+}
+
+// Only the first record may have the message begin flag, and it must have it.
+static void test_message_flags(void) {
+    static const uint8_t no_begin[]   = {NDEF_FLAG_MESSAGE_END | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_EMPTY, 0, 0};
+    static const uint8_t two_begins[] = {
+        NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_EMPTY, 0, 0,
+        NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_MESSAGE_END | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_EMPTY, 0, 0,
+    };
+    for (size_t chunk = 1; chunk <= sizeof(two_begins); chunk++) {
+        test_state_t  state = {0};
+        ndef_parser_t parser;
+        ndef_parser_init(&parser, NDEF_OSTREAM_NEW(), SIZE_MAX, NULL, test_on_record, &state);
+        TEST_CHECK(!test_feed(&parser, no_begin, sizeof(no_begin), 0, chunk));
+        TEST_CHECK(parser.result.err == NDEF_ERR_MALFORMED && state.count == 0);
+        ndef_parser_free(&parser);
+
+        state = (test_state_t){0};
+        ndef_parser_init(&parser, NDEF_OSTREAM_NEW(), SIZE_MAX, NULL, test_on_record, &state);
+        TEST_CHECK(!test_feed(&parser, two_begins, sizeof(two_begins), 0, chunk));
+        TEST_CHECK(parser.result.err == NDEF_ERR_MALFORMED && state.count == 1);
+        ndef_parser_free(&parser);
+    }
+}
+
+// The number of bytes still needed, known from the header onwards.
+static void test_needed(void) {
+    uint8_t header[sizeof(test_long_header)];
+    memcpy(header, test_long_header, sizeof(header));
+    header[0] |= NDEF_FLAG_MESSAGE_BEGIN;
+
+    test_state_t  state = {0};
+    ndef_parser_t parser;
+    ndef_parser_init(&parser, NDEF_OSTREAM_NEW(), SIZE_MAX, NULL, test_on_record, &state);
+    TEST_CHECK(ndef_parser_needed(&parser) == 3);
+    // The flags of the long record tell that its header is 7 bytes.
+    TEST_CHECK(ndef_parser_feed(&parser, header, 1));
+    TEST_CHECK(ndef_parser_needed(&parser) == 6);
+    // With the whole header, the type, ID and payload are known.
+    TEST_CHECK(ndef_parser_feed(&parser, header + 1, 6));
+    TEST_CHECK(ndef_parser_needed(&parser) == 4 + TEST_LONG_LEN);
+    TEST_CHECK(ndef_parser_feed(&parser, header + 7, 4));
+    TEST_CHECK(ndef_parser_needed(&parser) == TEST_LONG_LEN);
+    ndef_parser_free(&parser);
+}
+
+int main(void) {
+    test_chunk_sizes();
+    test_split_points();
+    test_max_payload_len();
+    test_buffer_too_small();
+    test_message_flags();
+    test_needed();
+    return 0;
+}
@@ -0,0 +1,89 @@
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Tests of the record type registry, including registries too small to hold more than a few types.
+
+#include "ndef/registry.h"
+#include "test.h"
+
+// Largest registry tested.
+#define TEST_MAX_CAP 16
+
+// Names of distinct types to fill registries with.
+static const char* const test_types[TEST_MAX_CAP] = {
+    "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m", "n", "o", "p",
+};
+
+// Registries hold up to three quarters of their slots and always keep one free, so that lookups that miss end.
+static void test_capacity(void) {
+    static const size_t expected[] = {[1] = 0, [2] = 1, [4] = 3, [8] = 6, [16] = 12};
+    static int          value;
+    for (size_t cap = 1; cap <= TEST_MAX_CAP; cap *= 2) {
+        ndef_registry_entry_t entries[TEST_MAX_CAP];
+        ndef_registry_t       registry;
+        ndef_registry_init(&registry, entries, cap);
+        size_t added = 0;
+        while (added < cap && ndef_registry_add(&registry, NDEF_TNF_EXTERNAL_TYPE, test_types[added], 1, &value)) {
+            added++;
+        }
+        TEST_CHECK(added == expected[cap] && registry.len == added);
+
+        // Every type that was added is found, every other one misses.
+        for (size_t i = 0; i < TEST_MAX_CAP; i++) {
+            const void* found = ndef_registry_find(&registry, NDEF_TNF_EXTERNAL_TYPE, test_types[i], 1);
+            TEST_CHECK(found == (i < added ? &value : NULL));
+            TEST_CHECK(!ndef_registry_find(&registry, NDEF_TNF_WELL_KNOWN, test_types[i], 1));
+        }
+        TEST_CHECK(!ndef_registry_find(&registry, NDEF_TNF_EXTERNAL_TYPE, "", 0));
+        TEST_CHECK(!ndef_registry_find(&registry, NDEF_TNF_EXTERNAL_TYPE, "aa", 2));
+
+        // A full registry still replaces the values of types it holds.
+        if (added) {
+            static int other;
+            TEST_CHECK(ndef_registry_add(&registry, NDEF_TNF_EXTERNAL_TYPE, test_types[0], 1, &other));
+            TEST_CHECK(registry.len == added);
+            TEST_CHECK(ndef_registry_find(&registry, NDEF_TNF_EXTERNAL_TYPE, test_types[0], 1) == &other);
+        }
+    }
+
+    // A registry needs a power of two slots and values that are not NULL.
+    ndef_registry_entry_t entries[3];
+    ndef_registry_t       registry;
+    ndef_registry_init(&registry, entries, 3);
+    TEST_CHECK(!ndef_registry_add(&registry, NDEF_TNF_EXTERNAL_TYPE, "a", 1, &value));
+    ndef_registry_init(&registry, entries, 2);
+    TEST_CHECK(!ndef_registry_add(&registry, NDEF_TNF_EXTERNAL_TYPE, "a", 1, NULL));
+    TEST_CHECK(!ndef_registry_find(&registry, NDEF_TNF_EXTERNAL_TYPE, "a", 1));
+}
+
+// MIME and external types are matched without regard to case, others exactly.
+static void test_case(void) {
+    static int            values[4];
+    ndef_registry_entry_t entries[8];
+    ndef_registry_t       registry;
+    ndef_registry_init(&registry, entries, 8);
+    TEST_CHECK(ndef_registry_add(&registry, NDEF_TNF_MIME_MEDIA, "Text/Plain", 10, &values[0]));
+    TEST_CHECK(ndef_registry_add(&registry, NDEF_TNF_EXTERNAL_TYPE, "example.com:T", 13, &values[1]));
+    TEST_CHECK(ndef_registry_add(&registry, NDEF_TNF_WELL_KNOWN, "U", 1, &values[2]));
+    TEST_CHECK(ndef_registry_add(&registry, NDEF_TNF_WELL_KNOWN, "u", 1, &values[3]));
+    TEST_CHECK(registry.len == 4);
+
+    TEST_CHECK(ndef_registry_find(&registry, NDEF_TNF_MIME_MEDIA, "text/plain", 10) == &values[0]);
+    TEST_CHECK(ndef_registry_find(&registry, NDEF_TNF_MIME_MEDIA, "TEXT/PLAIN", 10) == &values[0]);
+    TEST_CHECK(ndef_registry_find(&registry, NDEF_TNF_EXTERNAL_TYPE, "EXAMPLE.com:t", 13) == &values[1]);
+    TEST_CHECK(ndef_registry_find(&registry, NDEF_TNF_WELL_KNOWN, "U", 1) == &values[2]);
+    TEST_CHECK(ndef_registry_find(&registry, NDEF_TNF_WELL_KNOWN, "u", 1) == &values[3]);
+    TEST_CHECK(!ndef_registry_find(&registry, NDEF_TNF_MIME_MEDIA, "text/plain2", 11));
+    TEST_CHECK(!ndef_registry_find(&registry, NDEF_TNF_EXTERNAL_TYPE, "text/plain", 10));
+
+    // Adding a type in another case replaces it.
+    TEST_CHECK(ndef_registry_add(&registry, NDEF_TNF_MIME_MEDIA, "TEXT/plain", 10, &values[1]));
+    TEST_CHECK(registry.len == 4);
+    TEST_CHECK(ndef_registry_find(&registry, NDEF_TNF_MIME_MEDIA, "text/plain", 10) == &values[1]);
+}
+
+int main(void) {
+    test_capacity();
+    test_case();
+    return 0;
+}
@@ -0,0 +1,111 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Known-answer tests for the record hash of Signature records.
+
+#include <string.h>
+#include "test.h"
+
+// A message of a short Text record, a MIME record with an ID and a long payload length, and a Signature record.
+// The Signature record is appended by `test_message`.
+static const uint8_t test_records[] = {
+    // Text record "Hi" in English.
+    NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_WELL_KNOWN, 1, 5, 'T', 2, 'e', 'n', 'H', 'i',
+    // MIME record of type "a/b" with ID "x", its 1-byte payload in a 4-byte length field.
+    NDEF_FLAG_ID_LENGTH | NDEF_TNF_MIME_MEDIA, 3, 0, 0, 0, 1, 1, 'a', '/', 'b', 'x', 'z',
+};
+
+// SHA-256 of the Text record as hashed: 01 05 'T' 02 'e' 'n' 'H' 'i'.
+static const uint8_t test_text_digest[NDEF_SHA256_LEN] = {
+    0x8f, 0xad, 0x6a, 0x79, 0xc9, 0xf4, 0x98, 0x92, 0xa7, 0x27, 0xae, 0x0b, 0xa5, 0x6e, 0x91, 0x09,
+    0xf3, 0x30, 0x75, 0xb1, 0xfb, 0xf7, 0xad, 0x56, 0x4e, 0x68, 0xf8, 0x40, 0x42, 0x2f, 0x56, 0xdb,
+};
+
+// SHA-256 of both records as hashed, the MIME record as 03 00 00 00 01 01 'a' '/' 'b' 'x' 'z'.
+static const uint8_t test_message_digest[NDEF_SHA256_LEN] = {
+    0xa7, 0x0b, 0x73, 0xd8, 0x03, 0x08, 0xf2, 0x20, 0x95, 0xa3, 0x76, 0x7d, 0x7b, 0x49, 0xd3, 0x8e,
+    0xee, 0x72, 0x08, 0xf2, 0x69, 0xef, 0x88, 0x69, 0x6c, 0xe8, 0x2e, 0x35, 0xba, 0x13, 0x68, 0x47,
+};
+
+// Verify callback that accepts a signature if the digest is `test_message_digest`.
+static bool test_verify(void* cookie, const ndef_sig_t* sig, const uint8_t* digest, size_t digest_len) {
+    (void)sig;
+    (*(size_t*)cookie)++;
+    return digest_len == NDEF_SHA256_LEN && memcmp(digest, test_message_digest, NDEF_SHA256_LEN) == 0;
+}
+
+// Parser callback that feeds each record to a verifier.
+static bool test_on_record(void* cookie, const ndef_record_t* record) {
+    return ndef_sig_verifier_feed(cookie, record);
+}
+
+// Build the test message, ending in a Signature record.
+static void test_message(ndef_ostream_t* ostream) {
+    static const uint8_t signature[] = {0x30, 0x00};
+    TEST_CHECK(ndef_ostream_extend(ostream, test_records, sizeof(test_records)));
+    ndef_sig_t sig = {
+        .type          = NDEF_SIG_TYPE_ECDSA,
+        .hash          = NDEF_SIG_HASH_SHA256,
+        .signature     = signature,
+        .signature_len = sizeof(signature),
+    };
+    TEST_CHECK(ndef_sig_write(ostream, sig, NDEF_POS_END));
+}
+
+// A record that has not been encoded is hashed in the form the writers give it.
+static void test_hash_unread(void) {
+    ndef_record_t record = {
+        .tnf         = NDEF_TNF_WELL_KNOWN,
+        .type_len    = 1,
+        .type        = "T",
+        .payload_len = 5,
+        .payload     = (const uint8_t*)"\2enHi",
+    };
+    uint8_t       digest[NDEF_SHA256_LEN];
+    ndef_sha256_t hash;
+    ndef_sha256_init(&hash);
+    ndef_sig_hash_record(&hash, &record);
+    ndef_sha256_finish(&hash, digest);
+    ndef_sha256_free(&hash);
+    TEST_CHECK(memcmp(digest, test_text_digest, NDEF_SHA256_LEN) == 0);
+}
+
+// Records read from a buffer are hashed as they were encoded.
+static void test_verify_message(void) {
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    test_message(&ostream);
+    size_t         calls   = 0;
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(ostream.data, ostream.len);
+    TEST_CHECK(ndef_sig_verify_message(&istream, test_verify, &calls));
+    TEST_CHECK(calls == 1);
+    ndef_ostream_free(&ostream);
+}
+
+// Records from the incremental parser are hashed as they were encoded, also when split across chunks.
+static void test_verify_parser(void) {
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    test_message(&ostream);
+    for (size_t chunk = 1; chunk <= ostream.len; chunk++) {
+        size_t              calls = 0;
+        ndef_sig_verifier_t verifier;
+        ndef_sig_verifier_init(&verifier, test_verify, &calls);
+        ndef_parser_t parser;
+        ndef_parser_init(&parser, NDEF_OSTREAM_NEW(), SIZE_MAX, NULL, test_on_record, &verifier);
+        for (size_t i = 0; i < ostream.len; i += chunk) {
+            size_t len = ostream.len - i < chunk ? ostream.len - i : chunk;
+            TEST_CHECK(ndef_parser_feed(&parser, ostream.data + i, len));
+        }
+        TEST_CHECK(ndef_parser_done(&parser) && ndef_sig_verifier_all_signed(&verifier) && calls == 1);
+        ndef_parser_free(&parser);
+        ndef_sig_verifier_free(&verifier);
+    }
+    ndef_ostream_free(&ostream);
+}
+
+int main(void) {
+    test_hash_unread();
+    test_verify_message();
+    test_verify_parser();
+    return 0;
+}
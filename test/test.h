@@ -0,0 +1,20 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Helpers shared by the host tests.
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ndef.h"
+
+// Fail the test if a condition does not hold.
+#define TEST_CHECK(cond_)                                                                                              \
+    do {                                                                                                               \
+        if (!(cond_)) {                                                                                                \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond_);                                  \
+            exit(1);                                                                                                   \
+        }                                                                                                              \
+    } while (0)
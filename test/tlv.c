@@ -0,0 +1,187 @@
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Known-answer tests of TLV blocks, including padding, NULL TLVs and the Terminator TLV.
+
+#include <string.h>
+#include "ndef/tlv.h"
+#include "test.h"
+
+// The NDEF message in `test_tlv_vector`: one empty record.
+static const uint8_t test_message[] = {
+    NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_MESSAGE_END | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_EMPTY, 0, 0,
+};
+
+// A tag data area: a Lock Control TLV, a NULL TLV, the message, and a Terminator TLV padded to 8-byte blocks.
+static const uint8_t test_tlv_vector[] = {
+    NDEF_TLV_LOCK_CONTROL, 3, 0xa0, 0x10, 0x44,
+    NDEF_TLV_NULL,
+    NDEF_TLV_NDEF_MESSAGE, 3, test_message[0], 0, 0,
+    NDEF_TLV_TERMINATOR, NDEF_TLV_NULL, NDEF_TLV_NULL, NDEF_TLV_NULL, NDEF_TLV_NULL,
+};
+
+// The known data area is written as expected, with the message written through `ndef_tlv_write_begin`.
+static void test_write_vector(void) {
+    static const uint8_t lock[]  = {0xa0, 0x10, 0x44};
+    static const uint8_t null    = NDEF_TLV_NULL;
+    ndef_ostream_t       ostream = NDEF_OSTREAM_NEW();
+    size_t               mark;
+    TEST_CHECK(ndef_tlv_write(&ostream, NDEF_TLV_LOCK_CONTROL, lock, sizeof(lock)));
+    TEST_CHECK(ndef_ostream_extend(&ostream, &null, 1));
+    TEST_CHECK(ndef_tlv_write_begin(&ostream, NDEF_TLV_NDEF_MESSAGE, &mark) && mark == 6);
+    TEST_CHECK(ndef_ostream_extend(&ostream, test_message, sizeof(test_message)));
+    TEST_CHECK(ndef_tlv_write_end(&ostream, mark) == ndef_tlv_encoded_size(sizeof(test_message)));
+    TEST_CHECK(ndef_tlv_write_terminator(&ostream, 8));
+    TEST_CHECK(ostream.len == sizeof(test_tlv_vector));
+    TEST_CHECK(memcmp(ostream.data, test_tlv_vector, sizeof(test_tlv_vector)) == 0);
+    ndef_ostream_free(&ostream);
+}
+
+// The known data area reads back block by block, and the message is found past the other blocks.
+static void test_read_vector(void) {
+    static const ndef_tlv_type_t types[] = {
+        NDEF_TLV_LOCK_CONTROL, NDEF_TLV_NULL, NDEF_TLV_NDEF_MESSAGE, NDEF_TLV_TERMINATOR,
+    };
+    static const size_t offsets[] = {0, 5, 6, 11};
+    ndef_istream_t      istream   = NDEF_ISTREAM_NEW(test_tlv_vector, sizeof(test_tlv_vector));
+    ndef_tlv_t          tlv;
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        TEST_CHECK(ndef_tlv_read(&istream, &tlv));
+        TEST_CHECK(tlv.type == types[i] && tlv.offset == offsets[i]);
+    }
+    while (ndef_istream_available(&istream)) {
+        TEST_CHECK(ndef_tlv_read(&istream, &tlv) == 1 && tlv.type == NDEF_TLV_NULL && tlv.len == 0);
+    }
+
+    ndef_tlv_control_t control;
+    istream = NDEF_ISTREAM_NEW(test_tlv_vector, sizeof(test_tlv_vector));
+    TEST_CHECK(ndef_tlv_read(&istream, &tlv) == 5 && ndef_tlv_control_decode(&tlv, &control));
+    TEST_CHECK(control.address == 160 && control.size == 16 && control.bytes_per_lock_bit == 16);
+
+    TEST_CHECK(ndef_tlv_find_message(test_tlv_vector, sizeof(test_tlv_vector), &istream));
+    TEST_CHECK(istream.len == sizeof(test_message) && memcmp(istream.data, test_message, sizeof(test_message)) == 0);
+}
+
+// The Terminator TLV is padded with NULL TLVs up to a multiple of the page size.
+static void test_terminator_padding(void) {
+    static const size_t page_sizes[] = {0, 1, 4, 8, 16};
+    for (size_t p = 0; p < sizeof(page_sizes) / sizeof(page_sizes[0]); p++) {
+        size_t page_size = page_sizes[p];
+        for (size_t start = 0; start < 20; start++) {
+            ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+            for (size_t i = 0; i < start; i++) {
+                uint8_t byte = 0xaa;
+                TEST_CHECK(ndef_ostream_extend(&ostream, &byte, 1));
+            }
+            TEST_CHECK(ndef_tlv_write_terminator(&ostream, page_size));
+
+            size_t expected = start + 1;
+            while (page_size > 1 && expected % page_size) {
+                expected++;
+            }
+            TEST_CHECK(ostream.len == expected && ostream.data[start] == NDEF_TLV_TERMINATOR);
+            for (size_t i = start + 1; i < expected; i++) {
+                TEST_CHECK(ostream.data[i] == NDEF_TLV_NULL);
+            }
+            ndef_ostream_free(&ostream);
+        }
+    }
+
+    // Padding that does not fit in a fixed buffer writes nothing.
+    uint8_t        buf[8];
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW_FIXED(buf, 7);
+    TEST_CHECK(!ndef_tlv_write_terminator(&ostream, 8));
+    TEST_CHECK(ostream.len == 0 && ostream.result.err == NDEF_ERR_NO_SPACE);
+    ostream = NDEF_OSTREAM_NEW_FIXED(buf, 8);
+    TEST_CHECK(ndef_tlv_write_terminator(&ostream, 8) && ostream.len == 8);
+}
+
+// Values shorter than 255 bytes use the one-byte length, others the three-byte one, up to `NDEF_TLV_MAX_LEN`.
+static void test_lengths(void) {
+    static uint8_t      value[NDEF_TLV_MAX_LEN + 1];
+    static const size_t lens[] = {0, 1, 254, 255, 256, NDEF_TLV_MAX_LEN};
+    for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        size_t         len     = lens[i];
+        ndef_ostream_t written = NDEF_OSTREAM_NEW();
+        TEST_CHECK(ndef_tlv_write(&written, NDEF_TLV_PROPRIETARY, value, len));
+        TEST_CHECK(written.len == ndef_tlv_encoded_size(len) && written.data[0] == NDEF_TLV_PROPRIETARY);
+        if (len < 0xff) {
+            TEST_CHECK(ndef_tlv_header_size(len) == 2 && written.data[1] == len);
+        } else {
+            TEST_CHECK(ndef_tlv_header_size(len) == 4 && written.data[1] == 0xff);
+            TEST_CHECK(written.data[2] == len >> 8 && written.data[3] == (len & 0xff));
+        }
+
+        // Writing the value after the header is the same, so is filling in the length afterwards.
+        ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+        size_t         mark;
+        TEST_CHECK(ndef_tlv_write_begin(&ostream, NDEF_TLV_PROPRIETARY, &mark) && mark == 0);
+        TEST_CHECK(ndef_ostream_extend(&ostream, value, len));
+        TEST_CHECK(ndef_tlv_write_end(&ostream, mark) == written.len);
+        TEST_CHECK(ostream.len == written.len && memcmp(ostream.data, written.data, written.len) == 0);
+        ndef_ostream_free(&ostream);
+
+        ndef_tlv_t     tlv;
+        ndef_istream_t istream = NDEF_ISTREAM_NEW(written.data, written.len);
+        TEST_CHECK(ndef_tlv_read(&istream, &tlv) == written.len);
+        TEST_CHECK(tlv.len == len && tlv.value == written.data + ndef_tlv_header_size(len));
+        ndef_ostream_free(&written);
+    }
+
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    TEST_CHECK(!ndef_tlv_write(&ostream, NDEF_TLV_PROPRIETARY, value, NDEF_TLV_MAX_LEN + 1));
+    TEST_CHECK(ostream.len == 0 && ostream.result.err == NDEF_ERR_INVALID_ARG);
+    size_t mark;
+    TEST_CHECK(ndef_tlv_write_begin(&ostream, NDEF_TLV_PROPRIETARY, &mark));
+    TEST_CHECK(ndef_ostream_extend(&ostream, value, NDEF_TLV_MAX_LEN + 1));
+    TEST_CHECK(!ndef_tlv_write_end(&ostream, mark) && ostream.result.err == NDEF_ERR_INVALID_ARG);
+    ndef_ostream_free(&ostream);
+}
+
+// Searches stop at the Terminator TLV and at truncated blocks, leaving the stream where it was.
+static void test_find(void) {
+    // A message TLV after the Terminator TLV is not found.
+    static const uint8_t after_end[] = {NDEF_TLV_NULL, NDEF_TLV_TERMINATOR, NDEF_TLV_NDEF_MESSAGE, 0};
+    ndef_istream_t       istream     = NDEF_ISTREAM_NEW(after_end, sizeof(after_end));
+    ndef_tlv_t           tlv;
+    TEST_CHECK(!ndef_tlv_find(&istream, NDEF_TLV_NDEF_MESSAGE, &tlv) && istream.index == 0);
+    TEST_CHECK(ndef_tlv_find(&istream, NDEF_TLV_TERMINATOR, &tlv) && tlv.offset == 1 && istream.index == 2);
+
+    // An empty message TLV is found.
+    istream = NDEF_ISTREAM_NEW(after_end + 2, 2);
+    TEST_CHECK(ndef_tlv_find(&istream, NDEF_TLV_NDEF_MESSAGE, &tlv) && tlv.len == 0);
+
+    // Truncated in the length, in the long length and in the value.
+    static const uint8_t truncated[][4] = {
+        {NDEF_TLV_NDEF_MESSAGE},
+        {NDEF_TLV_NDEF_MESSAGE, 0xff, 0x01},
+        {NDEF_TLV_NDEF_MESSAGE, 3, 0, 0},
+        {NDEF_TLV_NDEF_MESSAGE, 0xff, 0x00, 0x01},
+    };
+    static const size_t truncated_lens[] = {1, 3, 4, 4};
+    for (size_t i = 0; i < sizeof(truncated_lens) / sizeof(truncated_lens[0]); i++) {
+        istream = NDEF_ISTREAM_NEW(truncated[i], truncated_lens[i]);
+        TEST_CHECK(!ndef_tlv_read(&istream, &tlv));
+        TEST_CHECK(istream.index == 0 && istream.result.err == NDEF_ERR_TRUNCATED);
+        istream = NDEF_ISTREAM_NEW(truncated[i], truncated_lens[i]);
+        TEST_CHECK(!ndef_tlv_find(&istream, NDEF_TLV_NDEF_MESSAGE, &tlv) && istream.index == 0);
+    }
+
+    // Memory Control TLVs have no lock bits; other TLVs are not control TLVs.
+    static const uint8_t memory[] = {NDEF_TLV_MEMORY_CONTROL, 3, 0x48, 0x00, 0x03};
+    ndef_tlv_control_t   control;
+    istream = NDEF_ISTREAM_NEW(memory, sizeof(memory));
+    TEST_CHECK(ndef_tlv_read(&istream, &tlv) && ndef_tlv_control_decode(&tlv, &control));
+    TEST_CHECK(control.address == 4 * 8 + 8 && control.size == 256 && control.bytes_per_lock_bit == 0);
+    tlv.type = NDEF_TLV_PROPRIETARY;
+    TEST_CHECK(!ndef_tlv_control_decode(&tlv, &control));
+}
+
+int main(void) {
+    test_write_vector();
+    test_read_vector();
+    test_terminator_padding();
+    test_lengths();
+    test_find();
+    return 0;
+}
@@ -0,0 +1,153 @@
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Known-answer tests of UTF-8 validation and of streaming UTF-8 and UTF-16 transcoding, fed in every split.
+
+#include <string.h>
+#include "ndef/utf.h"
+#include "test.h"
+
+// Largest output of any test case.
+#define TEST_MAX_OUT 64
+
+// A transcoding test case.
+typedef struct {
+    const char* in;
+    size_t      in_len;
+    const char* out;
+    size_t      out_len;
+    bool        big_endian;
+} test_case_t;
+
+// A test case of string literals, which may contain NUL bytes.
+#define TEST_CASE(in_, out_, big_endian_) {in_, sizeof(in_) - 1, out_, sizeof(out_) - 1, big_endian_}
+
+// "Aé€😀", and the same with invalid and truncated sequences; each invalid sequence becomes one U+FFFD.
+static const test_case_t test_utf8_cases[] = {
+    TEST_CASE("A\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80", "A\0\xe9\0\xac\x20\x3d\xd8\x00\xde", false),
+    TEST_CASE("A\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80", "\0A\0\xe9\x20\xac\xd8\x3d\xde\x00", true),
+    TEST_CASE("", "", false),
+    // Overlong, continuation byte, surrogate, above U+10FFFF and a lead byte that is never valid.
+    TEST_CASE("\xc0\x80", "\xfd\xff\xfd\xff", false),
+    TEST_CASE("\x80" "B", "\xfd\xff" "B\0", false),
+    TEST_CASE("\xed\xa0\x80", "\xfd\xff\xfd\xff\xfd\xff", false),
+    TEST_CASE("\xf4\x90\x80\x80", "\xfd\xff\xfd\xff\xfd\xff\xfd\xff", false),
+    TEST_CASE("\xf5", "\xfd\xff", false),
+    // A sequence cut short by another character, and one cut short by the end of the input.
+    TEST_CASE("\xe2\x82" "A", "\xfd\xff" "A\0", false),
+    TEST_CASE("A\xf0\x9f\x98", "A\0\xfd\xff", false),
+};
+
+// The UTF-16 of `test_utf8_cases`, with byte order marks, unpaired surrogates and truncated input.
+static const test_case_t test_utf16_cases[] = {
+    TEST_CASE("A\0\xe9\0\xac\x20\x3d\xd8\x00\xde", "A\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80", false),
+    TEST_CASE("\0A\0\xe9\x20\xac\xd8\x3d\xde\x00", "A\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80", true),
+    TEST_CASE("", "", false),
+    // A byte order mark overrides the assumed byte order and is dropped; a second one is a character.
+    TEST_CASE("\xfe\xff\0A", "A", false),
+    TEST_CASE("\xff\xfe" "A\0", "A", true),
+    TEST_CASE("\xff\xfe\xff\xfe", "\xef\xbb\xbf", false),
+    // An unpaired high surrogate, a lone low surrogate, and a high surrogate at the end.
+    TEST_CASE("\x3d\xd8" "A\0", "\xef\xbf\xbd" "A", false),
+    TEST_CASE("\x00\xde" "A\0", "\xef\xbf\xbd" "A", false),
+    TEST_CASE("A\0\x3d\xd8", "A\xef\xbf\xbd", false),
+    // A code unit cut short by the end of the input.
+    TEST_CASE("A\0B", "A\xef\xbf\xbd", false),
+};
+
+// Transcode a case with input in chunks of `chunk` bytes and output buffers of `out_cap` bytes.
+static void test_transcode(const test_case_t* test, bool from_utf8, size_t chunk, size_t out_cap) {
+    ndef_utf8_decoder_t  utf8  = {.big_endian = test->big_endian};
+    ndef_utf16_decoder_t utf16 = {.big_endian = test->big_endian};
+    uint8_t              out[TEST_MAX_OUT];
+    size_t               out_len = 0;
+    const uint8_t*       in      = (const uint8_t*)test->in;
+    size_t               fed     = 0;
+    while (fed < test->in_len) {
+        size_t         in_len = test->in_len - fed < chunk ? test->in_len - fed : chunk;
+        const uint8_t* next   = in + fed;
+        size_t         left   = in_len;
+        // Call until the chunk is used up; every call must make progress with room for a character.
+        while (left) {
+            size_t cap     = TEST_MAX_OUT - out_len < out_cap ? TEST_MAX_OUT - out_len : out_cap;
+            size_t before  = left;
+            size_t written = from_utf8 ? ndef_utf8_to_utf16(&utf8, &next, &left, out + out_len, cap)
+                                       : ndef_utf16_to_utf8(&utf16, &next, &left, out + out_len, cap);
+            TEST_CHECK(written <= cap && next == in + fed + in_len - left);
+            TEST_CHECK(written || left < before);
+            out_len += written;
+        }
+        fed += in_len;
+    }
+    out_len += from_utf8 ? ndef_utf8_to_utf16_finish(&utf8, out + out_len, TEST_MAX_OUT - out_len)
+                         : ndef_utf16_to_utf8_finish(&utf16, out + out_len, TEST_MAX_OUT - out_len);
+    TEST_CHECK(out_len == test->out_len && memcmp(out, test->out, out_len) == 0);
+}
+
+// Every case transcodes the same in one go, in chunks of every size and into output buffers of every useful size.
+static void test_cases(void) {
+    for (size_t i = 0; i < sizeof(test_utf8_cases) / sizeof(test_utf8_cases[0]); i++) {
+        const test_case_t* test = &test_utf8_cases[i];
+        TEST_CHECK(ndef_utf8_utf16_len((const uint8_t*)test->in, test->in_len) == test->out_len);
+        for (size_t chunk = 1; chunk <= test->in_len; chunk++) {
+            for (size_t out_cap = 4; out_cap <= TEST_MAX_OUT; out_cap++) {
+                test_transcode(test, true, chunk, out_cap);
+            }
+        }
+        test_transcode(test, true, TEST_MAX_OUT, TEST_MAX_OUT);
+    }
+    for (size_t i = 0; i < sizeof(test_utf16_cases) / sizeof(test_utf16_cases[0]); i++) {
+        const test_case_t* test = &test_utf16_cases[i];
+        TEST_CHECK(ndef_utf16_utf8_len((const uint8_t*)test->in, test->in_len, test->big_endian) == test->out_len);
+        for (size_t chunk = 1; chunk <= test->in_len; chunk++) {
+            for (size_t out_cap = 4; out_cap <= TEST_MAX_OUT; out_cap++) {
+                test_transcode(test, false, chunk, out_cap);
+            }
+        }
+        test_transcode(test, false, TEST_MAX_OUT, TEST_MAX_OUT);
+    }
+}
+
+// A character that does not fit is left in the input for the next call.
+static void test_out_of_room(void) {
+    static const uint8_t utf8[]  = {0xf0, 0x9f, 0x98, 0x80};
+    ndef_utf8_decoder_t  decoder = {0};
+    const uint8_t*       in      = utf8;
+    size_t               in_len  = sizeof(utf8);
+    uint8_t              out[4];
+    TEST_CHECK(ndef_utf8_to_utf16(&decoder, &in, &in_len, out, 3) == 0 && in == utf8 && in_len == 4);
+    TEST_CHECK(ndef_utf8_to_utf16(&decoder, &in, &in_len, out, 4) == 4 && in_len == 0);
+
+    static const uint8_t utf16[]  = {0xac, 0x20};
+    ndef_utf16_decoder_t decoder16 = {0};
+    in                             = utf16;
+    in_len                         = sizeof(utf16);
+    TEST_CHECK(ndef_utf16_to_utf8(&decoder16, &in, &in_len, out, 2) == 0 && in == utf16 && in_len == 2);
+    TEST_CHECK(ndef_utf16_to_utf8(&decoder16, &in, &in_len, out, 3) == 3 && in_len == 0);
+    TEST_CHECK(memcmp(out, "\xe2\x82\xac", 3) == 0);
+}
+
+// Validation rejects what transcoding replaces, wherever it is relative to the runs of ASCII skipped a word at a time.
+static void test_valid(void) {
+    for (size_t i = 0; i < sizeof(test_utf8_cases) / sizeof(test_utf8_cases[0]); i++) {
+        const test_case_t* test  = &test_utf8_cases[i];
+        bool               valid = i < 3;
+        uint8_t            data[40];
+        for (size_t offset = 0; offset + test->in_len <= sizeof(data); offset++) {
+            memset(data, 'x', sizeof(data));
+            memcpy(data + offset, test->in, test->in_len);
+            TEST_CHECK(ndef_utf8_valid(data, sizeof(data)) == valid);
+            TEST_CHECK(ndef_utf8_valid(data, offset + test->in_len) == valid);
+        }
+    }
+    TEST_CHECK(ndef_utf8_valid((const uint8_t*)"\xef\xbf\xbf\xf4\x8f\xbf\xbf\xed\x9f\xbf", 10));
+    TEST_CHECK(!ndef_utf8_valid((const uint8_t*)"\xe0\x9f\xbf", 3));
+    TEST_CHECK(!ndef_utf8_valid((const uint8_t*)"\xf0\x8f\xbf\xbf", 4));
+}
+
+int main(void) {
+    test_cases();
+    test_out_of_room();
+    test_valid();
+    return 0;
+}
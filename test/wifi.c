@@ -0,0 +1,147 @@
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Known-answer and round-trip tests of Wi-Fi Simple Configuration records.
+
+#include <string.h>
+#include "ndef/wifi.h"
+#include "test.h"
+
+// A WPA2 personal credential for SSID "ab" with key "pw" and any access point.
+static const uint8_t test_wifi_vector[] = {
+    NDEF_FLAG_MESSAGE_BEGIN | NDEF_FLAG_MESSAGE_END | NDEF_FLAG_SHORT_RECORD | NDEF_TNF_MIME_MEDIA, 23, 58,
+    'a', 'p', 'p', 'l', 'i', 'c', 'a', 't', 'i', 'o', 'n', '/', 'v', 'n', 'd', '.', 'w', 'f', 'a', '.', 'w', 's', 'c',
+    // Version.
+    0x10, 0x4a, 0x00, 0x01, 0x10,
+    // Credential: network index, SSID, authentication type, encryption type, network key and MAC address.
+    0x10, 0x0e, 0x00, 0x27,
+    0x10, 0x26, 0x00, 0x01, 0x01,
+    0x10, 0x45, 0x00, 0x02, 'a', 'b',
+    0x10, 0x03, 0x00, 0x02, 0x00, 0x20,
+    0x10, 0x0f, 0x00, 0x02, 0x00, 0x08,
+    0x10, 0x27, 0x00, 0x02, 'p', 'w',
+    0x10, 0x20, 0x00, 0x06, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    // Version2 vendor extension.
+    0x10, 0x49, 0x00, 0x06, 0x00, 0x37, 0x2a, 0x00, 0x01, 0x20,
+};
+
+// Offset of the payload in `test_wifi_vector`.
+#define TEST_PAYLOAD_OFFSET 26
+
+// The credential of `test_wifi_vector`.
+static const ndef_wifi_t test_wifi = {
+    .ssid     = "ab",
+    .ssid_len = 2,
+    .auth     = NDEF_WIFI_AUTH_WPA2_PERSONAL,
+    .encr     = NDEF_WIFI_ENCR_AES,
+    .key      = "pw",
+    .key_len  = 2,
+};
+
+// The known credential is written as expected and read back.
+static void test_vector(void) {
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    TEST_CHECK(ndef_wifi_write(&ostream, test_wifi, NDEF_POS_START_END));
+    TEST_CHECK(ostream.len == sizeof(test_wifi_vector) && ndef_wifi_encoded_size(test_wifi) == ostream.len);
+    TEST_CHECK(memcmp(ostream.data, test_wifi_vector, sizeof(test_wifi_vector)) == 0);
+    ndef_ostream_free(&ostream);
+
+    ndef_wifi_t    wifi;
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(test_wifi_vector, sizeof(test_wifi_vector));
+    TEST_CHECK(ndef_wifi_read(&istream, &wifi) == sizeof(test_wifi_vector));
+    TEST_CHECK(wifi.pos == NDEF_POS_START_END && wifi.ssid_len == 2 && memcmp(wifi.ssid, "ab", 2) == 0);
+    TEST_CHECK(wifi.key_len == 2 && memcmp(wifi.key, "pw", 2) == 0 && !wifi.mac);
+    TEST_CHECK(wifi.auth == NDEF_WIFI_AUTH_WPA2_PERSONAL && wifi.encr == NDEF_WIFI_ENCR_AES);
+}
+
+// Credentials with the longest SSID and key, a MAC address and an open network survive a round trip.
+static void test_round_trip(void) {
+    static const uint8_t mac[6]   = {0x02, 0x11, 0x22, 0x33, 0x44, 0x55};
+    char                 ssid[33] = "0123456789abcdef0123456789abcdef";
+    char                 key[65]  = "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef";
+    ndef_wifi_t          cases[]  = {
+        {.ssid = ssid, .ssid_len = 32, .auth = 0x22, .encr = 0x0c, .key = key, .key_len = 64, .mac = mac},
+        {.ssid = "x", .ssid_len = 1, .auth = NDEF_WIFI_AUTH_OPEN, .encr = NDEF_WIFI_ENCR_NONE},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+        TEST_CHECK(ndef_wifi_write(&ostream, cases[i], NDEF_POS_START));
+        TEST_CHECK(ostream.len == ndef_wifi_encoded_size(cases[i]));
+
+        ndef_wifi_t    wifi;
+        ndef_istream_t istream = NDEF_ISTREAM_NEW(ostream.data, ostream.len);
+        TEST_CHECK(ndef_wifi_read(&istream, &wifi) == ostream.len && wifi.pos == NDEF_POS_START);
+        TEST_CHECK(wifi.ssid_len == cases[i].ssid_len && memcmp(wifi.ssid, cases[i].ssid, wifi.ssid_len) == 0);
+        TEST_CHECK(wifi.key_len == cases[i].key_len && (!wifi.key_len || memcmp(wifi.key, key, wifi.key_len) == 0));
+        TEST_CHECK(wifi.auth == cases[i].auth && wifi.encr == cases[i].encr);
+        TEST_CHECK(cases[i].mac ? wifi.mac && memcmp(wifi.mac, mac, 6) == 0 : !wifi.mac);
+        ndef_ostream_free(&ostream);
+    }
+}
+
+// SSIDs over 32 bytes and keys over 64 bytes are rejected.
+static void test_too_long(void) {
+    ndef_wifi_t    wifi    = test_wifi;
+    ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+    wifi.ssid_len          = 33;
+    TEST_CHECK(!ndef_wifi_write(&ostream, wifi, NDEF_POS_START_END));
+    TEST_CHECK(ostream.len == 0 && ostream.result.err == NDEF_ERR_INVALID_ARG);
+
+    wifi         = test_wifi;
+    wifi.key_len = 65;
+    ostream      = NDEF_OSTREAM_NEW();
+    TEST_CHECK(!ndef_wifi_write(&ostream, wifi, NDEF_POS_START_END));
+    TEST_CHECK(ostream.len == 0 && ostream.result.err == NDEF_ERR_INVALID_ARG);
+}
+
+// MIME types compare without regard to case.
+static void test_type_case(void) {
+    uint8_t data[sizeof(test_wifi_vector)];
+    memcpy(data, test_wifi_vector, sizeof(data));
+    memcpy(data + 3, "Application/VND.WFA.WSC", 23);
+    ndef_wifi_t    wifi;
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(data, sizeof(data));
+    TEST_CHECK(ndef_wifi_read(&istream, &wifi) == sizeof(data));
+    TEST_CHECK(wifi.ssid_len == 2 && memcmp(wifi.ssid, "ab", 2) == 0);
+}
+
+// A record of another type is rejected as the wrong type, a bad payload as a bad payload; neither is consumed.
+static void test_reject(void) {
+    uint8_t data[sizeof(test_wifi_vector)];
+    memcpy(data, test_wifi_vector, sizeof(data));
+    data[3] = 'b';
+    ndef_wifi_t    wifi;
+    ndef_istream_t istream = NDEF_ISTREAM_NEW(data, sizeof(data));
+    TEST_CHECK(!ndef_wifi_read(&istream, &wifi));
+    TEST_CHECK(istream.index == 0 && istream.result.err == NDEF_ERR_TYPE);
+
+    // The credential attribute overruns the payload.
+    memcpy(data, test_wifi_vector, sizeof(data));
+    data[TEST_PAYLOAD_OFFSET + 8] = 0x28;
+    istream                       = NDEF_ISTREAM_NEW(data, sizeof(data));
+    TEST_CHECK(!ndef_wifi_read(&istream, &wifi));
+    TEST_CHECK(istream.index == 0 && istream.result.err == NDEF_ERR_PAYLOAD);
+
+    // The authentication type is not 2 bytes long.
+    memcpy(data, test_wifi_vector, sizeof(data));
+    data[TEST_PAYLOAD_OFFSET + 23] = 0x01;
+    istream                        = NDEF_ISTREAM_NEW(data, sizeof(data));
+    TEST_CHECK(!ndef_wifi_read(&istream, &wifi));
+    TEST_CHECK(istream.index == 0 && istream.result.err == NDEF_ERR_PAYLOAD);
+
+    // There is no credential.
+    memcpy(data, test_wifi_vector, sizeof(data));
+    data[TEST_PAYLOAD_OFFSET + 6] = 0x0d;
+    istream                       = NDEF_ISTREAM_NEW(data, sizeof(data));
+    TEST_CHECK(!ndef_wifi_read(&istream, &wifi));
+    TEST_CHECK(istream.index == 0 && istream.result.err == NDEF_ERR_PAYLOAD);
+}
+
+int main(void) {
+    test_vector();
+    test_round_trip();
+    test_too_long();
+    test_type_case();
+    test_reject();
+    return 0;
+}
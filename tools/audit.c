@@ -0,0 +1,550 @@
+
+// SPDX-CopyRightText: 2025 Julian Scheffers
+// SPDX-License-Identifier: MIT
+
+// Host tool that validates and decodes a corpus of raw tag dumps in parallel.
+// The corpus is a file of NDEF messages, each preceded by its length as a 32-bit big-endian integer.
+// Decoding uses the same library code as the firmware.
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "ndef.h"
+
+// Number of blobs a worker takes from its queue at once.
+#define AUDIT_BATCH       64
+// Maximum number of errors each worker keeps for the report.
+#define AUDIT_MAX_ERRORS  1024
+// Assumed cache line size, to keep workers from sharing lines they write to.
+#define AUDIT_CACHE_LINE  64
+// Number of record kinds counted.
+#define AUDIT_NUM_KINDS   (NDEF_DECD_TYPE_BLE_OOB + 2)
+// Record kind of records with a type that the library does not decode.
+#define AUDIT_KIND_OTHER  (NDEF_DECD_TYPE_BLE_OOB + 1)
+
+
+
+/* ==== Corpus ==== */
+
+// Location of a blob in the corpus.
+typedef struct {
+    size_t offset;
+    size_t len;
+} audit_blob_t;
+
+// Find the blobs of a corpus.
+// Returns false if the corpus is truncated; the blobs found so far are kept.
+static bool audit_index(const uint8_t* data, size_t len, audit_blob_t** blobs_out, size_t* blobs_len_out) {
+    size_t        cap   = 1024;
+    size_t        count = 0;
+    audit_blob_t* blobs = malloc(cap * sizeof(audit_blob_t));
+    size_t        index = 0;
+    bool          ok    = true;
+    while (blobs && index < len) {
+        if (len - index < 4) {
+            ok = false;
+            break;
+        }
+        size_t blob_len = (uint32_t)data[index] << 24 | (uint32_t)data[index + 1] << 16 |
+                          (uint32_t)data[index + 2] << 8 | data[index + 3];
+        index += 4;
+        if (blob_len > len - index) {
+            ok = false;
+            break;
+        }
+        if (count == cap) {
+            cap                *= 2;
+            audit_blob_t* grown  = realloc(blobs, cap * sizeof(audit_blob_t));
+            if (!grown) {
+                free(blobs);
+                blobs = NULL;
+                break;
+            }
+            blobs = grown;
+        }
+        blobs[count++]  = (audit_blob_t){index, blob_len};
+        index          += blob_len;
+    }
+    *blobs_out     = blobs;
+    *blobs_len_out = count;
+    return ok && blobs;
+}
+
+
+
+/* ==== Auditing ==== */
+
+// Reasons a blob can fail the audit.
+typedef enum {
+    // A record header is malformed or runs past the end of the blob.
+    AUDIT_ERR_RECORD,
+    // The message begin or end flags are wrong.
+    AUDIT_ERR_FRAMING,
+    // A record of a known type has an invalid payload.
+    AUDIT_ERR_PAYLOAD,
+    // There are bytes after the last record of the message.
+    AUDIT_ERR_TRAILING,
+    // The blob is empty.
+    AUDIT_ERR_EMPTY,
+    // Number of error reasons.
+    AUDIT_NUM_ERR,
+} audit_err_t;
+
+static const char* const audit_err_names[] = {
+    [AUDIT_ERR_RECORD]   = "malformed record",
+    [AUDIT_ERR_FRAMING]  = "bad message framing",
+    [AUDIT_ERR_PAYLOAD]  = "invalid payload",
+    [AUDIT_ERR_TRAILING] = "trailing bytes",
+    [AUDIT_ERR_EMPTY]    = "empty message",
+};
+
+static const char* const audit_kind_names[] = {
+    [NDEF_DECD_TYPE_UNKNOWN]      = "empty/unchanged",
+    [NDEF_DECD_TYPE_URI]          = "uri",
+    [NDEF_DECD_TYPE_TEXT]         = "text",
+    [NDEF_DECD_TYPE_SMART_POSTER] = "smartposter",
+    [NDEF_DECD_TYPE_WIFI]         = "wifi",
+    [NDEF_DECD_TYPE_AAR]          = "aar",
+    [NDEF_DECD_TYPE_MIME]         = "mime",
+    [NDEF_DECD_TYPE_EXTERNAL]     = "external",
+    [NDEF_DECD_TYPE_SIGNATURE]    = "signature",
+    [NDEF_DECD_TYPE_HANDOVER]     = "handover",
+    [NDEF_DECD_TYPE_BLE_OOB]      = "ble_oob",
+    [AUDIT_KIND_OTHER]            = "other",
+};
+
+// An error found in a blob.
+typedef struct {
+    // Index of the blob in the corpus.
+    size_t      blob;
+    // Offset of the failing record within the blob.
+    size_t      offset;
+    // Why the blob failed.
+    audit_err_t err;
+    // Kind of the failing record, for payload errors.
+    int         kind;
+} audit_error_t;
+
+// Statistics gathered by a worker.
+typedef struct {
+    size_t        blobs;
+    size_t        blobs_ok;
+    size_t        bytes;
+    size_t        records;
+    size_t        kinds[AUDIT_NUM_KINDS];
+    size_t        kind_bytes[AUDIT_NUM_KINDS];
+    size_t        tnfs[8];
+    size_t        errs[AUDIT_NUM_ERR];
+    size_t        errors_len;
+    audit_error_t errors[AUDIT_MAX_ERRORS];
+} audit_stats_t;
+
+// Get the record kind that a record should decode as, from its type alone.
+static int audit_expected_kind(const ndef_record_t* record) {
+    if (ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "U", 1)) {
+        return NDEF_DECD_TYPE_URI;
+    } else if (ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "T", 1)) {
+        return NDEF_DECD_TYPE_TEXT;
+    } else if (ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Sp", 2)) {
+        return NDEF_DECD_TYPE_SMART_POSTER;
+    } else if (ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Sig", 3)) {
+        return NDEF_DECD_TYPE_SIGNATURE;
+    } else if (ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Hs", 2) ||
+               ndef_record_is_type(record, NDEF_TNF_WELL_KNOWN, "Hr", 2)) {
+        return NDEF_DECD_TYPE_HANDOVER;
+    } else if (ndef_record_is_type(record, NDEF_TNF_MIME_MEDIA, NDEF_WIFI_MIME_TYPE,
+                                   sizeof(NDEF_WIFI_MIME_TYPE) - 1)) {
+        return NDEF_DECD_TYPE_WIFI;
+    } else if (ndef_record_is_type(record, NDEF_TNF_MIME_MEDIA, NDEF_BLE_OOB_MIME_TYPE,
+                                   sizeof(NDEF_BLE_OOB_MIME_TYPE) - 1)) {
+        return NDEF_DECD_TYPE_BLE_OOB;
+    } else if (record->tnf == NDEF_TNF_MIME_MEDIA) {
+        return NDEF_DECD_TYPE_MIME;
+    } else if (ndef_record_is_type(record, NDEF_TNF_EXTERNAL_TYPE, NDEF_AAR_TYPE, sizeof(NDEF_AAR_TYPE) - 1)) {
+        return NDEF_DECD_TYPE_AAR;
+    } else if (record->tnf == NDEF_TNF_EXTERNAL_TYPE) {
+        return NDEF_DECD_TYPE_EXTERNAL;
+    } else if (record->tnf == NDEF_TNF_EMPTY || record->tnf == NDEF_TNF_UNCHANGED) {
+        return NDEF_DECD_TYPE_UNKNOWN;
+    }
+    return AUDIT_KIND_OTHER;
+}
+
+// Record an error found in a blob.
+static void audit_fail(audit_stats_t* stats, size_t blob, size_t offset, audit_err_t err, int kind) {
+    stats->errs[err]++;
+    if (stats->errors_len < AUDIT_MAX_ERRORS) {
+        stats->errors[stats->errors_len++] = (audit_error_t){blob, offset, err, kind};
+    }
+}
+
+// Validate and decode every record of a blob.
+static void audit_blob(audit_stats_t* stats, const uint8_t* data, size_t len, size_t blob) {
+    stats->blobs++;
+    stats->bytes += len;
+    if (!len) {
+        audit_fail(stats, blob, 0, AUDIT_ERR_EMPTY, 0);
+        return;
+    }
+
+    ndef_istream_t      istream = NDEF_ISTREAM_NEW(data, len);
+    ndef_message_iter_t iter    = NDEF_MESSAGE_ITER_NEW(&istream);
+    while (!ndef_message_done(&iter)) {
+        size_t        offset = istream.index;
+        ndef_record_t record;
+        if (!ndef_message_next(&iter, &record)) {
+            // Tell framing errors, including a missing message end, apart from malformed records.
+            bool framing = !ndef_istream_available(&istream) || ndef_read_record(&istream, &record) != 0;
+            audit_fail(stats, blob, offset, framing ? AUDIT_ERR_FRAMING : AUDIT_ERR_RECORD, 0);
+            return;
+        }
+        stats->records++;
+        stats->tnfs[record.tnf]++;
+
+        int                kind = audit_expected_kind(&record);
+        ndef_decd_record_t decd;
+        stats->kinds[kind]++;
+        stats->kind_bytes[kind] += istream.index - offset;
+        if (kind != AUDIT_KIND_OTHER && kind != NDEF_DECD_TYPE_UNKNOWN &&
+            (!ndef_decd_decode(&record, &decd) || (int)decd.type != kind)) {
+            audit_fail(stats, blob, offset, AUDIT_ERR_PAYLOAD, kind);
+            return;
+        }
+    }
+    if (ndef_istream_available(&istream)) {
+        audit_fail(stats, blob, istream.index, AUDIT_ERR_TRAILING, 0);
+        return;
+    }
+    stats->blobs_ok++;
+}
+
+
+
+/* ==== Work stealing ==== */
+
+// The queue of a worker: a range of blob indices.
+// The owner takes batches from the front; thieves take the back half.
+typedef struct {
+    pthread_mutex_t lock;
+    size_t          begin;
+    size_t          end;
+} audit_queue_t;
+
+// State of a worker thread, padded so workers do not write to each other's cache lines.
+typedef struct {
+    _Alignas(AUDIT_CACHE_LINE) audit_queue_t queue;
+    _Alignas(AUDIT_CACHE_LINE) audit_stats_t stats;
+    pthread_t                                thread;
+    size_t                                   id;
+    size_t                                   steals;
+} audit_worker_t;
+
+// State shared by all workers.
+typedef struct {
+    const uint8_t*      data;
+    const audit_blob_t* blobs;
+    audit_worker_t*     workers;
+    size_t              workers_len;
+    // Number of blobs not yet taken by any worker.
+    _Alignas(AUDIT_CACHE_LINE) size_t remaining;
+} audit_pool_t;
+
+static audit_pool_t audit_pool;
+
+// Take a batch of blobs from the front of a queue.
+static bool audit_take(audit_queue_t* queue, size_t* begin_out, size_t* end_out) {
+    pthread_mutex_lock(&queue->lock);
+    bool ok = queue->begin < queue->end;
+    if (ok) {
+        *begin_out    = queue->begin;
+        queue->begin += queue->end - queue->begin < AUDIT_BATCH ? queue->end - queue->begin : AUDIT_BATCH;
+        *end_out      = queue->begin;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    if (ok) {
+        __atomic_fetch_sub(&audit_pool.remaining, *end_out - *begin_out, __ATOMIC_RELEASE);
+    }
+    return ok;
+}
+
+// Steal the back half of another worker's queue into an empty queue.
+static bool audit_steal(audit_worker_t* thief) {
+    size_t n = audit_pool.workers_len;
+    for (size_t i = 1; i < n; i++) {
+        audit_worker_t* victim = &audit_pool.workers[(thief->id + i) % n];
+        // Both queues are locked while the range moves, so that it is always in one of them.
+        // They are locked in order of worker ID, so that two thieves stealing from each other cannot deadlock.
+        audit_queue_t*  first  = victim->id < thief->id ? &victim->queue : &thief->queue;
+        audit_queue_t*  second = victim->id < thief->id ? &thief->queue : &victim->queue;
+        pthread_mutex_lock(&first->lock);
+        pthread_mutex_lock(&second->lock);
+        size_t left = victim->queue.end - victim->queue.begin;
+        if (left) {
+            size_t mid         = victim->queue.end - (left + 1) / 2;
+            thief->queue.begin = mid;
+            thief->queue.end   = victim->queue.end;
+            victim->queue.end  = mid;
+        }
+        pthread_mutex_unlock(&second->lock);
+        pthread_mutex_unlock(&first->lock);
+        if (left) {
+            thief->steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Worker thread: audit blobs from its own queue, then steal from others until there is no work left.
+static void* audit_worker(void* arg) {
+    audit_worker_t* worker = arg;
+    while (true) {
+        size_t begin, end;
+        while (audit_take(&worker->queue, &begin, &end)) {
+            for (size_t i = begin; i < end; i++) {
+                const audit_blob_t* blob = &audit_pool.blobs[i];
+                audit_blob(&worker->stats, audit_pool.data + blob->offset, blob->len, i);
+            }
+        }
+        // A scan of the queues can miss a range that another thief moves past it, so only stop once every blob has
+        // been taken.
+        if (!audit_steal(worker)) {
+            if (!__atomic_load_n(&audit_pool.remaining, __ATOMIC_ACQUIRE)) {
+                return NULL;
+            }
+            sched_yield();
+        }
+    }
+}
+
+
+
+/* ==== Corpus generation ==== */
+
+// Write a synthetic corpus of `count` blobs, some of them corrupted, for testing and benchmarking.
+static int audit_generate(const char* path, size_t count) {
+    FILE* fd = fopen(path, "wb");
+    if (!fd) {
+        perror(path);
+        return 1;
+    }
+    uint32_t seed = 0x12345678;
+    for (size_t i = 0; i < count; i++) {
+        char uri[64], text[64];
+        snprintf(uri, sizeof(uri), "https://tags.example.com/t/%zu", i);
+        snprintf(text, sizeof(text), "Tag %zu", i);
+        ndef_decd_record_t records[] = {
+            {.type = NDEF_DECD_TYPE_URI, .data.uri = ndef_uri_format_cstr(uri)},
+            {.type = NDEF_DECD_TYPE_TEXT, .data.text = {.lang = "en", .lang_len = 2, .text = text, .text_len = strlen(text)}},
+            {.type             = NDEF_DECD_TYPE_SMART_POSTER,
+             .data.smartposter = {.uri = uri, .uri_len = strlen(uri), .title = text, .title_len = strlen(text)}},
+            {.type      = NDEF_DECD_TYPE_WIFI,
+             .data.wifi = {.ssid = "badge", .ssid_len = 5, .auth = NDEF_WIFI_AUTH_OPEN, .encr = NDEF_WIFI_ENCR_NONE}},
+        };
+        ndef_ostream_t ostream = NDEF_OSTREAM_NEW();
+        size_t         first   = i % 4;
+        size_t         num     = 1 + i % 3 < 4 - first ? 1 + i % 3 : 4 - first;
+        if (!ndef_message_write(&ostream, records + first, num)) {
+            fprintf(stderr, "Failed to encode blob %zu\n", i);
+            fclose(fd);
+            return 1;
+        }
+        // Corrupt one in a hundred blobs.
+        seed = seed * 1103515245 + 12345;
+        if ((seed >> 16) % 100 == 0) {
+            ostream.data[(seed >> 8) % ostream.len] ^= 1 << (seed % 8);
+        }
+        uint8_t len_bytes[4] = {ostream.len >> 24, ostream.len >> 16, ostream.len >> 8, ostream.len};
+        fwrite(len_bytes, 1, 4, fd);
+        fwrite(ostream.data, 1, ostream.len, fd);
+        ndef_ostream_free(&ostream);
+    }
+    return fclose(fd) ? 1 : 0;
+}
+
+
+
+/* ==== Main ==== */
+
+static int audit_compare_errors(const void* a, const void* b) {
+    const audit_error_t* x = a;
+    const audit_error_t* y = b;
+    return (x->blob > y->blob) - (x->blob < y->blob);
+}
+
+static void audit_usage(const char* argv0) {
+    fprintf(stderr, "Usage: %s [-j THREADS] [--max-errors N] CORPUS\n", argv0);
+    fprintf(stderr, "       %s --generate COUNT CORPUS\n", argv0);
+}
+
+int main(int argc, char** argv) {
+    long        threads    = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t      max_errors = 20;
+    size_t      generate   = 0;
+    const char* path       = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+            threads = atol(argv[++i]);
+        } else if (!strcmp(argv[i], "--max-errors") && i + 1 < argc) {
+            max_errors = strtoull(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--generate") && i + 1 < argc) {
+            generate = strtoull(argv[++i], NULL, 0);
+        } else if (!path && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            audit_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!path || threads < 1) {
+        audit_usage(argv[0]);
+        return 1;
+    }
+    if (generate) {
+        return audit_generate(path, generate);
+    }
+
+    // Map the corpus.
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return 1;
+    }
+    struct stat st;
+    if (fstat(fd, &st)) {
+        perror(path);
+        close(fd);
+        return 1;
+    }
+    size_t         len  = st.st_size;
+    const uint8_t* data = NULL;
+    if (len) {
+        data = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            perror(path);
+            close(fd);
+            return 1;
+        }
+        madvise((void*)data, len, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    audit_blob_t* blobs;
+    size_t        blobs_len;
+    bool          complete = audit_index(data, len, &blobs, &blobs_len);
+    if (!blobs) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    if (!complete) {
+        fprintf(stderr, "Warning: corpus is truncated after blob %zu\n", blobs_len);
+    }
+
+    // Hand each worker an equal share of the blobs up front; stealing evens out the rest.
+    audit_worker_t* workers = aligned_alloc(AUDIT_CACHE_LINE, threads * sizeof(audit_worker_t));
+    if (!workers) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    audit_pool = (audit_pool_t){data, blobs, workers, threads, blobs_len};
+    for (long i = 0; i < threads; i++) {
+        memset(&workers[i], 0, sizeof(audit_worker_t));
+        pthread_mutex_init(&workers[i].queue.lock, NULL);
+        workers[i].id          = i;
+        workers[i].queue.begin = blobs_len * i / threads;
+        workers[i].queue.end   = blobs_len * (i + 1) / threads;
+    }
+    for (long i = 1; i < threads; i++) {
+        if (pthread_create(&workers[i].thread, NULL, audit_worker, &workers[i])) {
+            fprintf(stderr, "Failed to start worker %ld\n", i);
+            return 1;
+        }
+    }
+    audit_worker(&workers[0]);
+    for (long i = 1; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    // Merge the results.
+    audit_stats_t* total = calloc(1, sizeof(audit_stats_t));
+    audit_error_t* errors = malloc(threads * AUDIT_MAX_ERRORS * sizeof(audit_error_t));
+    size_t         errors_len = 0;
+    size_t         steals     = 0;
+    if (!total || !errors) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (long i = 0; i < threads; i++) {
+        audit_stats_t* stats  = &workers[i].stats;
+        total->blobs         += stats->blobs;
+        total->blobs_ok      += stats->blobs_ok;
+        total->bytes         += stats->bytes;
+        total->records       += stats->records;
+        for (size_t j = 0; j < AUDIT_NUM_KINDS; j++) {
+            total->kinds[j]      += stats->kinds[j];
+            total->kind_bytes[j] += stats->kind_bytes[j];
+        }
+        for (size_t j = 0; j < 8; j++) {
+            total->tnfs[j] += stats->tnfs[j];
+        }
+        for (size_t j = 0; j < AUDIT_NUM_ERR; j++) {
+            total->errs[j] += stats->errs[j];
+        }
+        memcpy(errors + errors_len, stats->errors, stats->errors_len * sizeof(audit_error_t));
+        errors_len += stats->errors_len;
+        steals     += workers[i].steals;
+        pthread_mutex_destroy(&workers[i].queue.lock);
+    }
+    qsort(errors, errors_len, sizeof(audit_error_t), audit_compare_errors);
+
+    printf("blobs:    %zu (%zu ok, %zu failed)\n", total->blobs, total->blobs_ok, total->blobs - total->blobs_ok);
+    printf("records:  %zu\n", total->records);
+    printf("bytes:    %zu\n", total->bytes);
+    printf("threads:  %ld (%zu steals)\n", threads, steals);
+    printf("time:     %.3f s (%.1f MB/s, %.0f blobs/s)\n", secs, total->bytes / secs / 1e6, total->blobs / secs);
+    printf("\nrecord types:\n");
+    for (size_t i = 0; i < AUDIT_NUM_KINDS; i++) {
+        printf("  %-16s %12zu records %14zu bytes\n", audit_kind_names[i], total->kinds[i], total->kind_bytes[i]);
+    }
+    printf("\ntnf:\n");
+    for (size_t i = 0; i < 8; i++) {
+        if (total->tnfs[i]) {
+            printf("  %-16zu %12zu records\n", i, total->tnfs[i]);
+        }
+    }
+    printf("\nerrors:\n");
+    for (size_t i = 0; i < AUDIT_NUM_ERR; i++) {
+        printf("  %-20s %12zu\n", audit_err_names[i], total->errs[i]);
+    }
+    for (size_t i = 0; i < errors_len && i < max_errors; i++) {
+        const audit_error_t* error = &errors[i];
+        if (error->err == AUDIT_ERR_PAYLOAD) {
+            printf("  blob %zu at offset %zu: %s (%s)\n", error->blob, error->offset, audit_err_names[error->err],
+                   audit_kind_names[error->kind]);
+        } else {
+            printf("  blob %zu at offset %zu: %s\n", error->blob, error->offset, audit_err_names[error->err]);
+        }
+    }
+
+    int status = total->blobs_ok == total->blobs && complete ? 0 : 2;
+    free(total);
+    free(errors);
+    free(workers);
+    free(blobs);
+    if (len) {
+        munmap((void*)data, len);
+    }
+    return status;
+}